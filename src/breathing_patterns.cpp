@@ -1,3 +1,4 @@
+#include "led_kernels.h"
 #include "patterns.h"
 
 void runBreathingPattern(ChasePattern* pattern)
@@ -9,19 +10,24 @@ void runBreathingPattern(ChasePattern* pattern)
     float max_bright = pattern->params.breathing.max_brightness;
     float color_cycle_speed = pattern->params.breathing.color_cycle_speed;
 
+#if !HIGH_PRECISION_RENDER
     // Convert brightness range to 0-255 scale
     uint8_t min_brightness = (uint8_t)(min_bright * 255);
     uint8_t max_brightness = (uint8_t)(max_bright * 255);
 
     // Use FastLED's beatsin8 for smooth breathing effect with custom range
-    uint8_t breath = beatsin8(pattern->speed / 4, min_brightness, max_brightness);
+    uint8_t breath = frameBeatsin8(pattern->speed / 4, min_brightness, max_brightness);
+#else
+    // The low end of the breath is where 8-bit levels step visibly, so breathe in 16 bits
+    uint16_t breath = frameBeatsin16(pattern->speed / 4, (uint16_t)(min_bright * 65535), (uint16_t)(max_bright * 65535));
+#endif
 
     // Continuously interpolate through palette colors with configurable speed
     CRGB base_color = CRGB::White;
     if (pattern->palette_size > 0) {
         // Get continuous position in palette (0-255 range) with custom speed
         uint8_t color_speed = (uint8_t)(pattern->speed * color_cycle_speed / 4);
-        uint8_t palette_position = beatsin8(color_speed, 0, 255);
+        uint8_t palette_position = frameBeatsin8(color_speed, 0, 255);
         // Scale to palette range for smooth interpolation
         uint8_t scaled_position = map8(palette_position, 0, (pattern->palette_size - 1) * 255 / pattern->palette_size);
 
@@ -36,28 +42,32 @@ void runBreathingPattern(ChasePattern* pattern)
         base_color = blend(pattern->palette[index1], pattern->palette[index2], blend_amount);
     }
 
-    // Apply breathing pattern to all target strips
-    for (uint8_t i = 0; i < pattern->num_target_strips; i++) {
-        uint8_t strip_id = pattern->target_strips[i];
-        if (strip_id >= 22)
-            continue;
+    // Every strip gets the same color, so apply the breathing brightness once and fill them all
+#if !HIGH_PRECISION_RENDER
+    CRGB breath_color = base_color;
+    breath_color.fadeToBlackBy(255 - breath);
+    fillStripsWithColor(pattern, breath_color);
+#else
+    fillStripsWithColor16(pattern, scaleColor16(base_color, breath));
+#endif
 
-        // Skip strips that are currently active in FlashBulb patterns
-        if (isStripActiveInFlashBulb(strip_id)) {
-            continue;
-        }
+    // Apply transition blending if transitioning
+    if (pattern->is_transitioning) {
+        unsigned long transition_elapsed = current_time - pattern->transition_start_time;
+        if (transition_elapsed < pattern->transition_duration) {
+            for (uint8_t i = 0; i < pattern->num_target_strips; i++) {
+                int8_t strip_id = getLocalStrip(pattern->target_strips[i]);
+                if (strip_id < 0)
+                    continue;
 
-        CRGBSet strip_set = getStripSet(strip_id);
-        uint16_t strip_length = getStripLength(strip_id);
+                // Skip strips that are currently active in FlashBulb patterns
+                if (isStripActiveInFlashBulb(strip_id)) {
+                    continue;
+                }
 
-        // Fill with base color and apply breathing brightness
-        strip_set.fill_solid(base_color);
-        strip_set.fadeToBlackBy(255 - breath);
+                CRGBSet strip_set = getStripSet(strip_id);
+                uint16_t strip_length = getStripLength(strip_id);
 
-        // Apply transition blending if transitioning
-        if (pattern->is_transitioning) {
-            unsigned long transition_elapsed = current_time - pattern->transition_start_time;
-            if (transition_elapsed < pattern->transition_duration) {
                 if (!pattern->is_active) {
                     // Transitioning in
                     uint8_t transition_blend = (transition_elapsed * 255) / pattern->transition_duration;
@@ -68,9 +78,9 @@ void runBreathingPattern(ChasePattern* pattern)
                 } else {
                     // Transitioning out
                     uint8_t fade_amount = (transition_elapsed * 255) / pattern->transition_duration;
-                    strip_set.fadeToBlackBy(fade_amount);
+                    fadeLEDsToBlackBy(strip_set, strip_set.size(), fade_amount);
                 }
             }
         }
     }
-}
\ No newline at end of file
+}
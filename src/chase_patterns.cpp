@@ -1,5 +1,133 @@
 #include "patterns.h"
 
+#define STRIP_OFFSET 10 // Internal offset between strips for better visual separation
+#define MAX_SHIFT_RUNS (2 * MAX_TARGET_STRIPS + 1) // Alternating strip/gap sources one strip can span
+
+// Color of the chase at a position on the global LED line (the pattern's strips across the whole
+// installation laid end to end with STRIP_OFFSET gaps, skipping invalid strip IDs)
+static CRGB chaseColorAt(ChasePattern* pattern, uint16_t global_led_position)
+{
+    // Calculate palette index based on position in the chase with strip offset
+    uint8_t palette_index = ((global_led_position + pattern->chase_position) * 255) / (pattern->palette_size * 10);
+
+    // Use FastLED's ColorFromPalette for smooth color transitions
+    return ColorFromPalette(pattern->fastled_palette, palette_index, 255, LINEARBLEND);
+}
+
+struct ChaseShiftRun {
+    uint16_t led; // First logical LED of the run in the destination strip
+    uint16_t length;
+    int8_t source_index; // Index into the line's strips, -1 = newly exposed pixels
+    uint16_t source_led;
+};
+
+// Copy a run of logical LEDs between strips, honouring each strip's direction
+static void copyStripRun(uint8_t dest_strip, uint16_t dest_led, uint8_t source_strip, uint16_t source_led,
+    uint16_t length)
+{
+    const StripConfig& dest = strips[dest_strip];
+    const StripConfig& source = strips[source_strip];
+
+    if (dest.reverse_direction == source.reverse_direction) {
+        // Same direction keeps the run contiguous in memory; memmove handles same-strip overlap
+        uint16_t dest_offset = dest.reverse_direction ? dest.length - dest_led - length : dest_led;
+        uint16_t source_offset = source.reverse_direction ? source.length - source_led - length : source_led;
+        memmove(dest.led_array_ptr + dest.start_offset + dest_offset,
+            source.led_array_ptr + source.start_offset + source_offset, length * sizeof(CRGB));
+    } else {
+        // Opposite directions can only happen between different strips, so they never alias
+        for (uint16_t led = 0; led < length; led++) {
+            getStripLED(dest_strip, dest_led + led) = getStripLED(source_strip, source_led + led);
+        }
+    }
+}
+
+// Move the previously rendered frame along the global LED line to the current chase position.
+// Every pixel whose source is still on one of our strips is copied; only pixels that come out of
+// a STRIP_OFFSET gap, another controller's strip or off the end of the line are computed.
+static void shiftChaseFrame(ChasePattern* pattern)
+{
+    int8_t line_strips[MAX_TARGET_STRIPS]; // Local strip, or -1 for one driven elsewhere
+    uint16_t line_start[MAX_TARGET_STRIPS];
+    uint16_t line_length[MAX_TARGET_STRIPS];
+    uint8_t line_count = 0;
+    uint16_t global_led_position = 0;
+
+    for (uint8_t i = 0; i < pattern->num_target_strips; i++) {
+        uint8_t global_strip = pattern->target_strips[i];
+        if (global_strip >= INSTALLATION_STRIP_COUNT)
+            continue; // Invalid strips don't occupy space on the line
+
+        line_strips[line_count] = getLocalStrip(global_strip);
+        line_start[line_count] = global_led_position;
+        line_length[line_count] = getInstallationStripLength(global_strip);
+        global_led_position += line_length[line_count] + STRIP_OFFSET;
+        line_count++;
+    }
+
+    // New pixel at g shows what the old frame had at g + delta
+    int16_t delta = (int16_t)pattern->chase_position - (int16_t)pattern->rendered_position;
+    if (delta == 0)
+        return;
+
+    // Reading ahead (delta > 0) must walk the line forwards and reading behind must walk it
+    // backwards, so no source pixel is overwritten before it has been copied
+    for (uint8_t n = 0; n < line_count; n++) {
+        uint8_t i = delta > 0 ? n : line_count - 1 - n;
+        int8_t strip_id = line_strips[i];
+        if (strip_id < 0)
+            continue;
+        uint16_t strip_length = line_length[i];
+
+        // Split the strip into runs that either copy from one source strip or are rendered fresh
+        ChaseShiftRun runs[MAX_SHIFT_RUNS];
+        uint8_t run_count = 0;
+
+        uint16_t led = 0;
+        while (led < strip_length) {
+            ChaseShiftRun& run = runs[run_count++];
+            int32_t source = (int32_t)line_start[i] + led + delta;
+            uint16_t remaining = strip_length - led;
+
+            run.led = led;
+            run.source_index = -1;
+            run.length = remaining;
+
+            for (uint8_t k = 0; k < line_count; k++) {
+                int32_t source_start = line_start[k];
+                int32_t source_end = source_start + line_length[k];
+
+                if (source >= source_start && source < source_end) {
+                    // Source lies in strip k: copy until either strip runs out, or render when
+                    // strip k is another controller's and its pixels aren't here to copy
+                    run.source_index = line_strips[k] >= 0 ? k : -1;
+                    run.source_led = source - source_start;
+                    run.length = min((int32_t)remaining, source_end - source);
+                    break;
+                }
+                if (source < source_start) {
+                    // Source lies in the gap before strip k: render up to where strip k begins
+                    run.length = min((int32_t)remaining, source_start - source);
+                    break;
+                }
+            }
+            led += run.length;
+        }
+
+        for (uint8_t r = 0; r < run_count; r++) {
+            ChaseShiftRun& run = runs[delta > 0 ? r : run_count - 1 - r];
+
+            if (run.source_index >= 0) {
+                copyStripRun(strip_id, run.led, line_strips[run.source_index], run.source_led, run.length);
+            } else {
+                for (uint16_t fresh_led = run.led; fresh_led < run.led + run.length; fresh_led++) {
+                    getStripLED(strip_id, fresh_led) = chaseColorAt(pattern, line_start[i] + fresh_led);
+                }
+            }
+        }
+    }
+}
+
 void runChasePattern(ChasePattern* pattern)
 {
     // Update FastLED palette if pattern has changed
@@ -10,83 +138,89 @@ void runChasePattern(ChasePattern* pattern)
     if (current_time - pattern->last_update >= speed_delay) {
         pattern->last_update = current_time;
 
-        // Apply continuous chase pattern across all target strips
-        uint16_t global_led_position = 0;
-        const uint16_t STRIP_OFFSET = 10; // Internal offset between strips for better visual separation
+        // A continuous chase is the previous frame shifted along the line, so when the strips
+        // still hold that frame only the newly exposed pixels need to be computed
+        if (canRenderIncrementally(pattern)) {
+            shiftChaseFrame(pattern);
+        } else {
+            pattern->frame_valid = !pattern->is_transitioning && patternHasExclusiveStrips(pattern);
 
-        for (uint8_t i = 0; i < pattern->num_target_strips; i++) {
-            uint8_t strip_id = pattern->target_strips[i];
-            if (strip_id >= 22)
-                continue; // Invalid strip ID
+            // Apply continuous chase pattern across all target strips
+            uint16_t global_led_position = 0;
 
-            // Skip strips that are currently active in FlashBulb patterns
-            if (isStripActiveInFlashBulb(strip_id)) {
-                // Still need to advance global_led_position for proper chase continuity
-                global_led_position += strips[strip_id].length + STRIP_OFFSET;
-                continue;
-            }
+            for (uint8_t i = 0; i < pattern->num_target_strips; i++) {
+                uint8_t global_strip = pattern->target_strips[i];
+                if (global_strip >= INSTALLATION_STRIP_COUNT)
+                    continue; // Invalid strip ID
 
-            CRGBSet strip_set = getStripSet(strip_id);
-            uint16_t strip_length = getStripLength(strip_id);
-
-            // Apply chase pattern using FastLED's ColorFromPalette for smooth blending
-            for (uint16_t led = 0; led < strip_length; led++) {
-                // Calculate palette index based on position in the chase with strip offset
-                uint8_t palette_index
-                    = ((global_led_position + pattern->chase_position) * 255) / (pattern->palette_size * 10);
-
-                // Use FastLED's ColorFromPalette for smooth color transitions
-                CRGB blended_color = ColorFromPalette(pattern->fastled_palette, palette_index, 255, LINEARBLEND);
-
-                // Apply transition blending only if this strip is actually being changed
-                if (pattern->is_transitioning) {
-                    // Check if there's an active pattern on this strip that's different from current pattern
-                    bool strip_has_transition = false;
-
-                    // Check if this strip is shared with other active patterns
-                    for (uint8_t p = 0; p < pattern_queue.queue_size; p++) {
-                        ChasePattern& other_pattern = pattern_queue.patterns[p];
-                        if (&other_pattern != pattern && (other_pattern.is_active || other_pattern.is_transitioning)) {
-                            // Check if this strip is in the other pattern
-                            for (uint8_t s = 0; s < other_pattern.num_target_strips; s++) {
-                                if (other_pattern.target_strips[s] == strip_id) {
-                                    strip_has_transition = true;
-                                    break;
+                // Skip strips that are currently active in FlashBulb patterns, and other
+                // controllers' strips
+                int8_t strip_id = getLocalStrip(global_strip);
+                if (strip_id < 0 || isStripActiveInFlashBulb(strip_id)) {
+                    // Still need to advance global_led_position for proper chase continuity
+                    global_led_position += getInstallationStripLength(global_strip) + STRIP_OFFSET;
+                    continue;
+                }
+
+                CRGBSet strip_set = getStripSet(strip_id);
+                uint16_t strip_length = getStripLength(strip_id);
+
+                // Apply chase pattern using FastLED's ColorFromPalette for smooth blending
+                for (uint16_t led = 0; led < strip_length; led++) {
+                    CRGB blended_color = chaseColorAt(pattern, global_led_position);
+
+                    // Apply transition blending only if this strip is actually being changed
+                    if (pattern->is_transitioning) {
+                        // Check if there's an active pattern on this strip that's different from current pattern
+                        bool strip_has_transition = false;
+
+                        // Check if this strip is shared with other active patterns
+                        for (uint8_t p = 0; p < pattern_queue.queue_size; p++) {
+                            ChasePattern& other_pattern = pattern_queue.patterns[p];
+                            if (&other_pattern != pattern && (other_pattern.is_active || other_pattern.is_transitioning)) {
+                                // Check if this strip is in the other pattern
+                                for (uint8_t s = 0; s < other_pattern.num_target_strips; s++) {
+                                    if (other_pattern.target_strips[s] == global_strip) {
+                                        strip_has_transition = true;
+                                        break;
+                                    }
                                 }
                             }
+                            if (strip_has_transition)
+                                break;
                         }
-                        if (strip_has_transition)
-                            break;
-                    }
 
-                    if (strip_has_transition || !pattern->is_active) {
-                        unsigned long transition_elapsed = current_time - pattern->transition_start_time;
-
-                        if (transition_elapsed < pattern->transition_duration) {
-                            if (pattern->is_active) {
-                                // Transitioning out (fade out) - use FastLED's fadeToBlackBy
-                                uint8_t fade_amount = (transition_elapsed * 255) / pattern->transition_duration;
-                                blended_color.fadeToBlackBy(fade_amount);
-                            } else {
-                                // Transitioning in (fade in) - use FastLED's lerp8
-                                uint8_t transition_blend = (transition_elapsed * 255) / pattern->transition_duration;
-                                CRGB existing_color = getStripLED(strip_id, led);
-                                blended_color = existing_color.lerp8(blended_color, transition_blend);
+                        if (strip_has_transition || !pattern->is_active) {
+                            unsigned long transition_elapsed = current_time - pattern->transition_start_time;
+
+                            if (transition_elapsed < pattern->transition_duration) {
+                                if (pattern->is_active) {
+                                    // Transitioning out (fade out) - use FastLED's fadeToBlackBy
+                                    uint8_t fade_amount = (transition_elapsed * 255) / pattern->transition_duration;
+                                    blended_color.fadeToBlackBy(fade_amount);
+                                } else {
+                                    // Transitioning in (fade in) - use FastLED's lerp8
+                                    uint8_t transition_blend = (transition_elapsed * 255) / pattern->transition_duration;
+                                    CRGB existing_color = getStripLED(strip_id, led);
+                                    blended_color = existing_color.lerp8(blended_color, transition_blend);
+                                }
                             }
                         }
                     }
+
+                    getStripLED(strip_id, led) = blended_color;
+                    global_led_position++;
                 }
 
-                getStripLED(strip_id, led) = blended_color;
-                global_led_position++;
+                // Add strip offset for better visual separation between strips
+                global_led_position += STRIP_OFFSET;
             }
-
-            // Add strip offset for better visual separation between strips
-            global_led_position += STRIP_OFFSET;
         }
 
+        pattern->rendered_position = pattern->chase_position;
+
         // Advance chase position - advance more positions for higher speeds to match rainbow pattern timing
         uint8_t advance_step = (pattern->speed / 10) + 1; // Speed 1-10 = 1 step, 11-20 = 2 steps, etc.
         pattern->chase_position = (pattern->chase_position + advance_step) % (pattern->palette_size * 10);
     }
-}
\ No newline at end of file
+}
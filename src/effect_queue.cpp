@@ -0,0 +1,136 @@
+#include "effect_queue.h"
+#include "logger.h"
+#include "patterns.h"
+
+// Strips waiting for a FlashBulb, and ripple origin strips, per envelope
+static uint32_t pending_flashbulbs[MAX_FLASHBULB_ENVELOPES];
+static uint64_t pending_ripples[MAX_FLASHBULB_ENVELOPES]; // Global origin strips
+static uint32_t pending_events = 0;
+
+// Latency traces of the sensor messages behind the pending effects
+static LatencyTrace pending_traces[LATENCY_MAX_PENDING];
+static uint8_t pending_trace_count = 0;
+
+static EffectQueueStats effect_stats;
+
+// Token bucket in thousandths of a token, refilled at EFFECT_RATE_LIMIT tokens per second. Runs on
+// the frame clock so a replayed recording accepts and drops the same events
+static int32_t rate_tokens = EFFECT_RATE_BURST * 1000;
+static unsigned long rate_refill_time = 0;
+
+void resetEffectQueue()
+{
+    for (uint8_t i = 0; i < MAX_FLASHBULB_ENVELOPES; i++) {
+        pending_flashbulbs[i] = 0;
+        pending_ripples[i] = 0;
+    }
+    pending_events = 0;
+    pending_trace_count = 0;
+    effect_stats = EffectQueueStats();
+    rate_tokens = EFFECT_RATE_BURST * 1000;
+    rate_refill_time = current_time;
+}
+
+static bool takeEffectToken()
+{
+    // Any gap long enough to refill the bucket (or the show clock stepping back) leaves it full
+    unsigned long elapsed = current_time - rate_refill_time;
+    rate_refill_time = current_time;
+    if (elapsed >= EFFECT_RATE_BURST * 1000UL / EFFECT_RATE_LIMIT) {
+        rate_tokens = EFFECT_RATE_BURST * 1000;
+    } else {
+        rate_tokens = min(rate_tokens + (int32_t)(elapsed * EFFECT_RATE_LIMIT), (int32_t)(EFFECT_RATE_BURST * 1000));
+    }
+
+    if (rate_tokens < 1000) {
+        effect_stats.dropped++;
+        return false;
+    }
+    rate_tokens -= 1000;
+    return true;
+}
+
+bool queueFlashBulb(uint32_t strip_mask, uint8_t envelope_index)
+{
+    if (strip_mask == 0 || !takeEffectToken())
+        return false;
+
+    pending_flashbulbs[envelope_index < MAX_FLASHBULB_ENVELOPES ? envelope_index : 0] |= strip_mask;
+    pending_events++;
+    effect_stats.queued++;
+    return true;
+}
+
+bool queueRipple(uint8_t origin_strip, uint8_t envelope_index)
+{
+    if (origin_strip >= INSTALLATION_STRIP_COUNT || !takeEffectToken())
+        return false;
+
+    pending_ripples[envelope_index < MAX_FLASHBULB_ENVELOPES ? envelope_index : 0] |= 1ULL << origin_strip;
+    pending_events++;
+    effect_stats.queued++;
+    return true;
+}
+
+void queueLatencyTrace(const LatencyTrace& trace)
+{
+    if (pending_trace_count >= LATENCY_MAX_PENDING) {
+        LOG_WARN("Latency: too many queued traces, dropping one");
+        return;
+    }
+    pending_traces[pending_trace_count++] = trace;
+}
+
+// Start everything queued since the last frame. Runs once per frame, before the FlashBulbs update.
+// Traces are started here too, so receive_to_start covers the wait for the frame
+void applyQueuedEffects()
+{
+    if (pending_events == 0 && pending_trace_count == 0)
+        return;
+
+    uint32_t activations = 0;
+    for (uint8_t envelope_index = 0; envelope_index < MAX_FLASHBULB_ENVELOPES; envelope_index++) {
+        uint32_t strip_mask = pending_flashbulbs[envelope_index];
+        if (strip_mask != 0) {
+            uint8_t strip_ids[LOCAL_STRIP_COUNT];
+            uint8_t num_strips = 0;
+            for (uint8_t strip = 0; strip < LOCAL_STRIP_COUNT; strip++) {
+                if (strip_mask & (1UL << strip))
+                    strip_ids[num_strips++] = strip;
+            }
+            triggerFlashBulb(addFlashBulbPattern(strip_ids, num_strips, envelope_index));
+            activations++;
+        }
+
+        uint64_t origins = pending_ripples[envelope_index];
+        if (origins != 0) {
+            uint8_t envelope = envelope_index < flashbulb_manager.envelope_count ? envelope_index : 0;
+            for (uint8_t strip = 0; strip < INSTALLATION_STRIP_COUNT; strip++) {
+                if (origins & (1ULL << strip)) {
+                    launchRipple(strip, getInstallationStripLength(strip) / 2, flashbulb_manager.envelopes[envelope].config.flash_color);
+                    activations++;
+                }
+            }
+        }
+
+        pending_flashbulbs[envelope_index] = 0;
+        pending_ripples[envelope_index] = 0;
+    }
+
+    if (pending_events > activations) {
+        LOG_DEBUG("Effects: %lu events coalesced into %lu", (unsigned long)pending_events, (unsigned long)activations);
+    }
+    effect_stats.coalesced += pending_events - activations;
+    effect_stats.activations += activations;
+    pending_events = 0;
+
+    for (uint8_t i = 0; i < pending_trace_count; i++) {
+        startLatencyTrace(pending_traces[i]);
+    }
+    pending_trace_count = 0;
+}
+
+void getEffectQueueStats(EffectQueueStats& stats)
+{
+    stats = effect_stats;
+}
@@ -0,0 +1,29 @@
+#ifndef EFFECT_QUEUE_H
+#define EFFECT_QUEUE_H
+
+#include "latency_trace.h"
+#include <stdint.h>
+
+// Sensor effects wait here until the next frame, where everything queued since the last one is
+// merged: one FlashBulb per envelope across the union of the strips asked for, and one ripple per
+// origin strip and envelope. However many sensors fire together, a frame starts a bounded number
+// of effects and is still shown once. A token bucket caps how many events are accepted overall;
+// each sensor's own cooldown is its per-sensor limit.
+#define EFFECT_RATE_LIMIT 10 // Sensor events accepted per second once the burst allowance is spent
+#define EFFECT_RATE_BURST 22 // Events accepted back to back, enough for every strip at once
+
+struct EffectQueueStats {
+    uint32_t queued; // Events accepted into the queue
+    uint32_t coalesced; // Events merged into an effect another event in the same frame started
+    uint32_t dropped; // Events refused by the global rate limit
+    uint32_t activations; // FlashBulbs and ripples actually started
+};
+
+void resetEffectQueue();
+bool queueFlashBulb(uint32_t strip_mask, uint8_t envelope_index); // Bit n set = local strip n
+bool queueRipple(uint8_t origin_strip, uint8_t envelope_index); // Global strip id
+void queueLatencyTrace(const LatencyTrace& trace); // Started when the queued effects are applied
+void applyQueuedEffects();
+void getEffectQueueStats(EffectQueueStats& stats);
+
+#endif
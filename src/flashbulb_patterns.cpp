@@ -1,6 +1,34 @@
+#include "led_kernels.h"
+#include "logger.h"
 #include "patterns.h"
 
-FlashBulbManager flashbulb_manager = { .pattern_count = 0 };
+FlashBulbManager flashbulb_manager = { .pattern_count = 0, .envelope_count = 0 };
+
+// Classic flashbulb: instant white, 100ms hold, 5 second fade to black, 2 second transition back
+static const EnvelopeConfig default_envelope = {
+    { { 0, CURVE_LINEAR }, { 100, CURVE_LINEAR }, { 5000, CURVE_LINEAR }, { 2000, CURVE_LINEAR } }, CRGB::White
+};
+
+static const char* const envelope_phase_names[ENVELOPE_PHASE_COUNT] = { "attack", "hold", "decay", "recover" };
+
+// Map a linear brightness level (0-255) through the phase's curve
+static float applyEnvelopeCurve(EnvelopeCurve curve, float level)
+{
+    float shaped = level;
+    switch (curve) {
+    case CURVE_EXPONENTIAL:
+        // 2^(8 * level / 255) - 1 spans 0-255 with equal ratios between equal steps
+        shaped = powf(2.0f, level * 8.0f / 255.0f) - 1.0f;
+        break;
+    case CURVE_GAMMA:
+        shaped = 255.0f * powf(level / 255.0f, 2.2f);
+        break;
+    case CURVE_LINEAR:
+    default:
+        break;
+    }
+    return shaped;
+}
 
 void initFlashBulbManager()
 {
@@ -8,66 +36,83 @@ void initFlashBulbManager()
     for (uint8_t i = 0; i < MAX_FLASHBULB_PATTERNS; i++) {
         flashbulb_manager.patterns[i].state = FLASHBULB_INACTIVE;
         flashbulb_manager.patterns[i].num_target_strips = 0;
-        flashbulb_manager.patterns[i].saved_color_count = 0;
+        flashbulb_manager.patterns[i].envelope_index = 0;
     }
+
+    // Envelope 0 is always the classic flashbulb
+    flashbulb_manager.envelope_count = 0;
+    addFlashBulbEnvelope(default_envelope);
 }
 
-void addFlashBulbPattern(uint8_t* target_strips, uint8_t num_target_strips)
+uint8_t addFlashBulbEnvelope(const EnvelopeConfig& config)
 {
-    if (flashbulb_manager.pattern_count >= MAX_FLASHBULB_PATTERNS)
-        return;
+    if (flashbulb_manager.envelope_count >= MAX_FLASHBULB_ENVELOPES)
+        return 0; // Fall back to the default envelope
+
+    FlashBulbEnvelope& envelope = flashbulb_manager.envelopes[flashbulb_manager.envelope_count];
+    envelope.config = config;
+
+    // Each phase moves between a fixed start and end level; the curve shapes the levels in between
+    const uint8_t start_levels[ENVELOPE_PHASE_COUNT] = { 0, 255, 255, 0 };
+    const uint8_t end_levels[ENVELOPE_PHASE_COUNT] = { 255, 255, 0, 255 };
+
+    for (uint8_t phase = 0; phase < ENVELOPE_PHASE_COUNT; phase++) {
+        for (uint16_t progress = 0; progress < ENVELOPE_TABLE_SIZE; progress++) {
+            float level = start_levels[phase] + ((int16_t)end_levels[phase] - start_levels[phase]) * progress / 255.0f;
+            float shaped = applyEnvelopeCurve(config.phases[phase].curve, level);
+            envelope.levels[phase][progress] = (uint8_t)(shaped + 0.5f);
+#if HIGH_PRECISION_RENDER
+            envelope.fine_levels[phase][progress] = (uint16_t)(shaped * 257.0f + 0.5f);
+#endif
+        }
+    }
 
-    FlashBulbPattern& pattern = flashbulb_manager.patterns[flashbulb_manager.pattern_count];
+    return flashbulb_manager.envelope_count++;
+}
+
+// Set up a FlashBulb on the given strips and return its index. Reuses a finished pattern's slot,
+// or the one that started earliest when every slot is still running
+uint8_t addFlashBulbPattern(uint8_t* target_strips, uint8_t num_target_strips, uint8_t envelope_index)
+{
+    uint8_t index = 0;
+    unsigned long oldest_age = 0;
+    for (uint8_t i = 0; i < MAX_FLASHBULB_PATTERNS; i++) {
+        if (i >= flashbulb_manager.pattern_count || flashbulb_manager.patterns[i].state == FLASHBULB_INACTIVE) {
+            index = i;
+            break;
+        }
+        unsigned long age = current_time - flashbulb_manager.patterns[i].start_time;
+        if (age >= oldest_age) {
+            oldest_age = age;
+            index = i;
+        }
+    }
+    if (index >= flashbulb_manager.pattern_count)
+        flashbulb_manager.pattern_count = index + 1;
+
+    FlashBulbPattern& pattern = flashbulb_manager.patterns[index];
 
     // Copy target strips
     for (uint8_t i = 0; i < num_target_strips && i < MAX_TARGET_STRIPS; i++) {
         pattern.target_strips[i] = target_strips[i];
     }
-    pattern.num_target_strips = num_target_strips;
+    pattern.num_target_strips = min(num_target_strips, (uint8_t)MAX_TARGET_STRIPS);
+    pattern.envelope_index = envelope_index < flashbulb_manager.envelope_count ? envelope_index : 0;
     pattern.state = FLASHBULB_INACTIVE;
-    pattern.saved_color_count = 0;
 
-    flashbulb_manager.pattern_count++;
+    return index;
 }
 
+// Start the envelope. The flash is drawn by the next updateFlashBulbPatterns() and goes out with
+// that frame's show, so a trigger never costs a show of its own
 void triggerFlashBulb(uint8_t pattern_index)
 {
     if (pattern_index >= flashbulb_manager.pattern_count)
         return;
 
     FlashBulbPattern& pattern = flashbulb_manager.patterns[pattern_index];
-
-    // Save current colors for transition back
-    pattern.saved_color_count = 0;
-    for (uint8_t i = 0; i < pattern.num_target_strips; i++) {
-        uint8_t strip_id = pattern.target_strips[i];
-        if (strip_id >= 22)
-            continue;
-
-        // Save current colors using FastLED sets
-        CRGBSet strip_set = getStripSet(strip_id);
-        uint16_t strip_length = getStripLength(strip_id);
-        for (uint16_t led = 0; led < strip_length && pattern.saved_color_count < (MAX_TARGET_STRIPS * 122); led++) {
-            pattern.saved_colors[pattern.saved_color_count] = getStripLED(strip_id, led);
-            pattern.saved_color_count++;
-        }
-    }
-
-    // Set all target LEDs to white immediately using FastLED's fill_solid
-    for (uint8_t i = 0; i < pattern.num_target_strips; i++) {
-        uint8_t strip_id = pattern.target_strips[i];
-        if (strip_id >= 22)
-            continue;
-
-        CRGBSet strip_set = getStripSet(strip_id);
-        strip_set.fill_solid(CRGB::White);
-    }
-
-    // Start the flash sequence
-    pattern.state = FLASHBULB_FLASH;
+    pattern.state = FLASHBULB_ATTACK;
     pattern.start_time = current_time;
-
-    FastLED.show();
 }
 
 void updateFlashBulbPatterns()
@@ -83,113 +128,77 @@ void updateFlashBulbPatterns()
 
 void runFlashBulbPattern(FlashBulbPattern* pattern)
 {
-    unsigned long elapsed = current_time - pattern->start_time;
-
-    switch (pattern->state) {
-    case FLASHBULB_FLASH:
-        if (elapsed < 100) { // Hold white flash for 100ms
-            // Keep LEDs white during flash period using FastLED's fill_solid
-            for (uint8_t i = 0; i < pattern->num_target_strips; i++) {
-                uint8_t strip_id = pattern->target_strips[i];
-                if (strip_id >= 22)
-                    continue;
-
-                CRGBSet strip_set = getStripSet(strip_id);
-                strip_set.fill_solid(CRGB::White);
-            }
-        } else {
-            // Flash period complete, start fade to black
-            pattern->state = FLASHBULB_FADE_TO_BLACK;
-            pattern->start_time = current_time;
-            Serial.println("FlashBulb: Starting fade to black phase");
-        }
-        break;
-
-    case FLASHBULB_FADE_TO_BLACK:
-        if (elapsed < 5000) { // 5 second fade to black
-            uint8_t fade_amount = (elapsed * 255) / 5000;
-
-            // Apply fade to all target strips using FastLED's lerp functionality
-            for (uint8_t i = 0; i < pattern->num_target_strips; i++) {
-                uint8_t strip_id = pattern->target_strips[i];
-                if (strip_id >= 22)
-                    continue;
-
-                CRGBSet strip_set = getStripSet(strip_id);
-                
-                // Use FastLED's built-in fade function for smoother performance
-                strip_set.fill_solid(CRGB::White);
-                strip_set.fadeToBlackBy(fade_amount);
-            }
-
-            // Debug output every second
-            static unsigned long last_debug = 0;
-            if (current_time - last_debug >= 1000) {
-                last_debug = current_time;
-                Serial.print("FlashBulb fade progress: ");
-                Serial.print((elapsed * 100) / 5000);
-                Serial.println("%");
-            }
-        } else {
-            // Fade complete, start transition back
-            pattern->state = FLASHBULB_TRANSITION_BACK;
-            pattern->start_time = current_time;
-
-            // Ensure LEDs are black at the start of transition back phase
-            for (uint8_t i = 0; i < pattern->num_target_strips; i++) {
-                uint8_t strip_id = pattern->target_strips[i];
-                if (strip_id >= 22)
-                    continue;
+    if (pattern->state == FLASHBULB_INACTIVE)
+        return;
 
-                CRGBSet strip_set = getStripSet(strip_id);
-                strip_set.fill_solid(CRGB::Black);
-            }
+    const FlashBulbEnvelope& envelope = flashbulb_manager.envelopes[pattern->envelope_index];
 
-            Serial.println("FlashBulb: Starting transition back to chase pattern");
-        }
-        break;
+    // Move past every phase that has run its course (zero-length phases are skipped outright)
+    uint8_t phase = pattern->state - FLASHBULB_ATTACK;
+    unsigned long elapsed = current_time - pattern->start_time;
+    while (elapsed >= envelope.config.phases[phase].duration_ms) {
+        pattern->start_time += envelope.config.phases[phase].duration_ms;
+        elapsed -= envelope.config.phases[phase].duration_ms;
+        phase++;
 
-    case FLASHBULB_TRANSITION_BACK:
-        if (elapsed < 2000) { // 2 second transition back
-            uint8_t transition_amount = (elapsed * 255) / 2000;
-
-            // During transition back, we blend from black to whatever the chase patterns
-            // have already set (since chase patterns run BEFORE FlashBulb in the main loop)
-            for (uint8_t i = 0; i < pattern->num_target_strips; i++) {
-                uint8_t strip_id = pattern->target_strips[i];
-                if (strip_id >= 22)
-                    continue;
-
-                CRGBSet strip_set = getStripSet(strip_id);
-                
-                // Blend from black to the current chase pattern colors using FastLED
-                uint16_t strip_length = getStripLength(strip_id);
-                for (uint16_t led = 0; led < strip_length; led++) {
-                    // Get the current color that the chase pattern set
-                    CRGB current_chase_color = getStripLED(strip_id, led);
-                    
-                    // Blend from black to the current chase pattern color based on transition progress
-                    CRGB black = CRGB::Black;
-                    getStripLED(strip_id, led) = black.lerp8(current_chase_color, transition_amount);
-                }
-            }
-
-            // Debug output
-            static unsigned long last_debug2 = 0;
-            if (current_time - last_debug2 >= 500) {
-                last_debug2 = current_time;
-                Serial.print("FlashBulb transition progress: ");
-                Serial.print((elapsed * 100) / 2000);
-                Serial.println("%");
-            }
-        } else {
+        if (phase >= ENVELOPE_PHASE_COUNT) {
             // Transition complete, return to inactive
             pattern->state = FLASHBULB_INACTIVE;
-            Serial.println("FlashBulb: Effect complete, returning to normal patterns");
+            LOG_INFO("FlashBulb: Effect complete, returning to normal patterns");
+            return;
         }
-        break;
 
-    default:
-        break;
+        pattern->state = (FlashBulbState)(FLASHBULB_ATTACK + phase);
+        LOG_DEBUG("FlashBulb: Starting %s phase", envelope_phase_names[phase]);
     }
-}
\ No newline at end of file
+
+#if HIGH_PRECISION_RENDER
+    // Interpolating between table entries keeps long fades moving every frame at the low end,
+    // where one 8-bit step is a large share of the brightness
+    uint32_t fine_progress = (elapsed * 255 * 256) / envelope.config.phases[phase].duration_ms;
+    uint8_t index = fine_progress >> 8;
+    uint16_t from = envelope.fine_levels[phase][index];
+    uint16_t to = envelope.fine_levels[phase][index < ENVELOPE_TABLE_SIZE - 1 ? index + 1 : index];
+    uint16_t fine_level = from + (((int32_t)to - from) * (int32_t)(fine_progress & 0xFF)) / 256;
+
+    for (uint8_t i = 0; i < pattern->num_target_strips; i++) {
+        uint8_t strip_id = pattern->target_strips[i];
+        if (phase == ENVELOPE_RECOVER) {
+            scaleStrip16(strip_id, fine_level); // Fade the patterns back in from black
+        } else {
+            fillStrip16(strip_id, scaleColor16(envelope.config.flash_color, fine_level));
+        }
+    }
+#else
+    // One table lookup gives the brightness for every target strip this frame
+    uint8_t progress = (elapsed * 255) / envelope.config.phases[phase].duration_ms;
+    uint8_t level = envelope.levels[phase][progress];
+
+    if (phase == ENVELOPE_RECOVER) {
+        // During recovery we blend from black to whatever the chase patterns have already set
+        // (since chase patterns run BEFORE FlashBulb in the main loop). Lerping up from black is
+        // the same as scaling the pattern colors, which the bulk kernel does in place
+        for (uint8_t i = 0; i < pattern->num_target_strips; i++) {
+            uint8_t strip_id = pattern->target_strips[i];
+            if (strip_id >= LOCAL_STRIP_COUNT)
+                continue;
+
+            CRGBSet strip_set = getStripSet(strip_id);
+            scaleLEDs(strip_set, getStripLength(strip_id), level);
+        }
+    } else {
+        // Every LED shows the same flash color, so scale it once and fill with it
+        CRGB flash_color = envelope.config.flash_color;
+        flash_color.nscale8(level);
+
+        for (uint8_t i = 0; i < pattern->num_target_strips; i++) {
+            uint8_t strip_id = pattern->target_strips[i];
+            if (strip_id >= LOCAL_STRIP_COUNT)
+                continue;
+
+            CRGBSet strip_set = getStripSet(strip_id);
+            strip_set.fill_solid(flash_color);
+        }
+    }
+#endif
+}
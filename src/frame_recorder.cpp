@@ -0,0 +1,368 @@
+#include "frame_recorder.h"
+#include "frame_watchdog.h"
+#include "installation.h"
+#include "led_layout.h"
+#include "logger.h"
+#include "output_stage.h"
+#include "patterns.h"
+#include "sensor_config.h"
+#include "show_checkpoint.h"
+#include "show_runner.h"
+
+// FNV-1a over every pin's output buffer, i.e. exactly what FastLED sends out: the show after gamma,
+// white balance, dither and the power limiter
+uint32_t hashFrame()
+{
+    uint32_t hash = 2166136261u;
+    for (uint8_t pin = 0; pin < NUM_PINS; pin++) {
+        const uint8_t* bytes = (const uint8_t*)pin_configs[pin].output_array;
+        size_t length = pin_configs[pin].total_leds * sizeof(CRGB);
+        for (size_t i = 0; i < length; i++) {
+            hash = (hash ^ bytes[i]) * 16777619u;
+        }
+    }
+    return hash;
+}
+
+#define RECORD_TIME_ESCAPE 63
+#define RECORD_MAX_INPUT_SIZE sizeof(ShowCheckpoint) // The largest of input_sizes
+
+// Payload bytes of each InputType, after the type byte
+static const uint16_t input_sizes[INPUT_TYPE_COUNT] = {
+    1, // INPUT_SENSOR
+    1, // INPUT_FALLBACK
+    sizeof(OutputSettings), // INPUT_OUTPUT_SETTINGS
+    0, // INPUT_SENSOR_TABLE
+    1 + sizeof(SensorConfig), // INPUT_SENSOR_CONFIG
+    sizeof(EffectForwardPacket), // INPUT_FORWARDED_EFFECT
+    sizeof(ShowCheckpoint), // INPUT_SHOW_STATE
+};
+
+// Read the record at offset and move offset past it. Start at RECORDER_HEADER_SIZE; returns false
+// at the end of the log, or when the last record is cut short
+bool readRecord(const uint8_t* data, size_t length, size_t& offset, RecordEntry& record)
+{
+    if (offset >= length)
+        return false;
+
+    size_t next = offset;
+    uint8_t header = data[next++];
+    record.type = (RecordType)(header >> 6);
+    record.delta = header & RECORD_TIME_ESCAPE;
+    if (record.delta == RECORD_TIME_ESCAPE) {
+        record.delta = 0;
+        uint8_t shift = 0;
+        uint8_t byte;
+        do {
+            if (next >= length)
+                return false;
+            byte = data[next++];
+            record.delta |= (unsigned long)(byte & 0x7F) << shift;
+            shift += 7;
+        } while (byte & 0x80);
+    }
+
+    record.input = 0;
+    record.payload_length = record.type == RECORD_FRAME ? 4 : 0;
+    if (record.type == RECORD_INPUT) {
+        if (next >= length || data[next] >= INPUT_TYPE_COUNT)
+            return false;
+        record.input = data[next++];
+        record.payload_length = input_sizes[record.input];
+    }
+    record.payload_offset = next;
+    if (next + record.payload_length > length)
+        return false;
+    offset = next + record.payload_length;
+    return true;
+}
+
+#if FRAME_RECORDER
+
+static uint8_t recording[RECORDER_BUFFER_SIZE];
+static size_t recording_length = 0;
+static bool recording_active = false;
+static bool replay_active = false;
+static const char* stop_reason = NULL;
+static unsigned long last_record_time = 0;
+static uint32_t last_frame_hash = 0;
+static bool frame_shown = false;
+static uint32_t shown_frame_hash = 0;
+
+static void writeUint32(uint8_t* out, uint32_t value)
+{
+    for (uint8_t i = 0; i < 4; i++) {
+        out[i] = value >> (i * 8);
+    }
+}
+
+static uint32_t readUint32(const uint8_t* in)
+{
+    return in[0] | (in[1] << 8) | (in[2] << 16) | ((uint32_t)in[3] << 24);
+}
+
+// Append one record, or stop recording if it doesn't fit. A replay has to start from the
+// beginning of a session, so the log fills up and stops rather than overwriting itself.
+static void appendRecord(RecordType type, const uint8_t* payload, uint16_t payload_length)
+{
+    if (!recording_active)
+        return;
+
+    unsigned long delta = current_time - last_record_time;
+    uint8_t record[1 + (sizeof(delta) * 8 + 6) / 7]; // Header byte and the longest varint
+    uint8_t length = 0;
+
+    record[length++] = (type << 6) | (delta < RECORD_TIME_ESCAPE ? delta : RECORD_TIME_ESCAPE);
+    if (delta >= RECORD_TIME_ESCAPE) {
+        // Varint, seven bits per byte, low bits first
+        do {
+            record[length++] = (delta & 0x7F) | (delta >= 0x80 ? 0x80 : 0);
+            delta >>= 7;
+        } while (delta > 0);
+    }
+
+    if (recording_length + length + payload_length > RECORDER_BUFFER_SIZE) {
+        stopRecording("log full");
+        return;
+    }
+    memcpy(recording + recording_length, record, length);
+    if (payload_length > 0)
+        memcpy(recording + recording_length + length, payload, payload_length);
+    recording_length += length + payload_length;
+    last_record_time = current_time;
+}
+
+static void appendInput(InputType input, const void* payload)
+{
+    static uint8_t record_payload[1 + RECORD_MAX_INPUT_SIZE];
+    record_payload[0] = input;
+    if (input_sizes[input] > 0)
+        memcpy(record_payload + 1, payload, input_sizes[input]);
+    appendRecord(RECORD_INPUT, record_payload, 1 + input_sizes[input]);
+}
+
+// Begin a new session. Call once the show is set up and seeded, before the first loop()
+void startRecording(uint32_t random_seed)
+{
+    memcpy(recording, "LEDR", 4);
+    recording[4] = RECORDER_VERSION;
+    writeUint32(recording + 5, random_seed);
+    writeUint32(recording + 9, current_time);
+    recording_length = RECORDER_HEADER_SIZE;
+
+    recording_active = true;
+    stop_reason = NULL;
+    last_record_time = current_time;
+    last_frame_hash = 0;
+    frame_shown = false;
+    recordSensorTable();
+
+    // After a reset the show resumes from a checkpoint, not from resetShowState(), so the log
+    // starts with the state the show is in
+    static ShowCheckpoint show_state;
+    captureShowCheckpoint(show_state);
+    appendInput(INPUT_SHOW_STATE, &show_state);
+}
+
+// End the log here, when the show takes an input the log can't hold. Everything recorded up to
+// this point still replays
+void stopRecording(const char* reason)
+{
+    if (!recording_active)
+        return;
+
+    recording_active = false;
+    stop_reason = reason;
+    LOG_WARN("Recorder: %s, recording stopped at %u bytes", reason, (unsigned)recording_length);
+}
+
+// Why the log ended before now, or NULL
+const char* getRecordingStopReason()
+{
+    return stop_reason;
+}
+
+void recordSensorEvent(uint8_t sensor_id)
+{
+    appendInput(INPUT_SENSOR, &sensor_id);
+}
+
+// While the fallback is on loop() shows showFallbackFrame() instead of the show, and the replay
+// has to do the same
+void recordFallbackChange(bool active)
+{
+    uint8_t value = active;
+    appendInput(INPUT_FALLBACK, &value);
+}
+
+void recordOutputSettings(const OutputSettings& settings)
+{
+    appendInput(INPUT_OUTPUT_SETTINGS, &settings);
+}
+
+// Log the whole sensor table, e.g. after it was loaded. Empty entries are left out
+void recordSensorTable()
+{
+    if (!recording_active)
+        return;
+
+    appendInput(INPUT_SENSOR_TABLE, NULL);
+    const SensorConfig empty = SensorConfig();
+    for (uint8_t id = 0; id < SENSOR_TABLE_SIZE; id++) {
+        const SensorConfig& config = sensor_mappings[id].config;
+        if (config.strip_mask != empty.strip_mask || config.cooldown_ms != empty.cooldown_ms
+            || config.envelope_index != empty.envelope_index || config.effect != empty.effect
+            || config.active != empty.active) {
+            recordSensorConfig(id, config);
+        }
+    }
+}
+
+void recordSensorConfig(uint8_t sensor_id, const SensorConfig& config)
+{
+    uint8_t payload[1 + sizeof(SensorConfig)];
+    payload[0] = sensor_id;
+    memcpy(payload + 1, &config, sizeof(config));
+    appendInput(INPUT_SENSOR_CONFIG, payload);
+}
+
+void recordForwardedEffect(const EffectForwardPacket& packet)
+{
+    appendInput(INPUT_FORWARDED_EFFECT, &packet);
+}
+
+// Call right after the render loop's FastLED.show(), before unlockOutput(), while the output buffers
+// still hold the frame that was sent.
+void captureShownFrame()
+{
+    if (!recording_active && !replay_active)
+        return;
+
+    frame_shown = true;
+    shown_frame_hash = hashFrame();
+}
+
+// Call at the end of loop()
+void recordLoopIteration()
+{
+    if (!recording_active)
+        return;
+
+    if (!frame_shown) {
+        appendRecord(RECORD_TICK, NULL, 0);
+    } else if (shown_frame_hash == last_frame_hash) {
+        appendRecord(RECORD_FRAME_SAME, NULL, 0);
+    } else {
+        uint8_t hash_bytes[4];
+        writeUint32(hash_bytes, shown_frame_hash);
+        appendRecord(RECORD_FRAME, hash_bytes, 4);
+        last_frame_hash = shown_frame_hash;
+    }
+    frame_shown = false;
+}
+
+const uint8_t* getRecording(size_t& length)
+{
+    length = recording_length;
+    return recording;
+}
+
+// Run a recorded session through the engine from a fresh show state, at the recorded loop
+// times, and compare every shown frame against its recorded hash. The show is driven through
+// show_runner.h, the same code loop() uses
+bool replayRecording(const uint8_t* data, size_t length, ReplayResult& result)
+{
+    memset(&result, 0, sizeof(result));
+    if (length < RECORDER_HEADER_SIZE || memcmp(data, "LEDR", 4) != 0 || data[4] != RECORDER_VERSION)
+        return false;
+    result.valid = true;
+
+    // The replay drives the same code that records, so keep it from writing over the log
+    bool was_recording = recording_active;
+    recording_active = false;
+    replay_active = true;
+
+    unsigned long replay_time = readUint32(data + 9);
+    current_time = replay_time;
+    resetShowState(readUint32(data + 5));
+    uint32_t expected_hash = 0;
+    bool fallback_active = false;
+    uint32_t start_us = micros();
+
+    size_t offset = RECORDER_HEADER_SIZE;
+    RecordEntry record;
+    while (readRecord(data, length, offset, record)) {
+        replay_time += record.delta;
+        current_time = replay_time;
+
+        if (record.type == RECORD_INPUT) {
+            const uint8_t* payload = data + record.payload_offset;
+            if (record.input == INPUT_SENSOR) {
+                replaySensorTrigger(payload[0]);
+                result.sensor_events++;
+            } else if (record.input == INPUT_FALLBACK) {
+                fallback_active = payload[0] != 0;
+                if (fallback_active)
+                    renderFallbackSolid();
+            } else if (record.input == INPUT_OUTPUT_SETTINGS) {
+                OutputSettings settings;
+                memcpy(&settings, payload, sizeof(settings));
+                setOutputSettings(settings);
+            } else if (record.input == INPUT_SENSOR_TABLE) {
+                clearSensorMappings();
+            } else if (record.input == INPUT_SENSOR_CONFIG) {
+                SensorConfig config;
+                memcpy(&config, payload + 1, sizeof(config));
+                setSensorConfig(payload[0], config);
+            } else if (record.input == INPUT_FORWARDED_EFFECT) {
+                EffectForwardPacket packet;
+                memcpy(&packet, payload, sizeof(packet));
+                applyForwardedEffect(packet);
+            } else if (record.input == INPUT_SHOW_STATE) {
+                static ShowCheckpoint show_state;
+                memcpy(&show_state, payload, sizeof(show_state));
+                applyShowState(show_state, true);
+            }
+            continue;
+        }
+
+        frame_shown = false;
+        if (fallback_active) {
+            showFallbackFrame();
+        } else {
+            runShowFrame();
+        }
+        if (record.type == RECORD_FRAME)
+            expected_hash = readUint32(data + record.payload_offset);
+
+        // A frame shown where none was recorded (or the other way round) is a mismatch too
+        bool matches = record.type == RECORD_TICK ? !frame_shown : frame_shown && shown_frame_hash == expected_hash;
+        if (!matches) {
+            if (result.mismatches == 0)
+                result.first_mismatch_frame = result.frames;
+            result.mismatches++;
+        }
+        result.frames++;
+    }
+
+    result.elapsed_us = micros() - start_us;
+    replay_active = false;
+    frame_shown = false;
+    recording_active = was_recording;
+    return true;
+}
+
+#ifndef ARDUINO
+bool saveRecording(const char* path)
+{
+    FILE* file = fopen(path, "wb");
+    if (file == NULL)
+        return false;
+
+    bool written = fwrite(recording, 1, recording_length, file) == recording_length;
+    fclose(file);
+    return written;
+}
+#endif
+
+#endif
@@ -0,0 +1,102 @@
+#ifndef FRAME_RECORDER_H
+#define FRAME_RECORDER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Records a hash of every shown frame plus the inputs that drove it (loop times, sensor triggers,
+// the sensor table, output settings, effects forwarded by other controllers, the frame watchdog's
+// fallback, the random seed) into a compact byte log. Replaying the log through the render engine
+// must reproduce every hash, so a change to a pattern can be checked pixel-exact against a
+// recording made on real traffic. Build with -DFRAME_RECORDER=1 to enable.
+//
+// A DDP stream can't be recorded in any useful size, so recording stops when one starts; the log
+// up to there still replays. getRecordingStopReason() says why a log ended early.
+#ifndef FRAME_RECORDER
+#define FRAME_RECORDER 0
+#endif
+
+#define RECORDER_BUFFER_SIZE 16384 // About a minute of animation at 50 FPS
+#define RECORDER_VERSION 2
+#define RECORDER_HEADER_SIZE 13 // "LEDR", version, random seed, start time
+
+// Each record starts with one byte: the record type in the top two bits and the time since the
+// previous record in the low six. Times of 63ms or more store 63 and follow with a varint.
+enum RecordType {
+    RECORD_TICK, // Loop iteration that showed nothing
+    RECORD_FRAME_SAME, // Frame shown with the same hash as the previous one
+    RECORD_FRAME, // Frame shown, followed by its 32-bit hash
+    RECORD_INPUT // Input to the show, followed by its InputType byte and payload
+};
+
+enum InputType {
+    INPUT_SENSOR, // Sensor message: the sensor ID byte
+    INPUT_FALLBACK, // Frame watchdog switched the fallback on (1) or off (0)
+    INPUT_OUTPUT_SETTINGS, // New output settings: the OutputSettings as stored
+    INPUT_SENSOR_TABLE, // Sensor table replaced, emptied first; INPUT_SENSOR_CONFIG records follow
+    INPUT_SENSOR_CONFIG, // Sensor table entry: the sensor ID byte and its SensorConfig
+    INPUT_FORWARDED_EFFECT, // Effect another controller forwarded: the EffectForwardPacket
+    INPUT_SHOW_STATE, // Show state the log starts from, after the seed: a ShowCheckpoint
+    INPUT_TYPE_COUNT
+};
+
+// One record as read back from a log
+struct RecordEntry {
+    RecordType type;
+    uint8_t input; // InputType of a RECORD_INPUT
+    unsigned long delta; // ms since the previous record
+    size_t payload_offset; // Where the payload starts in the log
+    uint16_t payload_length;
+};
+
+struct EffectForwardPacket;
+struct OutputSettings;
+struct SensorConfig;
+
+struct ReplayResult {
+    uint32_t frames; // Loop iterations compared
+    uint32_t sensor_events;
+    uint32_t mismatches;
+    uint32_t first_mismatch_frame;
+    uint32_t elapsed_us; // Wall time the replay took
+    bool valid; // Log header was recognised
+};
+
+uint32_t hashFrame();
+bool readRecord(const uint8_t* data, size_t length, size_t& offset, RecordEntry& record);
+
+#if FRAME_RECORDER
+
+void startRecording(uint32_t random_seed);
+void recordSensorEvent(uint8_t sensor_id);
+void recordFallbackChange(bool active);
+void recordOutputSettings(const OutputSettings& settings);
+void recordSensorTable();
+void recordSensorConfig(uint8_t sensor_id, const SensorConfig& config);
+void recordForwardedEffect(const EffectForwardPacket& packet);
+void stopRecording(const char* reason);
+const char* getRecordingStopReason();
+void captureShownFrame();
+void recordLoopIteration();
+const uint8_t* getRecording(size_t& length);
+bool replayRecording(const uint8_t* data, size_t length, ReplayResult& result);
+#ifndef ARDUINO
+bool saveRecording(const char* path);
+#endif
+
+#else
+
+inline void startRecording(uint32_t) { }
+inline void recordSensorEvent(uint8_t) { }
+inline void recordFallbackChange(bool) { }
+inline void recordOutputSettings(const OutputSettings&) { }
+inline void recordSensorTable() { }
+inline void recordSensorConfig(uint8_t, const SensorConfig&) { }
+inline void recordForwardedEffect(const EffectForwardPacket&) { }
+inline void stopRecording(const char*) { }
+inline void captureShownFrame() { }
+inline void recordLoopIteration() { }
+
+#endif
+
+#endif
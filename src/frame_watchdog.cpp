@@ -0,0 +1,221 @@
+#include "frame_watchdog.h"
+#include "frame_recorder.h"
+#include "live_preview.h"
+#include "logger.h"
+#include "output_stage.h"
+#include "patterns.h"
+#include "profiler.h"
+#include "show_clock.h"
+#include "telemetry.h"
+#include <atomic>
+
+#ifdef ARDUINO
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#endif
+
+static FrameWatchdogStats watchdog_stats = { false, 0, 0, STAGE_COUNT, 0, 0, 0 };
+static unsigned long last_slot_time = 0;
+static bool slot_time_valid = false;
+static uint16_t miss_debt = 0; // Missed slots net of on-time frames
+static uint32_t longest_gap = 0; // Since the misses started building up
+static uint16_t on_time_frames = 0; // Consecutive, while the fallback shows
+static uint8_t relapses = 0;
+static unsigned long fallback_end_time = 0;
+
+// What the stall guard needs from loop(), published every slot: when it last reached one, and
+// the fallback color for the show as it is
+static std::atomic<bool> guard_armed(false);
+static std::atomic<uint32_t> guard_slot_time(0);
+static std::atomic<uint32_t> guard_color(0);
+static std::atomic<uint32_t> stall_frames(0);
+static bool guard_sending = false; // Only touched by the guard
+
+// Forget the last frame, e.g. after setup() has kept loop() waiting
+void resetFrameWatchdog()
+{
+    slot_time_valid = false;
+    miss_debt = 0;
+    longest_gap = 0;
+    guard_armed = false;
+}
+
+// Palette of the pattern drawn last, i.e. on top, dimmed; warm white when nothing is running
+static CRGB getFallbackColor()
+{
+    CRGB color = CRGB(255, 147, 41);
+    for (uint8_t i = 0; i < pattern_queue.queue_size; i++) {
+        const ChasePattern& pattern = pattern_queue.patterns[i];
+        if ((pattern.is_active || pattern.is_transitioning) && pattern.palette_size > 0)
+            color = pattern.palette[0];
+    }
+    return color.nscale8(FRAME_FALLBACK_LEVEL);
+}
+
+// Render the fallback solid for the show as it is; showFallbackFrame() only resends it. Straight
+// into the output buffers, as the stall guard does: the patterns' strips keep their last frame
+// for when the show resumes
+void renderFallbackSolid()
+{
+    lockOutput();
+    renderOutputSolid(getFallbackColor());
+    unlockOutput();
+}
+
+static void startFallback(unsigned long now_ms)
+{
+    uint8_t stage;
+    uint32_t stage_us;
+    if (!takeSlowestStage(stage, stage_us)) {
+        stage = STAGE_COUNT;
+        stage_us = 0;
+    }
+
+    relapses = watchdog_stats.fallbacks > 0 && now_ms - fallback_end_time < FRAME_WATCHDOG_RELAPSE_WINDOW
+        ? min(relapses + 1, FRAME_WATCHDOG_MAX_BACKOFF)
+        : 0;
+    watchdog_stats.fallback_active = true;
+    watchdog_stats.fallbacks++;
+    watchdog_stats.last_stage = stage;
+    watchdog_stats.last_stage_us = stage_us;
+    watchdog_stats.last_gap_ms = longest_gap;
+    on_time_frames = 0;
+
+    LOG_WARN("Frame watchdog: %u missed, gap %lu ms, slowest %s %lu us; fallback on",
+        miss_debt, (unsigned long)longest_gap, stage < STAGE_COUNT ? getStageName(stage) : "unknown",
+        (unsigned long)stage_us);
+
+    renderFallbackSolid();
+    recordFallbackChange(true);
+}
+
+static void endFallback(unsigned long now_ms)
+{
+    watchdog_stats.fallback_active = false;
+    fallback_end_time = now_ms;
+    miss_debt = 0;
+    longest_gap = 0;
+    recordFallbackChange(false);
+    LOG_INFO("Frame watchdog: fallback off, show resumed");
+}
+
+// Call once per frame slot with the local time in ms, before rendering. Returns true while the
+// fallback is on, in which case the caller shows showFallbackFrame() instead of the show
+bool updateFrameWatchdog(unsigned long now_ms)
+{
+    unsigned long gap = now_ms - last_slot_time;
+    bool first_frame = !slot_time_valid;
+    last_slot_time = now_ms;
+    slot_time_valid = true;
+
+    CRGB color = getFallbackColor();
+    guard_color = ((uint32_t)color.r << 16) | ((uint32_t)color.g << 8) | color.b;
+    guard_slot_time = now_ms;
+    guard_armed = true;
+    if (first_frame)
+        return watchdog_stats.fallback_active;
+
+    uint32_t missed = gap >= 2 * SHOW_FRAME_INTERVAL ? gap / SHOW_FRAME_INTERVAL - 1 : 0;
+    watchdog_stats.missed_frames += missed;
+
+    if (!watchdog_stats.fallback_active) {
+        if (missed > 0) {
+            // One gap on its own stays below the threshold: it is over by now, and the stall guard
+            // covered it while it lasted. It takes another soon after to trip the fallback
+            uint32_t counted = min(missed, (uint32_t)(FRAME_WATCHDOG_MISSES - 1));
+            miss_debt = min((uint32_t)miss_debt + counted, (uint32_t)UINT16_MAX);
+            longest_gap = max(longest_gap, (uint32_t)gap);
+        } else if (miss_debt > 0) {
+            miss_debt--;
+        } else {
+            // Only the stages behind a run of misses are worth reporting
+            uint8_t stage;
+            uint32_t stage_us;
+            takeSlowestStage(stage, stage_us);
+            longest_gap = 0;
+        }
+
+        if (miss_debt >= FRAME_WATCHDOG_MISSES)
+            startFallback(now_ms);
+    } else {
+        on_time_frames = missed == 0 ? on_time_frames + 1 : 0;
+        if (on_time_frames >= (uint16_t)(FRAME_WATCHDOG_RECOVERY << relapses))
+            endFallback(now_ms);
+    }
+    return watchdog_stats.fallback_active;
+}
+
+// Resend the precomputed fallback frame
+void showFallbackFrame()
+{
+    PROFILE_STAGE(STAGE_SHOW);
+    lockOutput();
+    FastLED.show();
+    captureShownFrame();
+    unlockOutput();
+    recordFrameShown();
+    capturePreviewFrame();
+    if (frame_shown_hook != NULL) {
+        frame_shown_hook();
+    }
+}
+
+// Send the fallback solid for a slot loop() is missing, once it has missed FRAME_WATCHDOG_MISSES
+// in a row. Returns true when a frame went out. A stall inside the output itself holds the output
+// lock, and there is nothing to do but wait for it
+bool serviceStallGuard(unsigned long now_ms)
+{
+    if (!guard_armed || now_ms - guard_slot_time < (unsigned long)FRAME_WATCHDOG_MISSES * SHOW_FRAME_INTERVAL) {
+        if (guard_sending) {
+            guard_sending = false;
+            LOG_INFO("Frame watchdog: loop() running again, stall guard off");
+        }
+        return false;
+    }
+    if (!tryLockOutput())
+        return false;
+
+    if (!guard_sending) {
+        guard_sending = true;
+        LOG_WARN("Frame watchdog: no frame for %lu ms, stall guard sending the fallback",
+            (unsigned long)(now_ms - guard_slot_time));
+    }
+    renderOutputSolid(getStallGuardColor());
+    FastLED.show();
+    unlockOutput();
+    stall_frames++;
+    return true;
+}
+
+CRGB getStallGuardColor()
+{
+    return CRGB((uint32_t)guard_color);
+}
+
+#ifdef ARDUINO
+static void stallGuardTask(void* parameter)
+{
+    TickType_t wake_time = xTaskGetTickCount();
+    while (true) {
+        vTaskDelayUntil(&wake_time, pdMS_TO_TICKS(SHOW_FRAME_INTERVAL));
+        serviceStallGuard(millis());
+    }
+}
+#endif
+
+// Start the stall guard on the core loop() doesn't run on. It stays idle until loop() reaches
+// its first frame slot after resetFrameWatchdog()
+void startStallGuard()
+{
+#ifdef ARDUINO
+    xTaskCreatePinnedToCore(stallGuardTask, "stall_guard", STALL_GUARD_STACK_SIZE, NULL, STALL_GUARD_PRIORITY, NULL,
+        ARDUINO_RUNNING_CORE == 0 ? 1 : 0);
+    Serial.printf("Frame stall guard running on core %d\n", ARDUINO_RUNNING_CORE == 0 ? 1 : 0);
+#endif
+}
+
+void getFrameWatchdogStats(FrameWatchdogStats& stats)
+{
+    stats = watchdog_stats;
+    stats.stall_frames = stall_frames;
+}
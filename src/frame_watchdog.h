@@ -0,0 +1,48 @@
+#ifndef FRAME_WATCHDOG_H
+#define FRAME_WATCHDOG_H
+
+#include <FastLED.h>
+#include <stdint.h>
+
+// Frame deadline monitor. Every SHOW_FRAME_INTERVAL slot should get a frame; when render or
+// network stalls keep loop() from producing them, the show is swapped for a static solid from
+// the current palette, computed once and resent every slot, so the LEDs keep showing something
+// calm instead of freezing on a half-drawn frame. The slowest profiled stage since the last good
+// frame is logged as the likely culprit.
+//
+// Misses are counted net of on-time frames, so a dropped slot, a loop that runs a little slow or
+// one stall that is already over never trips it, while a show that keeps losing ground does. The
+// show is tried again after FRAME_WATCHDOG_RECOVERY on-time frames; a show that stalls again soon
+// after has to wait twice as long each time.
+//
+// loop() can't send anything while it is stuck, so on the controller a stall guard task on the
+// other core covers the stall itself: once loop() has missed FRAME_WATCHDOG_MISSES slots in a row
+// it sends the fallback solid every slot, straight into the output buffers, until loop() is back.
+#define FRAME_WATCHDOG_MISSES 10 // Net missed slots before the fallback takes over (200 ms)
+#define FRAME_WATCHDOG_RECOVERY 50 // On-time fallback frames before the show resumes (1 s)
+#define FRAME_WATCHDOG_MAX_BACKOFF 5 // Recovery waits at most 2^n times as long
+#define FRAME_WATCHDOG_RELAPSE_WINDOW 10000 // ms; stalling again within this counts as a relapse
+#define FRAME_FALLBACK_LEVEL 128 // Brightness of the fallback solid (of 255)
+#define STALL_GUARD_STACK_SIZE 4096
+#define STALL_GUARD_PRIORITY 2 // Above loop() and the idle task, below WiFi
+
+struct FrameWatchdogStats {
+    bool fallback_active;
+    uint32_t missed_frames; // Slots without a frame since boot
+    uint32_t fallbacks; // Times the fallback took over
+    uint8_t last_stage; // Slowest stage before the last fallback (ProfileStage), STAGE_COUNT if unknown
+    uint32_t last_stage_us;
+    uint32_t last_gap_ms; // Longest gap between frames leading up to the last fallback
+    uint32_t stall_frames; // Fallback frames the stall guard sent while loop() was stuck
+};
+
+void resetFrameWatchdog();
+bool updateFrameWatchdog(unsigned long now_ms);
+void renderFallbackSolid();
+void showFallbackFrame();
+void startStallGuard();
+bool serviceStallGuard(unsigned long now_ms);
+CRGB getStallGuardColor();
+void getFrameWatchdogStats(FrameWatchdogStats& stats);
+
+#endif
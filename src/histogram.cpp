@@ -0,0 +1,76 @@
+#include "histogram.h"
+#include <Arduino.h>
+
+void resetHistogram(Histogram& histogram)
+{
+    memset(histogram.buckets, 0, sizeof(histogram.buckets));
+    histogram.count = 0;
+    histogram.min_us = UINT32_MAX;
+    histogram.max_us = 0;
+}
+
+// Log-linear buckets: values below HISTOGRAM_SUB_BUCKETS get their own bucket, above that each
+// power of two is split into HISTOGRAM_SUB_BUCKETS equal parts
+static uint8_t bucketForMicros(uint32_t us)
+{
+    if (us < HISTOGRAM_SUB_BUCKETS)
+        return us;
+
+    uint8_t exponent = 31 - __builtin_clz(us); // >= 2
+    uint8_t sub_bucket = (us >> (exponent - 2)) & (HISTOGRAM_SUB_BUCKETS - 1);
+    uint16_t bucket = (exponent - 1) * HISTOGRAM_SUB_BUCKETS + sub_bucket;
+    return bucket < HISTOGRAM_BUCKETS ? bucket : HISTOGRAM_BUCKETS - 1;
+}
+
+// Largest value that falls into a bucket
+static uint32_t bucketUpperBound(uint8_t bucket)
+{
+    if (bucket < HISTOGRAM_SUB_BUCKETS)
+        return bucket;
+
+    uint8_t exponent = bucket / HISTOGRAM_SUB_BUCKETS + 1;
+    uint8_t sub_bucket = bucket % HISTOGRAM_SUB_BUCKETS;
+    return ((uint32_t)(HISTOGRAM_SUB_BUCKETS + sub_bucket + 1) << (exponent - 2)) - 1;
+}
+
+void recordHistogram(Histogram& histogram, uint32_t us)
+{
+    histogram.buckets[bucketForMicros(us)]++;
+    histogram.count++;
+    if (us < histogram.min_us)
+        histogram.min_us = us;
+    if (us > histogram.max_us)
+        histogram.max_us = us;
+}
+
+bool getHistogramStats(const Histogram& histogram, HistogramStats& stats)
+{
+    if (histogram.count == 0)
+        return false;
+
+    stats.count = histogram.count;
+    stats.min_us = histogram.min_us;
+    stats.max_us = histogram.max_us;
+
+    // Walk the buckets until the cumulative count passes each percentile
+    uint32_t p50_rank = (histogram.count + 1) / 2;
+    uint32_t p99_rank = histogram.count - histogram.count / 100;
+    uint32_t seen = 0;
+    stats.p50_us = 0;
+    stats.p99_us = 0;
+    for (uint8_t bucket = 0; bucket < HISTOGRAM_BUCKETS; bucket++) {
+        uint32_t previous = seen;
+        seen += histogram.buckets[bucket];
+        if (previous < p50_rank && seen >= p50_rank)
+            stats.p50_us = bucketUpperBound(bucket);
+        if (previous < p99_rank && seen >= p99_rank) {
+            stats.p99_us = bucketUpperBound(bucket);
+            break;
+        }
+    }
+
+    // Bucket bounds can overshoot the largest sample actually seen
+    stats.p50_us = min(stats.p50_us, stats.max_us);
+    stats.p99_us = min(stats.p99_us, stats.max_us);
+    return true;
+}
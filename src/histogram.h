@@ -0,0 +1,29 @@
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+#include <stdint.h>
+
+#define HISTOGRAM_SUB_BUCKETS 4 // Buckets per power of two (~19% resolution)
+#define HISTOGRAM_BUCKETS (21 * HISTOGRAM_SUB_BUCKETS) // Covers 0us to ~2s
+
+// Fixed-bucket log-linear histogram of microsecond durations
+struct Histogram {
+    uint32_t buckets[HISTOGRAM_BUCKETS];
+    uint32_t count;
+    uint32_t min_us;
+    uint32_t max_us;
+};
+
+struct HistogramStats {
+    uint32_t count;
+    uint32_t min_us;
+    uint32_t p50_us; // Upper bound of the bucket holding the median
+    uint32_t p99_us;
+    uint32_t max_us;
+};
+
+void resetHistogram(Histogram& histogram);
+void recordHistogram(Histogram& histogram, uint32_t us);
+bool getHistogramStats(const Histogram& histogram, HistogramStats& stats);
+
+#endif
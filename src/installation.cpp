@@ -0,0 +1,162 @@
+#include "installation.h"
+#include "effect_queue.h"
+#include "frame_recorder.h"
+#include "logger.h"
+#include "patterns.h"
+#include "sensor_config.h"
+
+#ifdef ARDUINO
+#include <WiFiUdp.h>
+
+static WiFiUDP forward_udp;
+#endif
+
+// Every controller in the installation. Each one is built with the FIRST_LOCAL_STRIP of its own
+// entry and the same INSTALLATION_STRIP_COUNT, e.g. for a second ring of 22 strips:
+//   { "192.168.4.1", 0, 22, 122 }, { "192.168.4.2", 22, 22, 122 }
+const InstallationController installation_controllers[] = {
+    { "192.168.4.1", 0, 22, 122 },
+};
+const uint8_t installation_controller_count = sizeof(installation_controllers) / sizeof(installation_controllers[0]);
+
+static EffectForwardStats forward_stats;
+
+// A ripple only reaches strips this many ids either side of its origin
+#define RIPPLE_REACH_STRIPS (RIPPLE_MAX_RADIUS / RIPPLE_STRIP_SPACING)
+
+static uint64_t getControllerStripMask(const InstallationController& controller)
+{
+    uint64_t strips = controller.strip_count >= 64 ? ~0ULL : (1ULL << controller.strip_count) - 1;
+    return strips << controller.first_strip;
+}
+
+static uint64_t getRippleReachMask(uint8_t origin_strip)
+{
+    uint64_t mask = 0;
+    for (int16_t strip = (int16_t)origin_strip - RIPPLE_REACH_STRIPS; strip <= origin_strip + RIPPLE_REACH_STRIPS;
+         strip++) {
+        if (strip >= 0 && strip < INSTALLATION_STRIP_COUNT)
+            mask |= 1ULL << strip;
+    }
+    return mask;
+}
+
+// LEDs on a strip, wherever it is driven from; strips no controller claims count as full length
+uint16_t getInstallationStripLength(uint8_t strip_id)
+{
+    int8_t local_strip = getLocalStrip(strip_id);
+    if (local_strip >= 0)
+        return getStripLength(local_strip);
+
+    for (uint8_t i = 0; i < installation_controller_count; i++) {
+        const InstallationController& controller = installation_controllers[i];
+        if (strip_id >= controller.first_strip && strip_id < controller.first_strip + controller.strip_count)
+            return controller.strip_length;
+    }
+    return MAX_STRIP_LENGTH;
+}
+
+void initEffectForwarding()
+{
+    forward_stats = EffectForwardStats();
+#ifdef ARDUINO
+    if (installation_controller_count > 1) {
+        forward_udp.begin(EFFECT_FORWARD_PORT);
+        Serial.printf("Installation: strips %d-%d of %d, effects forwarded on UDP port %d\n", FIRST_LOCAL_STRIP,
+            FIRST_LOCAL_STRIP + LOCAL_STRIP_COUNT - 1, INSTALLATION_STRIP_COUNT, EFFECT_FORWARD_PORT);
+    }
+#endif
+}
+
+// Queue the part of an effect this controller draws. Returns false when the rate limit refused it
+static bool queueLocalEffect(uint8_t effect, uint8_t envelope_index, uint64_t strip_mask, uint8_t origin_strip)
+{
+    if (effect == SENSOR_EFFECT_RIPPLE) {
+        if ((getRippleReachMask(origin_strip) & LOCAL_STRIP_MASK) == 0)
+            return true;
+        return queueRipple(origin_strip, envelope_index);
+    }
+
+    uint32_t local_mask = (uint32_t)((strip_mask & LOCAL_STRIP_MASK) >> FIRST_LOCAL_STRIP);
+    return local_mask == 0 || queueFlashBulb(local_mask, envelope_index);
+}
+
+// Start a sensor effect across the installation: queue our own strips' part and send the effect
+// to every other controller it reaches. Returns false, sending nothing, when our rate limit refused
+// it, so the sensor's cooldown doesn't start either
+bool startInstallationEffect(uint8_t effect, uint8_t envelope_index, uint64_t strip_mask, uint8_t origin_strip)
+{
+    if (!queueLocalEffect(effect, envelope_index, strip_mask, origin_strip))
+        return false;
+
+    uint64_t reach = effect == SENSOR_EFFECT_RIPPLE ? getRippleReachMask(origin_strip) : strip_mask;
+    if ((reach & ~LOCAL_STRIP_MASK) == 0)
+        return true;
+
+#ifdef ARDUINO
+    EffectForwardPacket packet = {};
+    packet.magic = EFFECT_FORWARD_MAGIC;
+    packet.effect = effect;
+    packet.envelope_index = envelope_index;
+    packet.origin_strip = origin_strip;
+    packet.strip_mask = strip_mask;
+#endif
+
+    for (uint8_t i = 0; i < installation_controller_count; i++) {
+        const InstallationController& controller = installation_controllers[i];
+        if (controller.first_strip == FIRST_LOCAL_STRIP || (reach & getControllerStripMask(controller)) == 0)
+            continue;
+
+#ifdef ARDUINO
+        IPAddress address;
+        address.fromString(controller.address);
+        forward_udp.beginPacket(address, EFFECT_FORWARD_PORT);
+        forward_udp.write((const uint8_t*)&packet, sizeof(packet));
+        forward_udp.endPacket();
+#endif
+        forward_stats.sent++;
+        LOG_DEBUG("Installation: %s forwarded to %s", getSensorEffectName(effect), controller.address);
+    }
+    return true;
+}
+
+// Queue our part of an effect another controller forwarded. It is never forwarded again
+bool applyForwardedEffect(const EffectForwardPacket& packet)
+{
+    if (packet.magic != EFFECT_FORWARD_MAGIC || packet.effect >= SENSOR_EFFECT_COUNT
+        || packet.origin_strip >= INSTALLATION_STRIP_COUNT) {
+        forward_stats.rejected++;
+        return false;
+    }
+
+    forward_stats.received++;
+    recordForwardedEffect(packet);
+    return queueLocalEffect(packet.effect, packet.envelope_index, packet.strip_mask, packet.origin_strip);
+}
+
+void pollForwardedEffects()
+{
+#ifdef ARDUINO
+    if (installation_controller_count <= 1)
+        return;
+
+    for (uint8_t i = 0; i < EFFECT_FORWARD_MAX_PACKETS_PER_POLL; i++) {
+        int packet_size = forward_udp.parsePacket();
+        if (packet_size <= 0)
+            break;
+
+        EffectForwardPacket packet;
+        if (packet_size != sizeof(packet)) {
+            forward_stats.rejected++;
+            continue;
+        }
+        forward_udp.read((uint8_t*)&packet, sizeof(packet));
+        applyForwardedEffect(packet);
+    }
+#endif
+}
+
+void getEffectForwardStats(EffectForwardStats& stats)
+{
+    stats = forward_stats;
+}
@@ -0,0 +1,75 @@
+#ifndef INSTALLATION_H
+#define INSTALLATION_H
+
+#include <stdint.h>
+
+// One show can be spread over several controllers. Every strip has a global id across the
+// installation, and each controller drives LOCAL_STRIP_COUNT consecutive ids starting at
+// FIRST_LOCAL_STRIP. Patterns lay themselves out over global ids but only draw the strips this
+// controller drives. Sensor effects that reach strips driven elsewhere are forwarded over UDP to
+// the controllers listed in installation_controllers. A single controller needs no flags.
+#define LOCAL_STRIP_COUNT 22
+#ifndef FIRST_LOCAL_STRIP
+#define FIRST_LOCAL_STRIP 0
+#endif
+#ifndef INSTALLATION_STRIP_COUNT
+#define INSTALLATION_STRIP_COUNT LOCAL_STRIP_COUNT
+#endif
+#define INSTALLATION_MAX_STRIPS 64 // Installation strip masks are 64 bits
+
+#if INSTALLATION_STRIP_COUNT > INSTALLATION_MAX_STRIPS || FIRST_LOCAL_STRIP + LOCAL_STRIP_COUNT > INSTALLATION_STRIP_COUNT
+#error "This controller's strips must lie inside the installation's INSTALLATION_STRIP_COUNT strips"
+#endif
+
+#define INSTALLATION_ALL_STRIPS \
+    (INSTALLATION_STRIP_COUNT >= 64 ? ~0ULL : (1ULL << (INSTALLATION_STRIP_COUNT % 64)) - 1)
+#define LOCAL_STRIP_MASK (((1ULL << LOCAL_STRIP_COUNT) - 1) << FIRST_LOCAL_STRIP)
+
+#define EFFECT_FORWARD_PORT 4050
+#define EFFECT_FORWARD_MAGIC 0x4457464CUL // "LFWD"
+#define EFFECT_FORWARD_MAX_PACKETS_PER_POLL 8
+
+// A controller and the global strip ids it drives
+struct InstallationController {
+    const char* address; // IPv4 address on the show network
+    uint8_t first_strip;
+    uint8_t strip_count;
+    uint16_t strip_length; // LEDs per strip
+};
+
+// A sensor effect for another controller's strips. Sent as is: both ends are little-endian
+struct EffectForwardPacket {
+    uint32_t magic;
+    uint8_t effect; // SensorEffect
+    uint8_t envelope_index;
+    uint8_t origin_strip; // Global strip a ripple starts from
+    uint8_t reserved;
+    uint64_t strip_mask; // Global strips a FlashBulb lights
+};
+
+struct EffectForwardStats {
+    uint32_t sent; // Packets sent to other controllers
+    uint32_t received; // Effects received from other controllers
+    uint32_t rejected; // Packets with a bad magic, length or effect
+};
+
+extern const InstallationController installation_controllers[];
+extern const uint8_t installation_controller_count;
+
+// This controller's index for a global strip id, or -1 when another controller drives it (or no
+// strip has that id)
+inline int8_t getLocalStrip(uint8_t strip_id)
+{
+    uint8_t local_strip = strip_id - FIRST_LOCAL_STRIP;
+    return local_strip < LOCAL_STRIP_COUNT ? (int8_t)local_strip : -1;
+}
+
+uint16_t getInstallationStripLength(uint8_t strip_id);
+
+void initEffectForwarding();
+void pollForwardedEffects();
+bool startInstallationEffect(uint8_t effect, uint8_t envelope_index, uint64_t strip_mask, uint8_t origin_strip);
+bool applyForwardedEffect(const EffectForwardPacket& packet);
+void getEffectForwardStats(EffectForwardStats& stats);
+
+#endif
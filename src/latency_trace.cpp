@@ -0,0 +1,114 @@
+#include "latency_trace.h"
+#include "logger.h"
+#include <Arduino.h>
+
+static Histogram latency_histograms[LATENCY_SEGMENT_COUNT];
+
+static LatencyTrace pending_traces[LATENCY_MAX_PENDING];
+static uint8_t pending_count = 0;
+
+// Offset samples are local receive time minus gateway timestamp, in ms. Network delay only ever
+// adds to a sample, so the smallest recent one is the best estimate of the true clock offset and
+// anything above it is delivery delay. Keeping a window lets the estimate follow clock drift.
+static uint32_t offset_samples[CLOCK_OFFSET_WINDOW];
+static uint8_t offset_sample_count = 0;
+static uint8_t offset_sample_next = 0;
+static uint32_t clock_offset = 0;
+
+static const char* const segment_names[LATENCY_SEGMENT_COUNT] = { "network", "receive_to_start", "start_to_show",
+    "receive_to_show", "sensor_to_show" };
+
+void initLatencyTracing()
+{
+    for (uint8_t segment = 0; segment < LATENCY_SEGMENT_COUNT; segment++) {
+        resetHistogram(latency_histograms[segment]);
+    }
+    pending_count = 0;
+    offset_sample_count = 0;
+    offset_sample_next = 0;
+}
+
+// Add an offset sample and return the delivery delay it implies, in ms
+static uint32_t updateClockOffset(uint32_t offset_sample)
+{
+    offset_samples[offset_sample_next] = offset_sample;
+    offset_sample_next = (offset_sample_next + 1) % CLOCK_OFFSET_WINDOW;
+    if (offset_sample_count < CLOCK_OFFSET_WINDOW)
+        offset_sample_count++;
+
+    // Compare relative to the newest sample so both clocks may wrap
+    int32_t smallest = 0;
+    for (uint8_t i = 0; i < offset_sample_count; i++) {
+        int32_t relative = (int32_t)(offset_samples[i] - offset_sample);
+        if (relative < smallest)
+            smallest = relative;
+    }
+    clock_offset = offset_sample + smallest;
+    return (uint32_t)-smallest;
+}
+
+// Call as soon as a sensor message arrives. gateway_ms is the message's timestamp, taken to be
+// milliseconds on the gateway's clock.
+LatencyTrace beginLatencyTrace(uint32_t gateway_ms, uint32_t receive_us)
+{
+    LatencyTrace trace;
+    trace.receive_us = receive_us;
+    trace.network_delay_us = updateClockOffset((uint32_t)millis() - gateway_ms) * 1000;
+    trace.start_us = receive_us;
+    return trace;
+}
+
+// Call just before the effect is triggered; the trace completes on the next shown frame
+void startLatencyTrace(LatencyTrace& trace)
+{
+    trace.start_us = micros();
+
+    if (pending_count >= LATENCY_MAX_PENDING) {
+        LOG_WARN("Latency: too many pending traces, dropping one");
+        return;
+    }
+    pending_traces[pending_count++] = trace;
+}
+
+// Call right after every FastLED.show()
+void traceFrameShown()
+{
+    if (pending_count == 0)
+        return;
+
+    uint32_t show_us = micros();
+    for (uint8_t i = 0; i < pending_count; i++) {
+        const LatencyTrace& trace = pending_traces[i];
+        uint32_t receive_to_start = trace.start_us - trace.receive_us;
+        uint32_t start_to_show = show_us - trace.start_us;
+        uint32_t receive_to_show = show_us - trace.receive_us;
+        uint32_t sensor_to_show = trace.network_delay_us + receive_to_show;
+
+        recordHistogram(latency_histograms[LATENCY_NETWORK], trace.network_delay_us);
+        recordHistogram(latency_histograms[LATENCY_RECEIVE_TO_START], receive_to_start);
+        recordHistogram(latency_histograms[LATENCY_START_TO_SHOW], start_to_show);
+        recordHistogram(latency_histograms[LATENCY_RECEIVE_TO_SHOW], receive_to_show);
+        recordHistogram(latency_histograms[LATENCY_SENSOR_TO_SHOW], sensor_to_show);
+
+        LOG_DEBUG("Latency: sensor->photon %lu us (network +%lu, receive->start %lu, start->show %lu)",
+            (unsigned long)sensor_to_show, (unsigned long)trace.network_delay_us, (unsigned long)receive_to_start,
+            (unsigned long)start_to_show);
+    }
+    pending_count = 0;
+}
+
+bool getLatencyStats(uint8_t segment, HistogramStats& stats)
+{
+    return segment < LATENCY_SEGMENT_COUNT && getHistogramStats(latency_histograms[segment], stats);
+}
+
+const char* getLatencySegmentName(uint8_t segment)
+{
+    return segment < LATENCY_SEGMENT_COUNT ? segment_names[segment] : "";
+}
+
+// Local millis() minus gateway time, from the fastest message in the current window
+int32_t getGatewayClockOffset()
+{
+    return (int32_t)clock_offset;
+}
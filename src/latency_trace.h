@@ -0,0 +1,35 @@
+#ifndef LATENCY_TRACE_H
+#define LATENCY_TRACE_H
+
+#include "histogram.h"
+#include <stdint.h>
+
+#define LATENCY_MAX_PENDING 8 // Effects started but not yet shown
+#define CLOCK_OFFSET_WINDOW 16 // Recent sensor messages the gateway clock offset is estimated over
+
+// Sensor-to-photon latency, split at each point we can observe on the controller
+enum LatencySegment {
+    LATENCY_NETWORK, // Delivery delay above the fastest recent message (from the gateway timestamp)
+    LATENCY_RECEIVE_TO_START, // Message received to its queued effect applied by the next frame
+    LATENCY_START_TO_SHOW, // Effect triggered to the end of the first FastLED.show() containing it
+    LATENCY_RECEIVE_TO_SHOW,
+    LATENCY_SENSOR_TO_SHOW, // Network + receive to show: the full path a visitor experiences
+    LATENCY_SEGMENT_COUNT
+};
+
+struct LatencyTrace {
+    uint32_t receive_us;
+    uint32_t network_delay_us;
+    uint32_t start_us;
+};
+
+void initLatencyTracing();
+LatencyTrace beginLatencyTrace(uint32_t gateway_ms, uint32_t receive_us);
+void startLatencyTrace(LatencyTrace& trace);
+void traceFrameShown();
+
+bool getLatencyStats(uint8_t segment, HistogramStats& stats);
+const char* getLatencySegmentName(uint8_t segment);
+int32_t getGatewayClockOffset();
+
+#endif
@@ -0,0 +1,250 @@
+#include "led_kernels.h"
+#include "patterns.h"
+
+// The kernels treat a CRGB span as a plain byte stream, since every operation applies the same
+// way to each channel. Bytes are processed one at a time up to a 4-byte boundary, then a word
+// at a time, then one at a time for the tail. Each word is split into its even and odd bytes,
+// giving two 16-bit lanes per half that have room for the intermediate products of scale8()
+// without carrying into the neighbouring channel.
+
+// Word view of the LED bytes that is allowed to alias CRGB
+typedef uint32_t __attribute__((__may_alias__)) led_word_t;
+
+#define EVEN_BYTES 0x00FF00FFUL
+#define LANE_BIT8 0x01000100UL
+#define HIGH_BITS 0x80808080UL
+
+// scale8() on two channels held in 16-bit lanes
+static inline uint32_t scaleLanes(uint32_t lanes, uint16_t scale_plus_one)
+{
+    return ((lanes * scale_plus_one) >> 8) & EVEN_BYTES;
+}
+
+static inline uint32_t scaleWord(uint32_t word, uint16_t scale_plus_one)
+{
+    return scaleLanes(word & EVEN_BYTES, scale_plus_one) | (scaleLanes((word >> 8) & EVEN_BYTES, scale_plus_one) << 8);
+}
+
+// lerp8by8() on two channels held in 16-bit lanes
+static inline uint32_t lerpLanes(uint32_t from, uint32_t to, uint16_t amount_plus_one)
+{
+    // 256 + to - from never borrows across lanes; bit 8 is set where to >= from
+    uint32_t biased = (to | LANE_BIT8) - from;
+    uint32_t up_mask = ((biased >> 8) & 0x00010001UL) * 0xFF;
+    uint32_t down_mask = up_mask ^ EVEN_BYTES;
+
+    // |to - from| per lane
+    uint32_t low = biased & EVEN_BYTES;
+    uint32_t distance = (low & up_mask) | ((LANE_BIT8 - low) & down_mask);
+
+    uint32_t step = scaleLanes(distance, amount_plus_one);
+    return from + (step & up_mask) - (step & down_mask);
+}
+
+static inline uint32_t lerpWord(uint32_t from, uint32_t to, uint16_t amount_plus_one)
+{
+    return lerpLanes(from & EVEN_BYTES, to & EVEN_BYTES, amount_plus_one)
+        | (lerpLanes((from >> 8) & EVEN_BYTES, (to >> 8) & EVEN_BYTES, amount_plus_one) << 8);
+}
+
+// qadd8() on four channels
+static inline uint32_t addWord(uint32_t a, uint32_t b)
+{
+    uint32_t low_sum = (a & ~HIGH_BITS) + (b & ~HIGH_BITS);
+    uint32_t sum = low_sum ^ ((a ^ b) & HIGH_BITS);
+    uint32_t carry = ((a & b) | ((a | b) & ~sum)) & HIGH_BITS;
+    return sum | ((carry >> 7) * 0xFF);
+}
+
+// Number of leading bytes to process one at a time before ptr is word aligned
+static inline uint8_t bytesToAlignment(const void* ptr)
+{
+    return (4 - ((uintptr_t)ptr & 3)) & 3;
+}
+
+void scaleLEDsReference(CRGB* leds, uint16_t count, uint8_t scale)
+{
+    for (uint16_t i = 0; i < count; i++) {
+        leds[i].nscale8(scale);
+    }
+}
+
+void lerpLEDsReference(CRGB* leds, const CRGB* target, uint16_t count, fract8 amount)
+{
+    for (uint16_t i = 0; i < count; i++) {
+        leds[i] = leds[i].lerp8(target[i], amount);
+    }
+}
+
+void addLEDsReference(CRGB* leds, const CRGB* source, uint16_t count)
+{
+    for (uint16_t i = 0; i < count; i++) {
+        leds[i] += source[i];
+    }
+}
+
+void addScaledLEDsReference(CRGB* leds, const CRGB* source, uint16_t count, uint8_t scale)
+{
+    for (uint16_t i = 0; i < count; i++) {
+        CRGB scaled = source[i];
+        leds[i] += scaled.nscale8(scale);
+    }
+}
+
+#ifdef LED_KERNELS_SCALAR
+
+void scaleLEDs(CRGB* leds, uint16_t count, uint8_t scale) { scaleLEDsReference(leds, count, scale); }
+void lerpLEDs(CRGB* leds, const CRGB* target, uint16_t count, fract8 amount) { lerpLEDsReference(leds, target, count, amount); }
+void addLEDs(CRGB* leds, const CRGB* source, uint16_t count) { addLEDsReference(leds, source, count); }
+void addScaledLEDs(CRGB* leds, const CRGB* source, uint16_t count, uint8_t scale) { addScaledLEDsReference(leds, source, count, scale); }
+
+#else
+
+void scaleLEDs(CRGB* leds, uint16_t count, uint8_t scale)
+{
+    if (scale == 255) {
+        // scale8(x, 255) is exact, nothing to do
+        return;
+    }
+
+    uint8_t* bytes = (uint8_t*)leds;
+    uint32_t length = (uint32_t)count * 3;
+    uint16_t scale_plus_one = scale + 1;
+
+    uint32_t i = 0;
+    uint32_t head = min((uint32_t)bytesToAlignment(bytes), length);
+    for (; i < head; i++) {
+        bytes[i] = scale8(bytes[i], scale);
+    }
+    for (; i + 4 <= length; i += 4) {
+        led_word_t* word = (led_word_t*)(bytes + i);
+        *word = scaleWord(*word, scale_plus_one);
+    }
+    for (; i < length; i++) {
+        bytes[i] = scale8(bytes[i], scale);
+    }
+}
+
+void lerpLEDs(CRGB* leds, const CRGB* target, uint16_t count, fract8 amount)
+{
+    uint8_t* bytes = (uint8_t*)leds;
+    const uint8_t* target_bytes = (const uint8_t*)target;
+    uint32_t length = (uint32_t)count * 3;
+    uint16_t amount_plus_one = amount + 1;
+
+    // Word access needs both buffers to share the same alignment
+    uint32_t i = 0;
+    uint32_t head = length;
+    if (bytesToAlignment(bytes) == bytesToAlignment(target_bytes)) {
+        head = min((uint32_t)bytesToAlignment(bytes), length);
+    }
+    for (; i < head; i++) {
+        bytes[i] = lerp8by8(bytes[i], target_bytes[i], amount);
+    }
+    for (; i + 4 <= length; i += 4) {
+        led_word_t* word = (led_word_t*)(bytes + i);
+        *word = lerpWord(*word, *(const led_word_t*)(target_bytes + i), amount_plus_one);
+    }
+    for (; i < length; i++) {
+        bytes[i] = lerp8by8(bytes[i], target_bytes[i], amount);
+    }
+}
+
+void addLEDs(CRGB* leds, const CRGB* source, uint16_t count)
+{
+    uint8_t* bytes = (uint8_t*)leds;
+    const uint8_t* source_bytes = (const uint8_t*)source;
+    uint32_t length = (uint32_t)count * 3;
+
+    uint32_t i = 0;
+    uint32_t head = length;
+    if (bytesToAlignment(bytes) == bytesToAlignment(source_bytes)) {
+        head = min((uint32_t)bytesToAlignment(bytes), length);
+    }
+    for (; i < head; i++) {
+        bytes[i] = qadd8(bytes[i], source_bytes[i]);
+    }
+    for (; i + 4 <= length; i += 4) {
+        led_word_t* word = (led_word_t*)(bytes + i);
+        *word = addWord(*word, *(const led_word_t*)(source_bytes + i));
+    }
+    for (; i < length; i++) {
+        bytes[i] = qadd8(bytes[i], source_bytes[i]);
+    }
+}
+
+void addScaledLEDs(CRGB* leds, const CRGB* source, uint16_t count, uint8_t scale)
+{
+    uint8_t* bytes = (uint8_t*)leds;
+    const uint8_t* source_bytes = (const uint8_t*)source;
+    uint32_t length = (uint32_t)count * 3;
+    uint16_t scale_plus_one = scale + 1;
+
+    uint32_t i = 0;
+    uint32_t head = length;
+    if (bytesToAlignment(bytes) == bytesToAlignment(source_bytes)) {
+        head = min((uint32_t)bytesToAlignment(bytes), length);
+    }
+    for (; i < head; i++) {
+        bytes[i] = qadd8(bytes[i], scale8(source_bytes[i], scale));
+    }
+    for (; i + 4 <= length; i += 4) {
+        led_word_t* word = (led_word_t*)(bytes + i);
+        *word = addWord(*word, scaleWord(*(const led_word_t*)(source_bytes + i), scale_plus_one));
+    }
+    for (; i < length; i++) {
+        bytes[i] = qadd8(bytes[i], scale8(source_bytes[i], scale));
+    }
+}
+
+#endif
+
+#ifdef LED_KERNEL_BENCHMARK
+
+// Times each kernel against its per-pixel reference over every LED on the controller.
+// Enable with -DLED_KERNEL_BENCHMARK; runs once from setup() before the show starts, or on the
+// host from tools/benchmark.
+void runLEDKernelBenchmark()
+{
+    const uint8_t iterations = 50;
+    static CRGB source[488];
+    for (uint16_t i = 0; i < 488; i++) {
+        source[i] = CRGB(i * 7, i * 13, i * 29);
+    }
+
+    Serial.println("=== LED kernel benchmark (us per pass over all pins) ===");
+
+    unsigned long reference_time = 0;
+    unsigned long kernel_time = 0;
+
+#define BENCHMARK_KERNEL(name, reference_call, kernel_call)                                                            \
+    reference_time = 0;                                                                                                \
+    kernel_time = 0;                                                                                                   \
+    for (uint8_t n = 0; n < iterations; n++) {                                                                         \
+        for (uint8_t pin = 0; pin < 6; pin++) {                                                                        \
+            CRGB* leds = pin_configs[pin].led_array;                                                                   \
+            uint16_t count = pin_configs[pin].total_leds;                                                              \
+            unsigned long start = micros();                                                                            \
+            reference_call;                                                                                            \
+            reference_time += micros() - start;                                                                        \
+            start = micros();                                                                                          \
+            kernel_call;                                                                                               \
+            kernel_time += micros() - start;                                                                           \
+        }                                                                                                              \
+    }                                                                                                                  \
+    Serial.printf("%-12s reference %6lu  kernel %6lu\n", name, reference_time / iterations, kernel_time / iterations);
+
+    BENCHMARK_KERNEL("scale", scaleLEDsReference(leds, count, 200), scaleLEDs(leds, count, 200));
+    BENCHMARK_KERNEL("lerp", lerpLEDsReference(leds, source, count, 100), lerpLEDs(leds, source, count, 100));
+    BENCHMARK_KERNEL("add", addLEDsReference(leds, source, count), addLEDs(leds, source, count));
+    BENCHMARK_KERNEL("add scaled", addScaledLEDsReference(leds, source, count, 60),
+        addScaledLEDs(leds, source, count, 60));
+
+#undef BENCHMARK_KERNEL
+
+    for (uint8_t pin = 0; pin < 6; pin++) {
+        fill_solid(pin_configs[pin].led_array, pin_configs[pin].total_leds, CRGB::Black);
+    }
+}
+
+#endif
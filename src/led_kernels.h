@@ -0,0 +1,30 @@
+#ifndef LED_KERNELS_H
+#define LED_KERNELS_H
+
+#include <FastLED.h>
+
+// Bulk kernels over contiguous CRGB spans. Each one is bit-exact with the FastLED per-pixel
+// operation named next to it, but works on four channels per 32-bit operation.
+// Define LED_KERNELS_SCALAR to route everything through the per-pixel reference versions.
+
+void scaleLEDs(CRGB* leds, uint16_t count, uint8_t scale); // leds[i].nscale8(scale)
+void lerpLEDs(CRGB* leds, const CRGB* target, uint16_t count, fract8 amount); // leds[i] = leds[i].lerp8(target[i], amount)
+void addLEDs(CRGB* leds, const CRGB* source, uint16_t count); // leds[i] += source[i]
+void addScaledLEDs(CRGB* leds, const CRGB* source, uint16_t count, uint8_t scale); // leds[i] += CRGB(source[i]).nscale8(scale)
+
+inline void fadeLEDsToBlackBy(CRGB* leds, uint16_t count, uint8_t fade_amount)
+{
+    scaleLEDs(leds, count, 255 - fade_amount); // leds[i].fadeToBlackBy(fade_amount)
+}
+
+// Per-pixel FastLED reference implementations
+void scaleLEDsReference(CRGB* leds, uint16_t count, uint8_t scale);
+void lerpLEDsReference(CRGB* leds, const CRGB* target, uint16_t count, fract8 amount);
+void addLEDsReference(CRGB* leds, const CRGB* source, uint16_t count);
+void addScaledLEDsReference(CRGB* leds, const CRGB* source, uint16_t count, uint8_t scale);
+
+#ifdef LED_KERNEL_BENCHMARK
+void runLEDKernelBenchmark();
+#endif
+
+#endif
@@ -0,0 +1,19 @@
+#ifndef LED_LAYOUT_H
+#define LED_LAYOUT_H
+
+// Physical wiring of the installation: six data pins driving 22 strips of 122 LEDs
+#define NUM_PINS 6
+
+#define PIN1 13
+#define PIN2 5
+#define PIN3 19
+#define PIN4 23
+#define PIN5 18
+#define PIN6 12
+
+// Fill in strips[] from the pin buffers and build the LED coordinate map. Only problems are
+// printed, so the show can start straight away; printStripConfigs() prints the full layout
+void initializeStripConfigs();
+void printStripConfigs();
+
+#endif
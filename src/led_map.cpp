@@ -0,0 +1,95 @@
+#include "patterns.h"
+
+// Packed coordinate of every LED, indexed by strip and logical LED position
+static uint32_t led_coordinates[LOCAL_STRIP_COUNT * MAX_STRIP_LENGTH];
+
+// Distance of every LED from the center of the installation, 0-255 across the largest radius
+static uint8_t led_radius[LOCAL_STRIP_COUNT * MAX_STRIP_LENGTH];
+
+void buildLEDCoordinateMap()
+{
+    // Bounding box of all strips, so the fixed-point range covers the installation exactly. When
+    // the installation spans several controllers, every one maps against the same box instead
+    bool shared_bounds = false;
+    for (uint8_t axis = 0; axis < 3; axis++) {
+        if (installation_bounds.start_mm[axis] != installation_bounds.end_mm[axis])
+            shared_bounds = true;
+    }
+
+    const StripPlacement* boxes = shared_bounds ? &installation_bounds : strip_placements;
+    uint8_t box_count = shared_bounds ? 1 : LOCAL_STRIP_COUNT;
+    int16_t min_mm[3] = { INT16_MAX, INT16_MAX, INT16_MAX };
+    int16_t max_mm[3] = { INT16_MIN, INT16_MIN, INT16_MIN };
+    for (uint8_t box = 0; box < box_count; box++) {
+        const StripPlacement& placement = boxes[box];
+        for (uint8_t axis = 0; axis < 3; axis++) {
+            min_mm[axis] = min(min_mm[axis], min(placement.start_mm[axis], placement.end_mm[axis]));
+            max_mm[axis] = max(max_mm[axis], max(placement.start_mm[axis], placement.end_mm[axis]));
+        }
+    }
+
+    // One scale for all axes keeps the shape undistorted
+    int32_t extent = 1;
+    for (uint8_t axis = 0; axis < 3; axis++) {
+        extent = max(extent, (int32_t)max_mm[axis] - min_mm[axis]);
+    }
+
+    float center[3];
+    for (uint8_t axis = 0; axis < 3; axis++) {
+        center[axis] = ((int32_t)max_mm[axis] - min_mm[axis]) * (float)LED_COORD_MAX / extent / 2.0f;
+    }
+
+    // LEDs sit evenly between the strip's first and last LED. The radius table is 8 bits wide,
+    // so a first pass finds the largest radius to scale against. A shared box scales against its
+    // corners, which every controller agrees on.
+    float max_radius = 1.0f;
+    if (shared_bounds) {
+        float distance_squared = 0.0f;
+        for (uint8_t axis = 0; axis < 3; axis++) {
+            distance_squared += center[axis] * center[axis];
+        }
+        max_radius = max(max_radius, sqrtf(distance_squared));
+    }
+
+    for (uint8_t pass = shared_bounds ? 1 : 0; pass < 2; pass++) {
+        for (uint8_t strip_id = 0; strip_id < LOCAL_STRIP_COUNT; strip_id++) {
+            const StripPlacement& placement = strip_placements[strip_id];
+            uint16_t strip_length = min(getStripLength(strip_id), (uint16_t)MAX_STRIP_LENGTH);
+
+            for (uint16_t led = 0; led < strip_length; led++) {
+                float t = strip_length > 1 ? (float)led / (strip_length - 1) : 0.0f;
+                uint16_t coord[3];
+                float distance_squared = 0.0f;
+
+                for (uint8_t axis = 0; axis < 3; axis++) {
+                    float mm = placement.start_mm[axis] + (placement.end_mm[axis] - placement.start_mm[axis]) * t;
+                    float value = (mm - min_mm[axis]) * LED_COORD_MAX / extent;
+                    coord[axis] = (uint16_t)(value + 0.5f);
+                    distance_squared += (value - center[axis]) * (value - center[axis]);
+                }
+
+                uint16_t index = strip_id * MAX_STRIP_LENGTH + led;
+                float radius = sqrtf(distance_squared);
+                if (pass == 0) {
+                    // First pass only finds the largest radius
+                    max_radius = max(max_radius, radius);
+                } else {
+                    led_coordinates[index] = ((uint32_t)coord[0] << 20) | ((uint32_t)coord[1] << 10) | coord[2];
+                    led_radius[index] = (uint8_t)(radius * 255.0f / max_radius + 0.5f);
+                }
+            }
+        }
+    }
+
+    Serial.printf("LED coordinate map built: extent %ld mm\n", (long)extent);
+}
+
+uint32_t getLEDCoordinate(uint8_t strip_id, uint16_t led_index)
+{
+    return led_coordinates[strip_id * MAX_STRIP_LENGTH + led_index];
+}
+
+uint8_t getLEDRadius(uint8_t strip_id, uint16_t led_index)
+{
+    return led_radius[strip_id * MAX_STRIP_LENGTH + led_index];
+}
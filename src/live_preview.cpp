@@ -0,0 +1,244 @@
+#include "live_preview.h"
+#include "patterns.h"
+#include <string.h>
+
+static PreviewClient preview_clients[PREVIEW_MAX_CLIENTS];
+
+// Every strip averaged into PREVIEW_MAX_BLOCKS blocks at the last show a client was waiting for
+static uint8_t preview_snapshot[PREVIEW_MAX_BLOCK_COUNT * 3];
+static uint32_t snapshot_count = 0;
+static uint32_t last_snapshot[PREVIEW_MAX_CLIENTS]; // snapshot_count each client last got
+static uint32_t preview_bytes_sent = 0;
+
+static uint16_t packPreviewConfig(uint8_t fps, uint8_t blocks)
+{
+    return ((uint16_t)fps << 8) | blocks;
+}
+
+bool addPreviewClient(uint32_t id)
+{
+    for (uint8_t slot = 0; slot < PREVIEW_MAX_CLIENTS; slot++) {
+        uint32_t expected = 0;
+        if (preview_clients[slot].id.compare_exchange_strong(expected, id)) {
+            preview_clients[slot].requested = packPreviewConfig(PREVIEW_DEFAULT_FPS, PREVIEW_DEFAULT_BLOCKS);
+            return true;
+        }
+    }
+    return false;
+}
+
+void removePreviewClient(uint32_t id)
+{
+    for (uint8_t slot = 0; slot < PREVIEW_MAX_CLIENTS; slot++) {
+        uint32_t expected = id;
+        preview_clients[slot].id.compare_exchange_strong(expected, 0);
+    }
+}
+
+// fps is clamped to 1-PREVIEW_MAX_FPS and blocks rounded down to a power of two no finer than
+// PREVIEW_MAX_BLOCKS, so client blocks always cover whole snapshot blocks
+bool configurePreviewClient(uint32_t id, uint8_t fps, uint8_t blocks)
+{
+    fps = min(max(fps, (uint8_t)1), (uint8_t)PREVIEW_MAX_FPS);
+    uint8_t rounded = 1;
+    while (rounded * 2 <= blocks && rounded < PREVIEW_MAX_BLOCKS) {
+        rounded *= 2;
+    }
+
+    for (uint8_t slot = 0; slot < PREVIEW_MAX_CLIENTS; slot++) {
+        if (preview_clients[slot].id == id) {
+            preview_clients[slot].requested = packPreviewConfig(fps, rounded);
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool isPreviewClientDue(uint8_t slot)
+{
+    const PreviewClient& client = preview_clients[slot];
+    uint32_t id = client.id;
+    if (id == 0)
+        return false;
+
+    // A client that has only just claimed the slot may not have its settings stored yet
+    uint16_t requested = client.requested;
+    if ((requested >> 8) == 0)
+        return false;
+
+    // Newly connected or reconfigured clients get a keyframe straight away
+    if (client.sent_id != id || client.config != requested)
+        return true;
+    return current_time - client.last_send >= 1000UL / (requested >> 8);
+}
+
+// Called right after FastLED.show(), while the buffers still hold the shown frame with every effect
+// on it. Averages it into the snapshot only when some client is waiting for a frame
+void capturePreviewFrame()
+{
+    bool wanted = false;
+    for (uint8_t slot = 0; slot < PREVIEW_MAX_CLIENTS && !wanted; slot++) {
+        wanted = isPreviewClientDue(slot);
+    }
+    if (!wanted)
+        return;
+
+    uint8_t* block = preview_snapshot;
+    for (uint8_t strip_id = 0; strip_id < PREVIEW_STRIPS; strip_id++) {
+        const StripConfig& strip = strips[strip_id];
+        const CRGB* leds = strip.led_array_ptr + strip.start_offset;
+
+        for (uint8_t b = 0; b < PREVIEW_MAX_BLOCKS; b++) {
+            // Logical LEDs [first, last) of this block; a reversed strip holds them mirrored
+            uint16_t first = (uint32_t)b * strip.length / PREVIEW_MAX_BLOCKS;
+            uint16_t last = (uint32_t)(b + 1) * strip.length / PREVIEW_MAX_BLOCKS;
+            if (strip.reverse_direction) {
+                uint16_t mirrored_first = strip.length - last;
+                last = strip.length - first;
+                first = mirrored_first;
+            }
+
+            uint32_t sum[3] = { 0, 0, 0 };
+            for (uint16_t i = first; i < last; i++) {
+                sum[0] += leds[i].r;
+                sum[1] += leds[i].g;
+                sum[2] += leds[i].b;
+            }
+            uint16_t count = max(last - first, 1);
+            *block++ = sum[0] / count;
+            *block++ = sum[1] / count;
+            *block++ = sum[2] / count;
+        }
+    }
+    snapshot_count++;
+}
+
+// Client id when slot has a new snapshot it hasn't been sent and is due a frame, otherwise 0
+uint32_t getDuePreviewClient(uint8_t slot)
+{
+    if (slot >= PREVIEW_MAX_CLIENTS || snapshot_count == 0 || last_snapshot[slot] == snapshot_count
+        || !isPreviewClientDue(slot))
+        return 0;
+    return preview_clients[slot].id;
+}
+
+// Skip this frame for a backed-up client. Its reference still matches what it last received, so
+// the next frame it does get is a correct delta
+void dropPreviewFrame(uint8_t slot)
+{
+    PreviewClient& client = preview_clients[slot];
+    client.frames_dropped++;
+    client.last_send = current_time;
+    last_snapshot[slot] = snapshot_count;
+}
+
+// Encode the latest snapshot for slot's client into out (PREVIEW_MAX_FRAME_SIZE bytes). Returns the
+// message length, or 0 when nothing changed since its last frame
+size_t encodePreviewFrame(uint8_t slot, uint8_t* out)
+{
+    PreviewClient& client = preview_clients[slot];
+    uint32_t id = client.id;
+    uint16_t requested = client.requested;
+    bool keyframe = client.sent_id != id || client.config != requested;
+    uint8_t blocks = requested & 0xFF;
+
+    // Average groups of snapshot blocks down to the client's resolution
+    static uint8_t frame[PREVIEW_MAX_BLOCK_COUNT * 3];
+    uint8_t group = PREVIEW_MAX_BLOCKS / blocks;
+    uint16_t block_count = PREVIEW_STRIPS * blocks;
+    for (uint16_t i = 0; i < block_count; i++) {
+        const uint8_t* source = preview_snapshot + i * group * 3;
+        for (uint8_t channel = 0; channel < 3; channel++) {
+            uint16_t sum = 0;
+            for (uint8_t g = 0; g < group; g++) {
+                sum += source[g * 3 + channel];
+            }
+            frame[i * 3 + channel] = sum / group;
+        }
+    }
+
+    out[0] = keyframe ? PREVIEW_FRAME_KEY : PREVIEW_FRAME_DELTA;
+    out[1] = PREVIEW_STRIPS;
+    out[2] = blocks;
+    size_t length = encodePreviewBlocks(frame, client.reference, block_count, keyframe, out + PREVIEW_HEADER_SIZE);
+
+    client.sent_id = id;
+    client.config = requested;
+    client.last_send = current_time;
+    last_snapshot[slot] = snapshot_count;
+    if (length == 0)
+        return 0;
+
+    client.frames_sent++;
+    preview_bytes_sent += PREVIEW_HEADER_SIZE + length;
+    return PREVIEW_HEADER_SIZE + length;
+}
+
+static bool sameColor(const uint8_t* a, const uint8_t* b)
+{
+    return a[0] == b[0] && a[1] == b[1] && a[2] == b[2];
+}
+
+// Encode frame as ops against reference (ignored for a keyframe), then make it the new reference.
+// Returns the op bytes written to out, 0 when no block changed
+size_t encodePreviewBlocks(const uint8_t* frame, uint8_t* reference, uint16_t block_count, bool keyframe, uint8_t* out)
+{
+    // Unchanged blocks at the end need no ops at all
+    uint16_t end = block_count;
+    if (!keyframe) {
+        while (end > 0 && sameColor(frame + (end - 1) * 3, reference + (end - 1) * 3)) {
+            end--;
+        }
+    }
+
+    size_t length = 0;
+    uint16_t i = 0;
+    while (i < end) {
+        const uint8_t* color = frame + i * 3;
+        uint16_t run = 1;
+
+        if (!keyframe && sameColor(color, reference + i * 3)) {
+            while (i + run < end && run < PREVIEW_OP_MAX_COUNT
+                && sameColor(frame + (i + run) * 3, reference + (i + run) * 3)) {
+                run++;
+            }
+            out[length++] = PREVIEW_OP_SKIP | (run - 1);
+        } else {
+            while (i + run < end && run < PREVIEW_OP_MAX_COUNT && sameColor(frame + (i + run) * 3, color)) {
+                run++;
+            }
+
+            if (run > 1) {
+                out[length++] = PREVIEW_OP_REPEAT | (run - 1);
+                memcpy(out + length, color, 3);
+                length += 3;
+            } else {
+                // Literal up to the next unchanged block or the start of a repeat
+                while (i + run < end && run < PREVIEW_OP_MAX_COUNT
+                    && (keyframe || !sameColor(frame + (i + run) * 3, reference + (i + run) * 3))
+                    && (i + run + 1 >= end || !sameColor(frame + (i + run) * 3, frame + (i + run + 1) * 3))) {
+                    run++;
+                }
+                out[length++] = PREVIEW_OP_LITERAL | (run - 1);
+                memcpy(out + length, color, run * 3);
+                length += run * 3;
+            }
+        }
+        i += run;
+    }
+
+    memcpy(reference, frame, block_count * 3);
+    return length;
+}
+
+void getPreviewStats(PreviewStats& stats)
+{
+    stats = PreviewStats();
+    for (uint8_t slot = 0; slot < PREVIEW_MAX_CLIENTS; slot++) {
+        if (preview_clients[slot].id != 0)
+            stats.clients++;
+        stats.frames_sent += preview_clients[slot].frames_sent;
+        stats.frames_dropped += preview_clients[slot].frames_dropped;
+    }
+    stats.bytes_sent = preview_bytes_sent;
+}
@@ -0,0 +1,76 @@
+#ifndef LIVE_PREVIEW_H
+#define LIVE_PREVIEW_H
+
+#include "installation.h"
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+// Reduced live view of this controller's strips for browser clients. Each strip is averaged down to a few
+// blocks, frames go out at a low per-client rate, and each frame is encoded against the last one
+// that client was sent, so unchanged blocks cost almost nothing on the soft-AP link.
+//
+// Frame format (binary WebSocket message):
+//   byte 0    PREVIEW_FRAME_KEY (every block present) or PREVIEW_FRAME_DELTA (changes only)
+//   byte 1    strip count (LOCAL_STRIP_COUNT)
+//   byte 2    blocks per strip
+//   then ops over the blocks, strip 0 first, each strip in logical LED order. An op byte's top two
+//   bits are the op and its low six bits are count - 1 (1-64 blocks):
+//   PREVIEW_OP_SKIP     blocks unchanged since the last frame
+//   PREVIEW_OP_LITERAL  followed by count RGB triples
+//   PREVIEW_OP_REPEAT   followed by one RGB triple shared by count blocks
+//   Blocks after the last op are unchanged.
+#define PREVIEW_MAX_CLIENTS 4
+#define PREVIEW_MAX_BLOCKS 32 // Blocks per strip at the finest resolution (powers of two up to this)
+#define PREVIEW_DEFAULT_BLOCKS 8
+#define PREVIEW_DEFAULT_FPS 5
+#define PREVIEW_MAX_FPS 20
+#define PREVIEW_STRIPS LOCAL_STRIP_COUNT
+#define PREVIEW_MAX_BLOCK_COUNT (PREVIEW_STRIPS * PREVIEW_MAX_BLOCKS)
+#define PREVIEW_HEADER_SIZE 3
+#define PREVIEW_MAX_FRAME_SIZE (PREVIEW_HEADER_SIZE + PREVIEW_MAX_BLOCK_COUNT * 4) // Worst case: all literals and skips
+
+#define PREVIEW_FRAME_KEY 1
+#define PREVIEW_FRAME_DELTA 2
+
+#define PREVIEW_OP_SKIP 0x00
+#define PREVIEW_OP_LITERAL 0x40
+#define PREVIEW_OP_REPEAT 0x80
+#define PREVIEW_OP_MAX_COUNT 64
+
+struct PreviewClient {
+    // Written by the web server task when a client connects, configures itself or leaves
+    std::atomic<uint32_t> id; // Socket client id, 0 = free slot
+    std::atomic<uint16_t> requested; // fps << 8 | blocks per strip
+
+    // Owned by the render loop
+    uint32_t sent_id; // Client the reference frame belongs to
+    uint16_t config; // requested value the reference frame was encoded at
+    unsigned long last_send;
+    uint32_t frames_sent;
+    uint32_t frames_dropped; // Frames skipped because the client's socket was backed up
+    uint8_t reference[PREVIEW_MAX_BLOCK_COUNT * 3]; // What the client is currently showing
+};
+
+struct PreviewStats {
+    uint8_t clients;
+    uint32_t frames_sent;
+    uint32_t frames_dropped;
+    uint32_t bytes_sent;
+};
+
+// Web server task side
+bool addPreviewClient(uint32_t id);
+void removePreviewClient(uint32_t id);
+bool configurePreviewClient(uint32_t id, uint8_t fps, uint8_t blocks);
+
+// Render loop side
+void capturePreviewFrame();
+uint32_t getDuePreviewClient(uint8_t slot);
+void dropPreviewFrame(uint8_t slot);
+size_t encodePreviewFrame(uint8_t slot, uint8_t* out);
+void getPreviewStats(PreviewStats& stats);
+
+size_t encodePreviewBlocks(const uint8_t* frame, uint8_t* reference, uint16_t block_count, bool keyframe, uint8_t* out);
+
+#endif
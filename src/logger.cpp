@@ -0,0 +1,138 @@
+#include "logger.h"
+#include <Arduino.h>
+#include <atomic>
+#include <stdarg.h>
+#include <stdio.h>
+
+struct LogEntry {
+    std::atomic<bool> ready; // Set by the producer once the text is complete
+    uint8_t length;
+    char text[LOG_ENTRY_SIZE];
+};
+
+// Producers claim slots by advancing log_head; drainLog() is the only consumer and owns log_tail.
+// Both only ever increase, so head - tail is the number of claimed slots.
+static LogEntry log_entries[LOG_ENTRIES];
+static std::atomic<uint32_t> log_head(0);
+static std::atomic<uint32_t> log_tail(0);
+static uint8_t drain_offset = 0; // Bytes of the tail entry already sent
+
+static std::atomic<uint32_t> log_written(0);
+static std::atomic<uint32_t> log_dropped_full(0);
+static std::atomic<uint32_t> log_dropped_rate(0);
+static uint32_t reported_drops = 0;
+
+// Token bucket for INFO and DEBUG, refilled at LOG_RATE_LIMIT tokens per second (in thousandths
+// of a token). Nearly all logging happens on the loop task, so it is not synchronised; a race
+// with another task only makes the limit slightly approximate.
+static int32_t rate_tokens = LOG_RATE_BURST * 1000;
+static unsigned long rate_refill_time = 0;
+
+static const char level_letters[] = { '-', 'E', 'W', 'I', 'D' };
+
+static bool takeRateToken()
+{
+    // Any gap long enough to refill the bucket leaves it full; multiplying a longer one (hours
+    // without INFO logging) would overflow the token count
+    unsigned long now = millis();
+    unsigned long elapsed = now - rate_refill_time;
+    rate_refill_time = now;
+    if (elapsed >= LOG_RATE_BURST * 1000UL / LOG_RATE_LIMIT) {
+        rate_tokens = LOG_RATE_BURST * 1000;
+    } else {
+        rate_tokens = min(rate_tokens + (int32_t)(elapsed * LOG_RATE_LIMIT), (int32_t)(LOG_RATE_BURST * 1000));
+    }
+
+    if (rate_tokens < 1000)
+        return false;
+    rate_tokens -= 1000;
+    return true;
+}
+
+static void writeEntryV(uint8_t level, const char* format, va_list args)
+{
+    // Claim a slot unless the consumer is a full ring behind
+    uint32_t head = log_head.load(std::memory_order_relaxed);
+    do {
+        if (head - log_tail.load(std::memory_order_acquire) >= LOG_ENTRIES) {
+            log_dropped_full.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+    } while (!log_head.compare_exchange_weak(head, head + 1, std::memory_order_acquire, std::memory_order_relaxed));
+
+    LogEntry& entry = log_entries[head & (LOG_ENTRIES - 1)];
+    int prefix = snprintf(entry.text, LOG_ENTRY_SIZE, "[%lu] %c ", (unsigned long)millis(), level_letters[level]);
+    int body = vsnprintf(entry.text + prefix, LOG_ENTRY_SIZE - prefix - 1, format, args);
+
+    // Truncated lines keep their newline
+    size_t length = prefix + (body < 0 ? 0 : min(body, LOG_ENTRY_SIZE - prefix - 2));
+    entry.text[length++] = '\n';
+    entry.length = length;
+
+    entry.ready.store(true, std::memory_order_release);
+    log_written.fetch_add(1, std::memory_order_relaxed);
+}
+
+void logMessage(uint8_t level, const char* format, ...)
+{
+    // Bursts of routine messages are thinned; warnings and errors are only dropped when full
+    if (level >= LOG_LEVEL_INFO && !takeRateToken()) {
+        log_dropped_rate.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    va_list args;
+    va_start(args, format);
+    writeEntryV(level, format, args);
+    va_end(args);
+}
+
+static void writeEntry(uint8_t level, const char* format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    writeEntryV(level, format, args);
+    va_end(args);
+}
+
+// Send as much of the ring as the UART can take without blocking. Call from loop() once the
+// frame has been shown.
+void drainLog()
+{
+    // Report drops since the last summary so gaps in the log are visible
+    uint32_t dropped = log_dropped_full.load(std::memory_order_relaxed) + log_dropped_rate.load(std::memory_order_relaxed);
+    uint32_t tail = log_tail.load(std::memory_order_relaxed);
+    if (dropped != reported_drops && log_head.load(std::memory_order_relaxed) - tail < LOG_ENTRIES) {
+        writeEntry(LOG_LEVEL_WARN, "Log: dropped %lu messages", (unsigned long)(dropped - reported_drops));
+        reported_drops = dropped;
+    }
+
+    while (tail != log_head.load(std::memory_order_relaxed)) {
+        LogEntry& entry = log_entries[tail & (LOG_ENTRIES - 1)];
+        if (!entry.ready.load(std::memory_order_acquire))
+            return; // Still being written by its producer
+
+        int space = Serial.availableForWrite();
+        if (space <= 0)
+            return;
+
+        size_t chunk = min((size_t)space, (size_t)(entry.length - drain_offset));
+        Serial.write((const uint8_t*)entry.text + drain_offset, chunk);
+        drain_offset += chunk;
+        if (drain_offset < entry.length)
+            return; // UART buffer is full, continue next frame
+
+        // Free the slot only after its text has been copied out
+        drain_offset = 0;
+        entry.ready.store(false, std::memory_order_relaxed);
+        tail++;
+        log_tail.store(tail, std::memory_order_release);
+    }
+}
+
+void getLogStats(LogStats& stats)
+{
+    stats.written = log_written.load(std::memory_order_relaxed);
+    stats.dropped_full = log_dropped_full.load(std::memory_order_relaxed);
+    stats.dropped_rate = log_dropped_rate.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,60 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <stdint.h>
+
+// Leveled logging for the render loop. Messages are formatted into a fixed ring of line slots
+// and written to Serial later by drainLog(), a few bytes at a time so the UART never blocks the
+// frame. When the ring is full, or a burst exceeds the rate limit, messages are dropped and
+// counted instead.
+#define LOG_LEVEL_NONE 0
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_WARN 2
+#define LOG_LEVEL_INFO 3
+#define LOG_LEVEL_DEBUG 4
+
+// Messages above this level compile to nothing
+#ifndef LOG_LEVEL
+#define LOG_LEVEL LOG_LEVEL_INFO
+#endif
+
+#define LOG_ENTRY_SIZE 96 // Longer lines are truncated
+#define LOG_ENTRIES 32 // Must be a power of two
+#define LOG_RATE_LIMIT 10 // INFO and DEBUG lines per second once the burst allowance is spent
+#define LOG_RATE_BURST (LOG_ENTRIES / 2) // Leaves half the ring for warnings and errors
+
+struct LogStats {
+    uint32_t written;
+    uint32_t dropped_full;
+    uint32_t dropped_rate;
+};
+
+void logMessage(uint8_t level, const char* format, ...) __attribute__((format(printf, 2, 3)));
+void drainLog();
+void getLogStats(LogStats& stats);
+
+#if LOG_LEVEL >= LOG_LEVEL_ERROR
+#define LOG_ERROR(...) logMessage(LOG_LEVEL_ERROR, __VA_ARGS__)
+#else
+#define LOG_ERROR(...) ((void)0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_WARN
+#define LOG_WARN(...) logMessage(LOG_LEVEL_WARN, __VA_ARGS__)
+#else
+#define LOG_WARN(...) ((void)0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_INFO
+#define LOG_INFO(...) logMessage(LOG_LEVEL_INFO, __VA_ARGS__)
+#else
+#define LOG_INFO(...) ((void)0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(...) logMessage(LOG_LEVEL_DEBUG, __VA_ARGS__)
+#else
+#define LOG_DEBUG(...) ((void)0)
+#endif
+
+#endif
@@ -1,4 +1,21 @@
+#include "effect_queue.h"
+#include "frame_recorder.h"
+#include "frame_watchdog.h"
+#include "latency_trace.h"
+#include "led_kernels.h"
+#include "led_layout.h"
+#include "live_preview.h"
+#include "logger.h"
+#include "output_stage.h"
 #include "patterns.h"
+#include "profiler.h"
+#include "sensor_config.h"
+#include "show_checkpoint.h"
+#include "show_clock.h"
+#include "show_runner.h"
+#include "stream_input.h"
+#include "telemetry.h"
+#include "web_assets.h"
 #include <Arduino.h>
 #include <Arduino_JSON.h>
 #include <AsyncTCP.h>
@@ -6,47 +23,10 @@
 #include <FastLED.h>
 #include <WebSocketsServer.h>
 #include <WiFi.h>
+#include <atomic>
 
-#define BRIGHTNESS 255
 #define LED_TYPE WS2812B
 #define COLOR_ORDER GRB
-#define NUM_PINS 6
-
-#define PIN1 13
-#define PIN2 5
-#define PIN3 19
-#define PIN4 23
-#define PIN5 18
-#define PIN6 12
-
-// LED arrays for each pin
-CRGB pin1_leds[366];
-CRGB pin2_leds[488];
-CRGB pin3_leds[488];
-CRGB pin4_leds[366];
-CRGB pin5_leds[488];
-CRGB pin6_leds[488];
-
-// Pin configuration for FastLED setup (still needed for FastLED.addLeds calls)
-PinConfig pin_configs[NUM_PINS]
-    = { { PIN1, 3, 122, 366, pin1_leds }, { PIN2, 4, 122, 488, pin2_leds }, { PIN3, 4, 122, 488, pin3_leds },
-          { PIN4, 3, 122, 366, pin4_leds }, { PIN5, 4, 122, 488, pin5_leds }, { PIN6, 4, 122, 488, pin6_leds } };
-
-// Configure which strips should be reversed (can be modified as needed)
-// Example configuration - modify these values to change strip directions
-bool strip_reverse_config[22] = {
-    false, false, false, // Pin 1:
-    false, false, false, false, // Pin 2:
-    false, false, false, false, // Pin 3:
-    false, false, false, // Pin 4:
-    false, false, false, false, // Pin 5:
-    false, false, false, false // Pin 6:
-};
-
-// New unified strip configuration (CRGBSets will be initialized in initializeStripConfigs())
-StripConfig strips[22];
-
-unsigned long current_time;
 
 // WiFi and WebSocket configuration
 const char* ssid = "ReflectingThePresent";
@@ -54,53 +34,73 @@ const char* password = "lightshow2024";
 
 AsyncWebServer server(80);
 WebSocketsServer webSocket = WebSocketsServer(81);
-
-// Sensor ID to LED strip mapping
-#define MAX_SENSORS 8
-#define MAX_STRIPS_PER_SENSOR 4
-
-struct SensorMapping {
-    uint8_t sensor_id;
-    uint8_t led_strips[MAX_STRIPS_PER_SENSOR];
-    uint8_t num_strips;
-    bool active;
-    unsigned long last_trigger_time;
-};
-
-SensorMapping sensor_mappings[MAX_SENSORS] = {
-    // Add your sensor mappings here manually
-    { 1, { 0 }, 1, true, 0 }, // Sensor 1
-    { 2, { 1 }, 1, true, 0 }, // Sensor 2
-    { 3, { 2 }, 1, false, 0 }, // Sensor 3
-    { 4, { 3, 4, 5, 6 }, 4, false, 0 }, // Sensor 4
-    { 5, { 7, 8, 9, 10 }, 4, true, 0 }, // Sensor 5
-    { 6, { 11 }, 1, true, 0 }, // Sensor 6
-    { 7, { 12 }, 1, true, 0 }, // Sensor 7
-    { 8, { 13 }, 1, true, 0 }, // Sensor 8
-    // Add more mappings as needed
-};
+// Live preview runs on the async server so a slow client queues up there instead of blocking loop()
+AsyncWebSocket preview_socket("/preview");
+
+// Frame time of the last frame rendered; each slot on the frame grid is rendered once
+unsigned long last_frame_time = 0;
+bool frame_rendered = false;
+
+// WebSocket clients that asked for the stats stream, one bit per client number
+uint32_t stats_subscribers = 0;
+unsigned long last_stats_push = 0;
+
+// Stats JSON, rebuilt by the render loop every STATS_STREAM_INTERVAL so the web server task never
+// reads counters while loop() writes them. Two buffers, like the /mappings document below
+char stats_documents[2][STATS_BUFFER_SIZE];
+size_t stats_lengths[2]; // 0 when the document didn't fit
+std::atomic<uint8_t> stats_current(0);
+std::atomic<uint8_t> stats_readers[2]; // /stats responses still sending from each buffer
+
+// /mappings JSON, rebuilt by the render loop only when the sensor config changes. There are two
+// buffers, and one isn't rebuilt while a response is still being sent from it. Sized for every
+// sensor in the table mapped to every strip, with each field at its widest
+#define MAPPINGS_ENTRY_SIZE (96 + 3 * SENSOR_STRIP_COUNT)
+#define MAPPINGS_BUFFER_SIZE (64 + SENSOR_TABLE_SIZE * MAPPINGS_ENTRY_SIZE)
+char mappings_documents[2][MAPPINGS_BUFFER_SIZE];
+size_t mappings_lengths[2]; // 0 when the document didn't fit
+char mappings_etags[2][16];
+std::atomic<uint8_t> mappings_current(0);
+std::atomic<uint8_t> mappings_readers[2]; // /mappings responses still sending from each buffer
+uint32_t mappings_version = 0; // sensor_config_version the published document was built from
 
 // Function declarations
-void initializeStripConfigs();
 void handleSensorMessage(String message);
+bool handleStatsSubscription(uint8_t num, const char* message);
+bool handleSensorConfigMessage(uint8_t num, const char* message);
+bool handleOutputSettingsMessage(uint8_t num, const char* message);
+void writeStatsJson(StatsWriter& writer);
+bool updateStatsDocument();
+void streamStats();
+void streamPreview();
+void updateMappingsDocument();
+void sendCachedResponse(AsyncWebServerRequest* request, const char* content_type, const uint8_t* data, size_t length,
+    const char* etag, bool gzipped);
+uint8_t holdPublishedBuffer(
+    AsyncWebServerRequest* request, std::atomic<uint8_t>& published, std::atomic<uint8_t>* readers);
 void setupWiFiAndWebSocket();
+void runFrameIfDue();
 
 // WebSocket event handler
 void webSocketEvent(uint8_t num, WStype_t type, uint8_t* payload, size_t length)
 {
     switch (type) {
     case WStype_DISCONNECTED:
-        Serial.printf("[%u] Disconnected!\n", num);
+        LOG_INFO("[%u] Disconnected!", num);
+        stats_subscribers &= ~(1UL << num);
         break;
 
     case WStype_CONNECTED: {
         IPAddress ip = webSocket.remoteIP(num);
-        Serial.printf("[%u] Connected from %d.%d.%d.%d url: %s\n", num, ip[0], ip[1], ip[2], ip[3], payload);
+        LOG_INFO("[%u] Connected from %d.%d.%d.%d url: %s", num, ip[0], ip[1], ip[2], ip[3], payload);
     } break;
 
     case WStype_TEXT:
-        Serial.printf("[%u] Received: %s\n", num, payload);
-        handleSensorMessage((char*)payload);
+        LOG_DEBUG("[%u] Received: %s", num, payload);
+        if (!handleStatsSubscription(num, (char*)payload) && !handleSensorConfigMessage(num, (char*)payload)
+            && !handleOutputSettingsMessage(num, (char*)payload)) {
+            handleSensorMessage((char*)payload);
+        }
         break;
 
     default:
@@ -111,118 +111,533 @@ void webSocketEvent(uint8_t num, WStype_t type, uint8_t* payload, size_t length)
 // Handle incoming sensor messages
 void handleSensorMessage(String message)
 {
+    uint32_t receive_us = micros();
     JSONVar json = JSON.parse(message);
 
     if (JSON.typeof(json) == "undefined") {
-        Serial.println("Failed to parse JSON");
+        LOG_WARN("Failed to parse JSON");
         return;
     }
 
     if (json.hasOwnProperty("sensorId") && json.hasOwnProperty("timestamp")) {
         int sensor_id = (int)json["sensorId"];
-        unsigned long timestamp = (unsigned long)json["timestamp"];
-
-        Serial.print("Sensor message received - ID: ");
-        Serial.print(sensor_id);
-        Serial.print(", Timestamp: ");
-        Serial.println(timestamp);
-
-        // Find the sensor mapping
-        for (uint8_t i = 0; i < MAX_SENSORS; i++) {
-            if (sensor_mappings[i].active && sensor_mappings[i].sensor_id == sensor_id) {
-                // Check if enough time has passed since last trigger (15 seconds = 15000ms)
-                unsigned long time_since_last = current_time - sensor_mappings[i].last_trigger_time;
-
-                if (sensor_mappings[i].last_trigger_time == 0 || time_since_last >= 15000) {
-                    // Update last trigger time
-                    sensor_mappings[i].last_trigger_time = current_time;
-
-                    // Trigger FlashBulb on mapped strips
-                    addFlashBulbPattern(sensor_mappings[i].led_strips, sensor_mappings[i].num_strips);
-                    uint8_t pattern_index = flashbulb_manager.pattern_count - 1;
-                    triggerFlashBulb(pattern_index);
-
-                    Serial.print("FlashBulb triggered on ");
-                    Serial.print(sensor_mappings[i].num_strips);
-                    Serial.print(" strips: ");
-                    for (uint8_t j = 0; j < sensor_mappings[i].num_strips; j++) {
-                        Serial.print(sensor_mappings[i].led_strips[j]);
-                        if (j < sensor_mappings[i].num_strips - 1)
-                            Serial.print(", ");
-                    }
-                    Serial.println();
-                } else {
-                    // Too soon since last trigger
-                    unsigned long wait_time = 15000 - time_since_last;
-                    Serial.print("Sensor ");
-                    Serial.print(sensor_id);
-                    Serial.print(" trigger ignored - wait ");
-                    Serial.print(wait_time / 1000);
-                    Serial.println(" more seconds");
-                }
-
-                break;
+        // Millisecond timestamps overflow an int, so read the full double and keep the low 32 bits
+        unsigned long timestamp = (unsigned long)(uint64_t)(double)json["timestamp"];
+        LatencyTrace trace = beginLatencyTrace(timestamp, receive_us);
+
+        LOG_DEBUG("Sensor message received - ID: %d, Timestamp: %lu", sensor_id, timestamp);
+
+        if (sensor_id >= 0 && sensor_id <= 255) {
+            recordSensorEvent(sensor_id);
+        }
+        triggerSensor(sensor_id, &trace);
+    }
+}
+
+// {"stats": true} subscribes the sending client to the stats stream, {"stats": false} stops it.
+// Returns false for anything else so the message can be handled as a sensor event.
+bool handleStatsSubscription(uint8_t num, const char* message)
+{
+    // Sensor messages never mention stats, so skip the JSON parse for them
+    if (strstr(message, "\"stats\"") == NULL || num >= 32)
+        return false;
+
+    JSONVar json = JSON.parse(message);
+    if (JSON.typeof(json) != "object" || !json.hasOwnProperty("stats"))
+        return false;
+
+    if ((bool)json["stats"]) {
+        stats_subscribers |= 1UL << num;
+        LOG_INFO("[%u] Subscribed to stats", num);
+    } else {
+        stats_subscribers &= ~(1UL << num);
+        LOG_INFO("[%u] Unsubscribed from stats", num);
+    }
+    return true;
+}
+
+// Apply the fields present in request on top of the sensor's current config. Returns an error
+// message, or NULL once the change is stored
+const char* applySensorConfig(int sensor_id, JSONVar& request)
+{
+    if (sensor_id < 0 || sensor_id >= SENSOR_TABLE_SIZE)
+        return "id out of range";
+
+    SensorConfig config = sensor_mappings[sensor_id].config;
+    if (config.strip_mask == 0) {
+        // New sensor: start from the defaults every other field would have
+        config.cooldown_ms = DEFAULT_SENSOR_COOLDOWN;
+        config.active = true;
+    }
+
+    if (request.hasOwnProperty("strips")) {
+        JSONVar strips = request["strips"];
+        config.strip_mask = 0;
+        for (int i = 0; i < strips.length(); i++) {
+            int strip = (int)strips[i];
+            if (strip < 0 || strip >= SENSOR_STRIP_COUNT)
+                return "strip out of range";
+            config.strip_mask |= 1ULL << strip;
+        }
+    }
+
+    if (request.hasOwnProperty("effect")) {
+        const char* name = (const char*)request["effect"];
+        uint8_t effect = 0;
+        while (effect < SENSOR_EFFECT_COUNT && strcmp(name, getSensorEffectName(effect)) != 0) {
+            effect++;
+        }
+        if (effect == SENSOR_EFFECT_COUNT)
+            return "unknown effect";
+        config.effect = effect;
+    }
+
+    if (request.hasOwnProperty("envelope")) {
+        int envelope_index = (int)request["envelope"];
+        if (envelope_index < 0 || envelope_index >= flashbulb_manager.envelope_count)
+            return "unknown envelope";
+        config.envelope_index = envelope_index;
+    }
+
+    if (request.hasOwnProperty("cooldown")) {
+        double cooldown_ms = (double)request["cooldown"];
+        if (cooldown_ms < 0 || cooldown_ms > 3600000)
+            return "cooldown out of range";
+        config.cooldown_ms = (uint32_t)cooldown_ms;
+    }
+
+    if (request.hasOwnProperty("active")) {
+        config.active = (bool)request["active"];
+    }
+
+    if (!setSensorConfig(sensor_id, config))
+        return "invalid config";
+    return NULL;
+}
+
+// {"sensorConfig": {"id": 5, "strips": [7, 8], "effect": "ripple", "envelope": 1, "cooldown": 15000,
+// "active": true}} edits one sensor, keeping the current value of any field left out.
+// {"sensorConfig": "defaults"} restores the built-in table. The sender gets back
+// {"sensorConfig": {"ok": ..., "id": ..., "version": ...}} with an "error" when it failed.
+// Returns false for anything else so the message can be handled as a sensor event.
+bool handleSensorConfigMessage(uint8_t num, const char* message)
+{
+    // Sensor messages never mention the config, so skip the JSON parse for them
+    if (strstr(message, "\"sensorConfig\"") == NULL)
+        return false;
+
+    JSONVar json = JSON.parse(message);
+    if (JSON.typeof(json) != "object" || !json.hasOwnProperty("sensorConfig"))
+        return false;
+
+    JSONVar request = json["sensorConfig"];
+    int sensor_id = -1;
+    const char* error = NULL;
+    if (JSON.typeof(request) == "string" && strcmp((const char*)request, "defaults") == 0) {
+        loadDefaultSensorMappings();
+        saveSensorMappings();
+        LOG_INFO("[%u] Restored the default sensor table", num);
+    } else if (JSON.typeof(request) == "object" && request.hasOwnProperty("id")) {
+        sensor_id = (int)request["id"];
+        error = applySensorConfig(sensor_id, request);
+        if (error == NULL) {
+            LOG_INFO("[%u] Sensor %d config updated", num, sensor_id);
+        } else {
+            LOG_WARN("[%u] Sensor %d config rejected: %s", num, sensor_id, error);
+        }
+    } else {
+        error = "expected a sensor object with an id, or \"defaults\"";
+    }
+
+    char reply[160];
+    if (error == NULL) {
+        snprintf(reply, sizeof(reply), "{\"sensorConfig\":{\"ok\":true,\"id\":%d,\"version\":%lu}}", sensor_id,
+            (unsigned long)sensor_config_version);
+    } else {
+        snprintf(reply, sizeof(reply), "{\"sensorConfig\":{\"ok\":false,\"id\":%d,\"error\":\"%s\"}}", sensor_id,
+            error);
+    }
+    webSocket.sendTXT(num, reply);
+    return true;
+}
+
+// {"output": {"brightness": 200, "gamma": 2.2, "whiteBalance": [255, 176, 240], "trims": [255, ...],
+// "budgets": [2000, ...]}} changes the output calibration and the per-pin power budgets in mA;
+// fields left out keep their current values. Returns false for anything else so the message can be
+// handled as a sensor event.
+bool handleOutputSettingsMessage(uint8_t num, const char* message)
+{
+    // Sensor messages never mention the output, so skip the JSON parse for them
+    if (strstr(message, "\"output\"") == NULL)
+        return false;
+
+    JSONVar json = JSON.parse(message);
+    if (JSON.typeof(json) != "object" || !json.hasOwnProperty("output"))
+        return false;
+
+    JSONVar request = json["output"];
+    OutputSettings settings;
+    getOutputSettings(settings);
+    const char* error = NULL;
+
+    if (JSON.typeof(request) != "object") {
+        error = "expected an object";
+    } else {
+        if (request.hasOwnProperty("brightness")) {
+            int brightness = (int)request["brightness"];
+            if (brightness < 0 || brightness > 255)
+                error = "brightness out of range";
+            settings.brightness = brightness;
+        }
+        if (request.hasOwnProperty("gamma")) {
+            double gamma = (double)request["gamma"];
+            if (gamma < OUTPUT_MIN_GAMMA || gamma > OUTPUT_MAX_GAMMA)
+                error = "gamma out of range";
+            settings.gamma = gamma;
+        }
+        if (request.hasOwnProperty("whiteBalance")) {
+            JSONVar balance = request["whiteBalance"];
+            if (balance.length() != 3)
+                error = "whiteBalance needs three levels";
+            for (int channel = 0; channel < 3 && error == NULL; channel++) {
+                int level = (int)balance[channel];
+                if (level < 0 || level > 255)
+                    error = "whiteBalance out of range";
+                settings.white_balance.raw[channel] = level;
             }
         }
+        if (request.hasOwnProperty("trims")) {
+            JSONVar trims = request["trims"];
+            if (trims.length() > LOCAL_STRIP_COUNT)
+                error = "more trims than strips";
+            for (int strip = 0; strip < trims.length() && error == NULL; strip++) {
+                int trim = (int)trims[strip];
+                if (trim < 0 || trim > 255)
+                    error = "trim out of range";
+                settings.strip_trims[strip] = trim;
+            }
+        }
+        if (request.hasOwnProperty("budgets")) {
+            JSONVar budgets = request["budgets"];
+            if (budgets.length() > NUM_PINS)
+                error = "more budgets than pins";
+            for (int pin = 0; pin < budgets.length() && error == NULL; pin++) {
+                int budget = (int)budgets[pin];
+                if (budget < 0 || budget > UINT16_MAX)
+                    error = "budget out of range";
+                settings.pin_budgets_ma[pin] = budget;
+            }
+        }
+    }
+
+    char reply[96];
+    if (error == NULL) {
+        setOutputSettings(settings);
+        LOG_INFO("[%u] Output settings updated", num);
+        snprintf(reply, sizeof(reply), "{\"output\":{\"ok\":true}}");
+    } else {
+        LOG_WARN("[%u] Output settings rejected: %s", num, error);
+        snprintf(reply, sizeof(reply), "{\"output\":{\"ok\":false,\"error\":\"%s\"}}", error);
     }
+    webSocket.sendTXT(num, reply);
+    return true;
+}
+
+// Full stats document: the render engine's fields followed by the sensor counters
+void writeStatsJson(StatsWriter& writer)
+{
+    writeEngineStats(writer);
+
+    statsPrintf(writer, "\"sensors\":[");
+    bool first = true;
+    for (uint8_t id = 0; id < SENSOR_TABLE_SIZE; id++) {
+        const SensorMapping& mapping = sensor_mappings[id];
+        if (!mapping.config.active)
+            continue;
+
+        statsPrintf(writer, "%s{\"id\":%u,\"events\":%lu,\"cooldown_rejections\":%lu}", first ? "" : ",", id,
+            (unsigned long)mapping.trigger_count, (unsigned long)mapping.rejected_count);
+        first = false;
+    }
+    statsPrintf(writer, "],\"unmatched_sensor_messages\":%lu}", (unsigned long)unmatched_sensor_messages);
+}
+
+// Rebuild the stats document into the idle buffer and publish it. Returns false, building nothing,
+// while a response is still sending from that buffer
+bool updateStatsDocument()
+{
+    uint8_t next = stats_current ^ 1;
+    if (stats_readers[next] > 0)
+        return false;
+
+    StatsWriter writer;
+    initStatsWriter(writer, stats_documents[next], STATS_BUFFER_SIZE);
+    writeStatsJson(writer);
+    if (writer.overflow) {
+        LOG_WARN("Stats document doesn't fit in %u bytes", STATS_BUFFER_SIZE);
+    }
+
+    stats_lengths[next] = writer.overflow ? 0 : writer.length;
+    stats_current = next;
+    return true;
+}
+
+// Once per STATS_STREAM_INTERVAL, rebuild the stats document for /stats and push it to every
+// subscribed client
+void streamStats()
+{
+    if (current_time - last_stats_push < STATS_STREAM_INTERVAL || !updateStatsDocument())
+        return;
+    last_stats_push = current_time;
+
+    uint8_t current = stats_current;
+    if (stats_lengths[current] == 0)
+        return;
+    for (uint8_t num = 0; num < 32; num++) {
+        if (stats_subscribers & (1UL << num)) {
+            webSocket.sendTXT(num, stats_documents[current], stats_lengths[current]);
+        }
+    }
+}
+
+// Preview socket events arrive on the web server task; clients only claim and configure slots here
+void previewSocketEvent(
+    AsyncWebSocket* socket, AsyncWebSocketClient* client, AwsEventType type, void* arg, uint8_t* data, size_t length)
+{
+    switch (type) {
+    case WS_EVT_CONNECT:
+        if (addPreviewClient(client->id())) {
+            LOG_INFO("Preview client %lu connected", (unsigned long)client->id());
+        } else {
+            LOG_WARN("Preview client %lu refused: all %d slots in use", (unsigned long)client->id(), PREVIEW_MAX_CLIENTS);
+            client->close();
+        }
+        break;
+
+    case WS_EVT_DISCONNECT:
+        removePreviewClient(client->id());
+        LOG_INFO("Preview client %lu disconnected", (unsigned long)client->id());
+        break;
+
+    case WS_EVT_DATA: {
+        // Settings come as one small text frame: {"fps": 5, "blocks": 8}
+        AwsFrameInfo* info = (AwsFrameInfo*)arg;
+        char message[64];
+        if (!info->final || info->index != 0 || info->len != length || info->opcode != WS_TEXT
+            || length >= sizeof(message))
+            break;
+        memcpy(message, data, length);
+        message[length] = '\0';
+
+        JSONVar json = JSON.parse(message);
+        if (JSON.typeof(json) != "object")
+            break;
+        int fps = json.hasOwnProperty("fps") ? (int)json["fps"] : PREVIEW_DEFAULT_FPS;
+        int blocks = json.hasOwnProperty("blocks") ? (int)json["blocks"] : PREVIEW_DEFAULT_BLOCKS;
+        configurePreviewClient(client->id(), constrain(fps, 1, PREVIEW_MAX_FPS), constrain(blocks, 1, PREVIEW_MAX_BLOCKS));
+    } break;
+
+    default:
+        break;
+    }
+}
+
+// Send each due preview client the latest frame. A client that still has a frame queued is
+// backed up, so it skips this one rather than growing its queue
+void streamPreview()
+{
+    static uint8_t preview_buffer[PREVIEW_MAX_FRAME_SIZE];
+
+    for (uint8_t slot = 0; slot < PREVIEW_MAX_CLIENTS; slot++) {
+        uint32_t id = getDuePreviewClient(slot);
+        if (id == 0)
+            continue;
+
+        AsyncWebSocketClient* client = preview_socket.client(id);
+        if (client == NULL || client->status() != WS_CONNECTED)
+            continue;
+
+        if (client->queueLen() > 0) {
+            dropPreviewFrame(slot);
+            continue;
+        }
+
+        size_t length = encodePreviewFrame(slot, preview_buffer);
+        if (length > 0) {
+            client->binary(preview_buffer, length);
+        }
+    }
+}
+
+// Send a response that never changes for a given ETag, or 304 Not Modified when the client already
+// has it. Browsers revalidate every time, so a refresh costs one small round trip
+void sendCachedResponse(AsyncWebServerRequest* request, const char* content_type, const uint8_t* data, size_t length,
+    const char* etag, bool gzipped)
+{
+    if (request->hasHeader("If-None-Match") && request->getHeader("If-None-Match")->value() == etag) {
+        AsyncWebServerResponse* response = request->beginResponse(304);
+        response->addHeader("ETag", etag);
+        request->send(response);
+        return;
+    }
+
+    AsyncWebServerResponse* response = request->beginResponse_P(200, content_type, data, length);
+    if (gzipped) {
+        response->addHeader("Content-Encoding", "gzip");
+    }
+    response->addHeader("ETag", etag);
+    response->addHeader("Cache-Control", "no-cache");
+    request->send(response);
+}
+
+// Take the published one of a document's two buffers for a response that streams from it, and hold
+// it until the client is gone. Checking the buffer is still current after taking it keeps the render
+// loop from having started a rebuild into it in between
+uint8_t holdPublishedBuffer(
+    AsyncWebServerRequest* request, std::atomic<uint8_t>& published, std::atomic<uint8_t>* readers)
+{
+    uint8_t buffer;
+    while (true) {
+        buffer = published;
+        readers[buffer]++;
+        if (published == buffer)
+            break;
+        readers[buffer]--;
+    }
+    request->onDisconnect([readers, buffer]() { readers[buffer]--; });
+    return buffer;
+}
+
+// Rebuild the /mappings document into the idle buffer when the config has changed, then publish it
+void updateMappingsDocument()
+{
+    if (mappings_version == sensor_config_version)
+        return;
+
+    // Wait for the responses still sending the previous document to finish
+    uint8_t next = mappings_current ^ 1;
+    if (mappings_readers[next] > 0)
+        return;
+    mappings_version = sensor_config_version;
+
+    // Every sensor with strips assigned, including ones switched off
+    StatsWriter writer;
+    initStatsWriter(writer, mappings_documents[next], MAPPINGS_BUFFER_SIZE);
+    statsPrintf(writer, "{\"version\":%lu,\"sensors\":[", (unsigned long)sensor_config_version);
+    bool first = true;
+    for (uint8_t id = 0; id < SENSOR_TABLE_SIZE; id++) {
+        const SensorConfig& config = sensor_mappings[id].config;
+        if (config.strip_mask == 0)
+            continue;
+
+        statsPrintf(writer,
+            "%s{\"id\":%u,\"active\":%s,\"effect\":\"%s\",\"envelope\":%u,\"cooldown\":%lu,\"strips\":[",
+            first ? "" : ",", id, config.active ? "true" : "false", getSensorEffectName(config.effect),
+            config.envelope_index, (unsigned long)config.cooldown_ms);
+        uint8_t strip_ids[SENSOR_STRIP_COUNT];
+        uint8_t num_strips = getSensorStrips(config, strip_ids);
+        for (uint8_t i = 0; i < num_strips; i++) {
+            statsPrintf(writer, i == 0 ? "%u" : ",%u", strip_ids[i]);
+        }
+        statsPrintf(writer, "]}");
+        first = false;
+    }
+    statsPrintf(writer, "]}");
+    if (writer.overflow) {
+        LOG_WARN("Mappings document doesn't fit in %u bytes", MAPPINGS_BUFFER_SIZE);
+    }
+
+    mappings_lengths[next] = writer.overflow ? 0 : writer.length;
+    snprintf(mappings_etags[next], sizeof(mappings_etags[next]), "\"m%lu\"", (unsigned long)sensor_config_version);
+    mappings_current = next;
 }
 
 // Setup WiFi Access Point and WebSocket server
 void setupWiFiAndWebSocket()
 {
+#ifdef SHOW_CLOCK_LEADER_IP
+    // Followers join the leader's access point and take the show clock from it
+    WiFi.mode(WIFI_STA);
+    WiFi.begin(ssid, password);
+    Serial.printf("Joining %s as a follower of %s\n", ssid, SHOW_CLOCK_LEADER_IP);
+#else
     // Set up WiFi Access Point
     WiFi.softAP(ssid, password);
     IPAddress IP = WiFi.softAPIP();
     Serial.print("AP IP address: ");
     Serial.println(IP);
+#endif
+    beginShowClockSync();
 
     // Setup WebSocket server
     webSocket.begin();
     webSocket.onEvent(webSocketEvent);
     Serial.println("WebSocket server started on port 81");
 
+    // Listen for frames from a media server
+    initStreamInput();
+
+    // Exchange sensor effects with the installation's other controllers
+    initEffectForwarding();
+
     // Setup basic web server
-    server.on("/", HTTP_GET, [](AsyncWebServerRequest* request) {
-        String html = "<!DOCTYPE html><html><head><title>Reflecting The Present</title></head><body>";
-        html += "<h1>Reflecting The Present - LED Control</h1>";
-        html += "<p>WebSocket server running on port 81</p>";
-        html += "<p>Send JSON messages with format: {\"sensorId\": 1, \"timestamp\": 1234567890}</p>";
-        html += "<h2>Sensor Mappings:</h2><ul>";
-
-        for (uint8_t i = 0; i < MAX_SENSORS; i++) {
-            if (sensor_mappings[i].active) {
-                html += "<li>Sensor " + String(sensor_mappings[i].sensor_id) + " -> Strips: ";
-                for (uint8_t j = 0; j < sensor_mappings[i].num_strips; j++) {
-                    html += String(sensor_mappings[i].led_strips[j]);
-                    if (j < sensor_mappings[i].num_strips - 1)
-                        html += ", ";
-                }
-                html += "</li>";
-            }
+    // Live preview of every strip
+    preview_socket.onEvent(previewSocketEvent);
+    server.addHandler(&preview_socket);
+
+    // The UI pages are served gzipped from flash; the sensor list comes from the cached document
+    for (uint8_t i = 0; i < WEB_ASSET_COUNT; i++) {
+        const WebAsset* asset = &web_assets[i];
+        server.on(asset->path, HTTP_GET, [asset](AsyncWebServerRequest* request) {
+            sendCachedResponse(request, asset->content_type, asset->data, asset->length, asset->etag, true);
+        });
+    }
+
+    // The response streams straight from the published buffer
+    server.on("/mappings", HTTP_GET, [](AsyncWebServerRequest* request) {
+        uint8_t current = holdPublishedBuffer(request, mappings_current, mappings_readers);
+        if (mappings_lengths[current] == 0) {
+            request->send(500, "text/plain", "Sensor mappings document too large");
+            return;
         }
-        html += "</ul></body></html>";
-        request->send(200, "text/html", html);
+        sendCachedResponse(request, "application/json", (const uint8_t*)mappings_documents[current],
+            mappings_lengths[current], mappings_etags[current], false);
+    });
+
+#if FRAME_RECORDER
+    // Frame hashes and inputs recorded since boot, for replay against another build. When the log
+    // stopped early, X-Recording-Stopped says why
+    server.on("/recording", HTTP_GET, [](AsyncWebServerRequest* request) {
+        size_t length;
+        const uint8_t* data = getRecording(length);
+        AsyncWebServerResponse* response = request->beginResponse_P(200, "application/octet-stream", data, length);
+        const char* stop_reason = getRecordingStopReason();
+        if (stop_reason != NULL)
+            response->addHeader("X-Recording-Stopped", stop_reason);
+        request->send(response);
+    });
+#endif
+
+    // Frame and sensor statistics as JSON, as of the render loop's last rebuild
+    server.on("/stats", HTTP_GET, [](AsyncWebServerRequest* request) {
+        uint8_t current = holdPublishedBuffer(request, stats_current, stats_readers);
+        if (stats_lengths[current] == 0) {
+            request->send(500, "text/plain", "Stats document too large");
+            return;
+        }
+        AsyncWebServerResponse* response = request->beginResponse_P(
+            200, "application/json", (const uint8_t*)stats_documents[current], stats_lengths[current]);
+        response->addHeader("Cache-Control", "no-cache");
+        request->send(response);
     });
 
     server.begin();
     Serial.println("HTTP server started on port 80");
 }
 
-void setup()
+// Pin summary for the boot diagnostics
+void printLEDConfiguration()
 {
-    Serial.begin(115200);
-    Serial.print("Connecting");
-    delay(3000);
-
-    FastLED.addLeds<LED_TYPE, PIN1, COLOR_ORDER>(pin1_leds, pin_configs[0].total_leds).setCorrection(TypicalLEDStrip);
-    FastLED.addLeds<LED_TYPE, PIN2, COLOR_ORDER>(pin2_leds, pin_configs[1].total_leds).setCorrection(TypicalLEDStrip);
-    FastLED.addLeds<LED_TYPE, PIN3, COLOR_ORDER>(pin3_leds, pin_configs[2].total_leds).setCorrection(TypicalLEDStrip);
-    FastLED.addLeds<LED_TYPE, PIN4, COLOR_ORDER>(pin4_leds, pin_configs[3].total_leds).setCorrection(TypicalLEDStrip);
-    FastLED.addLeds<LED_TYPE, PIN5, COLOR_ORDER>(pin5_leds, pin_configs[4].total_leds).setCorrection(TypicalLEDStrip);
-    FastLED.addLeds<LED_TYPE, PIN6, COLOR_ORDER>(pin6_leds, pin_configs[5].total_leds).setCorrection(TypicalLEDStrip);
-
-    FastLED.setBrightness(BRIGHTNESS);
-
     Serial.println("LED configuration:");
     uint16_t total_leds = 0;
 
@@ -234,282 +649,160 @@ void setup()
 
     Serial.printf("Total: %d LEDs across 22 strips\n", total_leds);
     Serial.println("Expected: 3+4+4+3+4+4 = 22 strips total");
+}
+
+// Boot puts the show on the LEDs first and only then starts networking and prints diagnostics, so
+// after a power blip the installation is lit again within a few hundred ms
+void setup()
+{
+    Serial.begin(115200);
+
+    // The show clock needs no network: the first frames are drawn on it before WiFi is up
+#ifdef SHOW_CLOCK_LEADER_IP
+    initShowClock(SHOW_CLOCK_FOLLOWER, SHOW_CLOCK_LEADER_IP);
+#else
+    initShowClock(SHOW_CLOCK_LEADER, NULL);
+#endif
+
+    // Saved show state after a brownout, watchdog reset or crash: resume it and skip the layout dump
+    bool resuming = loadShowCheckpoint();
+
+    // FastLED sends the output stage's buffers, which already carry color correction and
+    // brightness, so it is left to pass them through untouched
+    FastLED.addLeds<LED_TYPE, PIN1, COLOR_ORDER>(pin_configs[0].output_array, pin_configs[0].total_leds);
+    FastLED.addLeds<LED_TYPE, PIN2, COLOR_ORDER>(pin_configs[1].output_array, pin_configs[1].total_leds);
+    FastLED.addLeds<LED_TYPE, PIN3, COLOR_ORDER>(pin_configs[2].output_array, pin_configs[2].total_leds);
+    FastLED.addLeds<LED_TYPE, PIN4, COLOR_ORDER>(pin_configs[3].output_array, pin_configs[3].total_leds);
+    FastLED.addLeds<LED_TYPE, PIN5, COLOR_ORDER>(pin_configs[4].output_array, pin_configs[4].total_leds);
+    FastLED.addLeds<LED_TYPE, PIN6, COLOR_ORDER>(pin_configs[5].output_array, pin_configs[5].total_leds);
+
+    FastLED.setBrightness(255);
+    FastLED.setDither(DISABLE_DITHER);
+
+    initProfiler();
 
     // Initialize and validate new strip configuration system
     initializeStripConfigs();
+    markBootPhase(BOOT_PHASE_LEDS);
+
+    // Benchmark builds are for the bench, so they may hold up the first frame
+#ifdef LED_KERNEL_BENCHMARK
+    runLEDKernelBenchmark();
+    runOutputBenchmark();
+#endif
+
+    // Seed the show and set up patterns, FlashBulbs and ripples
+    uint32_t random_seed = esp_random();
+    resetShowState(random_seed);
+    initLatencyTracing();
+
+    // Sensor table saved from the control page, or the built-in wiring on first boot
+    if (loadSensorMappings()) {
+        Serial.println("Sensor table loaded from flash");
+    } else {
+        loadDefaultSensorMappings();
+        Serial.println("Using default sensor table");
+    }
 
-    // Setup the pattern program
-    setupPatternProgram();
+    // Rejoin the show where the reset interrupted it
+    if (resuming) {
+        resuming = restoreShowCheckpoint();
+    }
+
+    // The recording starts from the show as it is now, sensor table and resumed state included,
+    // and carries the seed so a replay makes the same random choices
+    startRecording(random_seed);
+    markBootPhase(BOOT_PHASE_SHOW);
+
+    // First frame out before anything slow starts
+    current_time = getShowFrameTime();
+    runFrameIfDue();
+    markBootPhase(BOOT_PHASE_FIRST_FRAME);
 
-    // Initialize FlashBulb system
-    initFlashBulbManager();
+    // Build the /mappings and /stats documents before the web server can be asked for them
+    updateMappingsDocument();
+    updateStatsDocument();
 
     // Setup WiFi Access Point and WebSocket server
     setupWiFiAndWebSocket();
+    markBootPhase(BOOT_PHASE_NETWORK);
+
+    if (!resuming) {
+        printLEDConfiguration();
+        printStripConfigs();
+    }
 
     Serial.println("=== System Ready ===");
     Serial.println("Connect to WiFi: ReflectingThePresent");
     Serial.println("Password: lightshow2024");
     Serial.println("WebSocket: ws://192.168.4.1:81");
     Serial.println("Web interface: http://192.168.4.1");
+    markBootPhase(BOOT_PHASE_READY);
+
+    // The frames setup() held up are not the show falling behind
+    resetFrameWatchdog();
+    startStallGuard();
+    Serial.printf("Boot: first frame at %lu ms, network up at %lu ms, ready at %lu ms\n",
+        getBootPhaseTime(BOOT_PHASE_FIRST_FRAME), getBootPhaseTime(BOOT_PHASE_NETWORK),
+        getBootPhaseTime(BOOT_PHASE_READY));
 }
 
-void initializeStripConfigs()
+// One frame per grid slot, the same one every controller renders
+void runFrameIfDue()
 {
-    // Validation and setup for the new strip configuration system
-    Serial.println("Initializing unified strip configuration...");
-
-    // Initialize strip configuration data using individual field assignment
-    // Pin 1 (13) - 3 strips (strips 0-2)
-    strips[0].physical_pin = 13;
-    strips[0].pin_index = 0;
-    strips[0].start_offset = 0;
-    strips[0].length = 122;
-    strips[0].reverse_direction = false;
-    strips[0].led_array_ptr = pin1_leds;
-    strips[1].physical_pin = 13;
-    strips[1].pin_index = 0;
-    strips[1].start_offset = 122;
-    strips[1].length = 122;
-    strips[1].reverse_direction = false;
-    strips[1].led_array_ptr = pin1_leds;
-    strips[2].physical_pin = 13;
-    strips[2].pin_index = 0;
-    strips[2].start_offset = 244;
-    strips[2].length = 122;
-    strips[2].reverse_direction = false;
-    strips[2].led_array_ptr = pin1_leds;
-
-    // Pin 2 (5) - 4 strips (strips 3-6)
-    strips[3].physical_pin = 5;
-    strips[3].pin_index = 1;
-    strips[3].start_offset = 0;
-    strips[3].length = 122;
-    strips[3].reverse_direction = false;
-    strips[3].led_array_ptr = pin2_leds;
-    strips[4].physical_pin = 5;
-    strips[4].pin_index = 1;
-    strips[4].start_offset = 122;
-    strips[4].length = 122;
-    strips[4].reverse_direction = false;
-    strips[4].led_array_ptr = pin2_leds;
-    strips[5].physical_pin = 5;
-    strips[5].pin_index = 1;
-    strips[5].start_offset = 244;
-    strips[5].length = 122;
-    strips[5].reverse_direction = false;
-    strips[5].led_array_ptr = pin2_leds;
-    strips[6].physical_pin = 5;
-    strips[6].pin_index = 1;
-    strips[6].start_offset = 366;
-    strips[6].length = 122;
-    strips[6].reverse_direction = false;
-    strips[6].led_array_ptr = pin2_leds;
-
-    // Pin 3 (19) - 4 strips (strips 7-10)
-    strips[7].physical_pin = 19;
-    strips[7].pin_index = 2;
-    strips[7].start_offset = 0;
-    strips[7].length = 122;
-    strips[7].reverse_direction = false;
-    strips[7].led_array_ptr = pin3_leds;
-    strips[8].physical_pin = 19;
-    strips[8].pin_index = 2;
-    strips[8].start_offset = 122;
-    strips[8].length = 122;
-    strips[8].reverse_direction = false;
-    strips[8].led_array_ptr = pin3_leds;
-    strips[9].physical_pin = 19;
-    strips[9].pin_index = 2;
-    strips[9].start_offset = 244;
-    strips[9].length = 122;
-    strips[9].reverse_direction = false;
-    strips[9].led_array_ptr = pin3_leds;
-    strips[10].physical_pin = 19;
-    strips[10].pin_index = 2;
-    strips[10].start_offset = 366;
-    strips[10].length = 122;
-    strips[10].reverse_direction = false;
-    strips[10].led_array_ptr = pin3_leds;
-
-    // Pin 4 (23) - 3 strips (strips 11-13)
-    strips[11].physical_pin = 23;
-    strips[11].pin_index = 3;
-    strips[11].start_offset = 0;
-    strips[11].length = 122;
-    strips[11].reverse_direction = false;
-    strips[11].led_array_ptr = pin4_leds;
-    strips[12].physical_pin = 23;
-    strips[12].pin_index = 3;
-    strips[12].start_offset = 122;
-    strips[12].length = 122;
-    strips[12].reverse_direction = false;
-    strips[12].led_array_ptr = pin4_leds;
-    strips[13].physical_pin = 23;
-    strips[13].pin_index = 3;
-    strips[13].start_offset = 244;
-    strips[13].length = 122;
-    strips[13].reverse_direction = false;
-    strips[13].led_array_ptr = pin4_leds;
-
-    // Pin 5 (18) - 4 strips (strips 14-17)
-    strips[14].physical_pin = 18;
-    strips[14].pin_index = 4;
-    strips[14].start_offset = 0;
-    strips[14].length = 122;
-    strips[14].reverse_direction = false;
-    strips[14].led_array_ptr = pin5_leds;
-    strips[15].physical_pin = 18;
-    strips[15].pin_index = 4;
-    strips[15].start_offset = 122;
-    strips[15].length = 122;
-    strips[15].reverse_direction = false;
-    strips[15].led_array_ptr = pin5_leds;
-    strips[16].physical_pin = 18;
-    strips[16].pin_index = 4;
-    strips[16].start_offset = 244;
-    strips[16].length = 122;
-    strips[16].reverse_direction = false;
-    strips[16].led_array_ptr = pin5_leds;
-    strips[17].physical_pin = 18;
-    strips[17].pin_index = 4;
-    strips[17].start_offset = 366;
-    strips[17].length = 122;
-    strips[17].reverse_direction = false;
-    strips[17].led_array_ptr = pin5_leds;
-
-    // Pin 6 (12) - 4 strips (strips 18-21)
-    strips[18].physical_pin = 12;
-    strips[18].pin_index = 5;
-    strips[18].start_offset = 0;
-    strips[18].length = 122;
-    strips[18].reverse_direction = false;
-    strips[18].led_array_ptr = pin6_leds;
-    strips[19].physical_pin = 12;
-    strips[19].pin_index = 5;
-    strips[19].start_offset = 122;
-    strips[19].length = 122;
-    strips[19].reverse_direction = false;
-    strips[19].led_array_ptr = pin6_leds;
-    strips[20].physical_pin = 12;
-    strips[20].pin_index = 5;
-    strips[20].start_offset = 244;
-    strips[20].length = 122;
-    strips[20].reverse_direction = false;
-    strips[20].led_array_ptr = pin6_leds;
-    strips[21].physical_pin = 12;
-    strips[21].pin_index = 5;
-    strips[21].start_offset = 366;
-    strips[21].length = 122;
-    strips[21].reverse_direction = false;
-    strips[21].led_array_ptr = pin6_leds;
-
-    // Apply direction configuration
-    configureStripDirections();
-
-    // Initialize FastLED sets for each strip
-    for (uint8_t i = 0; i < 22; i++) {
-        StripConfig& strip = strips[i];
-
-        // Verify pin index is valid
-        if (strip.pin_index > 5) {
-            Serial.printf("ERROR: Strip %d has invalid pin_index %d\n", i, strip.pin_index);
-            continue;
-        }
-
-        // Verify the pin matches PinConfig
-        if (strip.physical_pin != pin_configs[strip.pin_index].pin) {
-            Serial.printf("WARNING: Strip %d pin mismatch - strip:%d vs pinconfig:%d\n", i, strip.physical_pin,
-                pin_configs[strip.pin_index].pin);
-        }
-
-        // Verify LED array pointer matches
-        if (strip.led_array_ptr != pin_configs[strip.pin_index].led_array) {
-            Serial.printf("WARNING: Strip %d LED array pointer mismatch\n", i);
-        }
+    if (frame_rendered && current_time == last_frame_time)
+        return;
 
-        // Note: CRGBSets will be created on-demand in getStripSet() function
+    last_frame_time = current_time;
+    frame_rendered = true;
 
-        Serial.printf("Strip %d: Pin %d, Offset %d, Length %d, Direction: %s\n", i, strip.physical_pin,
-            strip.start_offset, strip.length, strip.reverse_direction ? "REVERSED" : "FORWARD");
+    // After a run of missed slots the watchdog has a precomputed solid sent instead of the show
+    if (updateFrameWatchdog(millis())) {
+        showFallbackFrame();
+    } else {
+        runShowFrame();
     }
-
-    // Add debug output to verify addressing for problematic strips
-    Serial.println("=== DEBUG: Verifying problematic strip addressing ===");
-
-    // Test Pin 1 Strip 2 (strip_id = 2)
-    Serial.printf("Pin 1 Strip 2 (strip_id=2): ");
-    CRGBSet test_set_2 = getStripSet(2);
-    Serial.printf("CRGBSet size=%d, ptr=%p\n", test_set_2.size(), &test_set_2[0]);
-    Serial.printf("Strip config: pin=%d, offset=%d, length=%d, array_ptr=%p\n", strips[2].physical_pin,
-        strips[2].start_offset, strips[2].length, strips[2].led_array_ptr);
-    Serial.printf("Calculated start address: %p\n", strips[2].led_array_ptr + strips[2].start_offset);
-
-    // Test Pin 4 Strip 2 (strip_id = 12)
-    Serial.printf("Pin 4 Strip 2 (strip_id=12): ");
-    CRGBSet test_set_12 = getStripSet(12);
-    Serial.printf("CRGBSet size=%d, ptr=%p\n", test_set_12.size(), &test_set_12[0]);
-    Serial.printf("Strip config: pin=%d, offset=%d, length=%d, array_ptr=%p\n", strips[12].physical_pin,
-        strips[12].start_offset, strips[12].length, strips[12].led_array_ptr);
-    Serial.printf("Calculated start address: %p\n", strips[12].led_array_ptr + strips[12].start_offset);
-
-    // Note: Array size verification removed due to extern declaration limitations
-
-    Serial.println("Strip configuration initialized successfully");
-
-    // Perform a simple LED addressing test
-    // testStripAddressing();
+    recordLoopIteration();
 }
 
-void demoFlashBulb()
+void loop()
 {
-    static unsigned long last_demo = 0;
-
-    if (current_time - last_demo >= 10000) { // Every 5 seconds
-        last_demo = current_time;
-
-        // Random number of strips (0-5)
-        uint8_t num_random_strips = random(0, 6);
-
-        if (num_random_strips > 0) {
-            // Create random strip array
-            uint8_t random_strips[5];
-            for (uint8_t i = 0; i < num_random_strips; i++) {
-                random_strips[i] = random(0, 13); // Random strip 0-21
-            }
+    // Frame times come from the shared show clock, snapped to the SHOW_FRAME_INTERVAL grid
+    updateShowClock();
+    current_time = getShowFrameTime();
 
-            // Add temporary FlashBulb pattern
-            addFlashBulbPattern(random_strips, num_random_strips);
+    // Print per-stage timings every PROFILE_REPORT_INTERVAL, outside the frame being timed
+    reportProfiler();
+    updateFrameTelemetry();
+    PROFILE_STAGE(STAGE_FRAME);
 
-            // Trigger the newly added pattern (it will be the last one)
-            uint8_t pattern_index = flashbulb_manager.pattern_count - 1;
-            triggerFlashBulb(pattern_index);
+    // Handle WebSocket events
+    {
+        PROFILE_STAGE(STAGE_WEBSOCKET);
+        webSocket.loop();
+    }
 
-            Serial.print("FlashBulb demo triggered on ");
-            Serial.print(num_random_strips);
-            Serial.print(" strips: ");
-            for (uint8_t i = 0; i < num_random_strips; i++) {
-                Serial.print(random_strips[i]);
-                if (i < num_random_strips - 1)
-                    Serial.print(", ");
-            }
-            Serial.println();
-        } else {
-            Serial.println("FlashBulb demo: No strips selected this time");
-        }
+    // Read any streamed pixel data straight into the LED buffers
+    {
+        PROFILE_STAGE(STAGE_STREAM_INPUT);
+        pollStreamInput();
     }
-}
 
-void loop()
-{
-    current_time = millis();
+    // Sensor effects other controllers sent for our strips, started with the next frame
+    pollForwardedEffects();
 
-    // Handle WebSocket events
-    webSocket.loop();
+    runFrameIfDue();
+
+    // Rebuild the stats document and push it and preview frames to subscribed WebSocket clients
+    streamStats();
+    streamPreview();
 
-    // Run demo FlashBulb trigger (optional - comment out when using real sensors)
-    demoFlashBulb();
+    // Rebuild the cached /mappings document, save the sensor table if the config changed and
+    // checkpoint the show state when it is due
+    updateMappingsDocument();
+    updateSensorMappingStorage();
+    updateShowCheckpoint();
 
-    // Run the queued pattern program
-    runQueuedPattern();
+    // Send queued log lines once the frame is out
+    drainLog();
 }
@@ -0,0 +1,356 @@
+#include "output_stage.h"
+#include "frame_recorder.h"
+#include "led_kernels.h"
+#include "patterns.h"
+#include "render_buffer.h"
+
+#ifdef ARDUINO
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+static SemaphoreHandle_t output_mutex = xSemaphoreCreateMutex();
+#endif
+
+static OutputSettings output_settings = { OUTPUT_DEFAULT_GAMMA, OUTPUT_DEFAULT_WHITE_BALANCE,
+    OUTPUT_DEFAULT_BRIGHTNESS, {}, {} };
+static bool output_defaults_initialized = false;
+static bool output_tables_dirty = true;
+static OutputPowerStats power_stats;
+
+// Sum of each channel's output levels per pin, gathered by the output pass
+static uint32_t pin_channel_sums[NUM_PINS][3];
+
+// 8.8 fixed-point output level per channel and input level, and the same truncated to 8 bits for
+// untrimmed strips
+static uint16_t output_tables[3][256];
+static uint8_t output_tables8[3][256];
+
+#if HIGH_PRECISION_RENDER
+static uint8_t dither_frame = 0;
+
+// Added to the fraction before truncating; an LED rounds up on the frames whose threshold its
+// fraction reaches. Bit-reversed order spreads those frames evenly through the cycle
+static const uint8_t dither_thresholds[DITHER_STEPS]
+    = { 8, 136, 72, 200, 40, 168, 104, 232, 24, 152, 88, 216, 56, 184, 120, 248 };
+#endif
+
+static void initOutputDefaults()
+{
+    if (output_defaults_initialized)
+        return;
+    memset(output_settings.strip_trims, 255, sizeof(output_settings.strip_trims));
+    for (uint8_t pin = 0; pin < NUM_PINS; pin++) {
+        output_settings.pin_budgets_ma[pin] = POWER_PIN_BUDGET_MA;
+    }
+    output_defaults_initialized = true;
+}
+
+void getOutputSettings(OutputSettings& settings)
+{
+    initOutputDefaults();
+    settings = output_settings;
+}
+
+// Takes effect from the next frame, which rebuilds the tables first
+void setOutputSettings(const OutputSettings& settings)
+{
+    lockOutput();
+    output_settings = settings;
+    output_settings.gamma = constrain(settings.gamma, OUTPUT_MIN_GAMMA, OUTPUT_MAX_GAMMA);
+    output_defaults_initialized = true;
+    output_tables_dirty = true;
+    unlockOutput();
+    recordOutputSettings(output_settings);
+}
+
+// Back to the default settings and the start of the dither cycle, as at boot
+void resetOutputStage()
+{
+    lockOutput();
+    output_settings = { OUTPUT_DEFAULT_GAMMA, OUTPUT_DEFAULT_WHITE_BALANCE, OUTPUT_DEFAULT_BRIGHTNESS, {}, {} };
+    output_defaults_initialized = false;
+    output_tables_dirty = true;
+#if HIGH_PRECISION_RENDER
+    dither_frame = 0;
+#endif
+    unlockOutput();
+}
+
+void getOutputPowerStats(OutputPowerStats& stats)
+{
+    stats = power_stats;
+}
+
+// Channel scale from white balance and brightness, the way FastLED derives its color adjustment,
+// so the default settings reproduce what setCorrection(TypicalLEDStrip) used to send
+static uint16_t getChannelScale(uint8_t white_balance, uint8_t brightness)
+{
+    if (white_balance == 0 || brightness == 0)
+        return 0;
+    return (((uint32_t)white_balance + 1) * brightness >> 8) + 1;
+}
+
+static void buildOutputTables()
+{
+    for (uint8_t channel = 0; channel < 3; channel++) {
+        uint16_t scale = getChannelScale(output_settings.white_balance.raw[channel], output_settings.brightness);
+        for (uint16_t level = 0; level < 256; level++) {
+            // Gamma-corrected input in 8.8; exact at gamma 1 so the default stays bit-identical
+            uint32_t corrected = output_settings.gamma == 1.0f
+                ? (uint32_t)level << 8
+                : (uint32_t)(powf(level / 255.0f, output_settings.gamma) * (255 << 8) + 0.5f);
+            output_tables[channel][level] = (corrected * scale) >> 8;
+            output_tables8[channel][level] = output_tables[channel][level] >> 8;
+        }
+    }
+    output_tables_dirty = false;
+}
+
+#if HIGH_PRECISION_RENDER
+// Table lookup for an 8.8 input, interpolating between the entries either side
+static inline uint16_t lookupFine(const uint16_t* table, uint16_t value)
+{
+    uint8_t index = value >> 8;
+    uint16_t low = table[index];
+    uint16_t high = table[index < 255 ? index + 1 : index];
+    return low + (((int32_t)high - low) * (value & 0xFF) >> 8);
+}
+#endif
+
+// Scale down every pin whose estimated draw is over its budget, from the sums the output pass
+// gathered
+static void limitPinPower()
+{
+    bool limited = false;
+    for (uint8_t pin = 0; pin < NUM_PINS; pin++) {
+        const PinConfig& config = pin_configs[pin];
+        uint32_t idle_ma = (uint32_t)config.total_leds * POWER_IDLE_MA;
+        uint32_t lit_ma = (pin_channel_sums[pin][0] * POWER_RED_MA + pin_channel_sums[pin][1] * POWER_GREEN_MA
+                              + pin_channel_sums[pin][2] * POWER_BLUE_MA)
+            / 255;
+        uint8_t scale = 255;
+
+        uint16_t budget_ma = output_settings.pin_budgets_ma[pin];
+        if (budget_ma != 0 && idle_ma + lit_ma > budget_ma) {
+            // nscale8 multiplies by (scale + 1) / 256, so round the ratio down to stay in budget
+            uint32_t ratio = budget_ma > idle_ma ? (budget_ma - idle_ma) * 256 / lit_ma : 0;
+            scale = ratio > 0 ? ratio - 1 : 0;
+            scaleLEDs(config.output_array, config.total_leds, scale);
+            lit_ma = lit_ma * (scale + 1) >> 8;
+            limited = true;
+        }
+
+        power_stats.pin_ma[pin] = min(idle_ma + lit_ma, (uint32_t)UINT16_MAX);
+        power_stats.pin_scale[pin] = scale;
+    }
+    if (limited) {
+        power_stats.limited_frames++;
+    }
+}
+
+// Correct this frame from the pin buffers into the output buffers. Each strip is a contiguous run
+// of its pin buffer, so this is one linear pass over every pin
+void renderOutputFrame()
+{
+    initOutputDefaults();
+    if (output_tables_dirty)
+        buildOutputTables();
+
+#if HIGH_PRECISION_RENDER
+    dither_frame++;
+#endif
+    memset(pin_channel_sums, 0, sizeof(pin_channel_sums));
+
+    for (uint8_t strip_id = 0; strip_id < LOCAL_STRIP_COUNT; strip_id++) {
+        const StripConfig& strip = strips[strip_id];
+        const CRGB* leds = strip.led_array_ptr + strip.start_offset;
+        CRGB* output = pin_configs[strip.pin_index].output_array + strip.start_offset;
+        uint32_t trim = (uint32_t)output_settings.strip_trims[strip_id] + 1;
+        uint32_t red = 0, green = 0, blue = 0;
+
+#if HIGH_PRECISION_RENDER
+        // Every channel leaves the tables with a fraction, so the whole frame is dithered; strips
+        // the render buffer holds in 16 bits start from those values instead of the pin buffer
+        const CRGB16* fine = getFineStrip(strip_id);
+        for (uint16_t led = 0; led < strip.length; led++) {
+            uint32_t r, g, b;
+            if (fine != NULL && holdsFineValue(leds[led], fine[led])) {
+                r = lookupFine(output_tables[0], fine[led].r);
+                g = lookupFine(output_tables[1], fine[led].g);
+                b = lookupFine(output_tables[2], fine[led].b);
+            } else {
+                r = output_tables[0][leds[led].r];
+                g = output_tables[1][leds[led].g];
+                b = output_tables[2][leds[led].b];
+            }
+
+            // Entries are at most 255 << 8, so adding the threshold can't carry past 8 bits.
+            // Neighbouring LEDs start the cycle at different frames, so a strip of one color
+            // never steps up all at once
+            uint8_t threshold = dither_thresholds[(dither_frame + led * 7) % DITHER_STEPS];
+            output[led].r = ((r * trim >> 8) + threshold) >> 8;
+            output[led].g = ((g * trim >> 8) + threshold) >> 8;
+            output[led].b = ((b * trim >> 8) + threshold) >> 8;
+            red += output[led].r;
+            green += output[led].g;
+            blue += output[led].b;
+        }
+#else
+        if (trim == 256) {
+            for (uint16_t led = 0; led < strip.length; led++) {
+                output[led].r = output_tables8[0][leds[led].r];
+                output[led].g = output_tables8[1][leds[led].g];
+                output[led].b = output_tables8[2][leds[led].b];
+                red += output[led].r;
+                green += output[led].g;
+                blue += output[led].b;
+            }
+        } else {
+            for (uint16_t led = 0; led < strip.length; led++) {
+                output[led].r = (output_tables[0][leds[led].r] * trim) >> 16;
+                output[led].g = (output_tables[1][leds[led].g] * trim) >> 16;
+                output[led].b = (output_tables[2][leds[led].b] * trim) >> 16;
+                red += output[led].r;
+                green += output[led].g;
+                blue += output[led].b;
+            }
+        }
+#endif
+        pin_channel_sums[strip.pin_index][0] += red;
+        pin_channel_sums[strip.pin_index][1] += green;
+        pin_channel_sums[strip.pin_index][2] += blue;
+    }
+
+    limitPinPower();
+}
+
+// Fill the output buffers with one color, corrected and limited as renderOutputFrame() would send
+// it. Leaves the pin buffers alone, so it is safe while loop() is in the middle of drawing
+void renderOutputSolid(const CRGB& color)
+{
+    initOutputDefaults();
+    if (output_tables_dirty)
+        buildOutputTables();
+    memset(pin_channel_sums, 0, sizeof(pin_channel_sums));
+
+    for (uint8_t strip_id = 0; strip_id < LOCAL_STRIP_COUNT; strip_id++) {
+        const StripConfig& strip = strips[strip_id];
+        uint32_t trim = (uint32_t)output_settings.strip_trims[strip_id] + 1;
+        CRGB output = CRGB((output_tables[0][color.r] * trim) >> 16, (output_tables[1][color.g] * trim) >> 16,
+            (output_tables[2][color.b] * trim) >> 16);
+        fill_solid(pin_configs[strip.pin_index].output_array + strip.start_offset, strip.length, output);
+
+        pin_channel_sums[strip.pin_index][0] += (uint32_t)output.r * strip.length;
+        pin_channel_sums[strip.pin_index][1] += (uint32_t)output.g * strip.length;
+        pin_channel_sums[strip.pin_index][2] += (uint32_t)output.b * strip.length;
+    }
+
+    limitPinPower();
+}
+
+void showOutputFrame()
+{
+    lockOutput();
+    renderOutputFrame();
+    FastLED.show();
+    unlockOutput();
+}
+
+void lockOutput()
+{
+#ifdef ARDUINO
+    xSemaphoreTake(output_mutex, portMAX_DELAY);
+#endif
+}
+
+bool tryLockOutput()
+{
+#ifdef ARDUINO
+    return xSemaphoreTake(output_mutex, 0) == pdTRUE;
+#else
+    return true;
+#endif
+}
+
+void unlockOutput()
+{
+#ifdef ARDUINO
+    xSemaphoreGive(output_mutex);
+#endif
+}
+
+#ifdef LED_KERNEL_BENCHMARK
+
+// What a separate power limiter costs: a full rescan of every output buffer, like FastLED's
+// calculate_unscaled_power_mW()
+static uint32_t rescanOutputPower()
+{
+    uint32_t total_ma = 0;
+    for (uint8_t pin = 0; pin < NUM_PINS; pin++) {
+        const CRGB* leds = pin_configs[pin].output_array;
+        uint32_t red = 0, green = 0, blue = 0;
+        for (uint16_t led = 0; led < pin_configs[pin].total_leds; led++) {
+            red += leds[led].r;
+            green += leds[led].g;
+            blue += leds[led].b;
+        }
+        total_ma += (red * POWER_RED_MA + green * POWER_GREEN_MA + blue * POWER_BLUE_MA) / 255
+            + pin_configs[pin].total_leds * POWER_IDLE_MA;
+    }
+    return total_ma;
+}
+
+// Times the output pass over every LED on the controller: untrimmed, trimmed, and with every pin
+// over a power budget, against the rescan a separate limiter would add.
+// Enable with -DLED_KERNEL_BENCHMARK; runs once from setup() before the show starts, or on the
+// host from tools/benchmark.
+void runOutputBenchmark()
+{
+    const uint8_t iterations = 50;
+    OutputSettings saved;
+    getOutputSettings(saved);
+
+    for (uint8_t pin = 0; pin < NUM_PINS; pin++) {
+        for (uint16_t led = 0; led < pin_configs[pin].total_leds; led++) {
+            pin_configs[pin].led_array[led] = CRGB(led * 7, led * 13, led * 29);
+        }
+    }
+
+    Serial.println("=== Output stage benchmark (us per frame over all pins) ===");
+
+    static const char* const pass_names[3] = { "untrimmed", "trimmed", "limited" };
+    OutputSettings settings = saved;
+    for (uint8_t pass = 0; pass < 3; pass++) {
+        settings.gamma = 2.2f;
+        memset(settings.strip_trims, pass == 1 ? 200 : 255, sizeof(settings.strip_trims));
+        for (uint8_t pin = 0; pin < NUM_PINS; pin++) {
+            settings.pin_budgets_ma[pin] = pass == 2 ? 1000 : 0;
+        }
+        setOutputSettings(settings);
+
+        unsigned long start = micros();
+        buildOutputTables();
+        unsigned long build_time = micros() - start;
+
+        start = micros();
+        for (uint8_t n = 0; n < iterations; n++) {
+            renderOutputFrame();
+        }
+        Serial.printf("%-12s output %6lu  table build %6lu\n", pass_names[pass], (micros() - start) / iterations,
+            build_time);
+    }
+
+    unsigned long start = micros();
+    volatile uint32_t total_ma = 0;
+    for (uint8_t n = 0; n < iterations; n++) {
+        total_ma += rescanOutputPower();
+    }
+    Serial.printf("%-12s rescan %6lu\n", "reference", (micros() - start) / iterations);
+
+    setOutputSettings(saved);
+    for (uint8_t pin = 0; pin < NUM_PINS; pin++) {
+        fill_solid(pin_configs[pin].led_array, pin_configs[pin].total_leds, CRGB::Black);
+    }
+}
+
+#endif
@@ -0,0 +1,69 @@
+#ifndef OUTPUT_STAGE_H
+#define OUTPUT_STAGE_H
+
+#include "installation.h"
+#include "led_layout.h"
+#include <FastLED.h>
+
+// Last step before the LEDs: one pass over each pin buffer through per-channel lookup tables
+// into the buffers FastLED sends out. The tables combine gamma, white balance and the global
+// brightness, and are rebuilt only when those settings change; per-strip brightness trims are
+// applied in the same pass. The pin buffers keep the uncorrected frame, so patterns that update
+// their previous frame in place never see the calibration.
+//
+// Table entries are 8.8 fixed point. Output truncates to 8 bits, or with HIGH_PRECISION_RENDER
+// is dithered, along with the 16-bit strips of the render buffer.
+//
+// The same pass adds up what each pin's LEDs will draw, so a pin over its power budget is scaled
+// down before the frame goes out without scanning the buffers again. Currents follow FastLED's
+// WS2812 model.
+#define OUTPUT_DEFAULT_GAMMA 1.0f // LED levels stay linear; ~2.2 makes fades perceptually even
+#define OUTPUT_DEFAULT_WHITE_BALANCE CRGB(255, 176, 240) // FastLED's TypicalLEDStrip
+#define OUTPUT_DEFAULT_BRIGHTNESS 255
+#define OUTPUT_MIN_GAMMA 0.5f
+#define OUTPUT_MAX_GAMMA 3.0f
+#define DITHER_STEPS 16 // Frames in the dither cycle; fractions resolve to 1/16 of a step
+
+#define POWER_RED_MA 16 // Per channel at full level
+#define POWER_GREEN_MA 11
+#define POWER_BLUE_MA 15
+#define POWER_IDLE_MA 1 // Per LED, even when dark
+#ifndef POWER_PIN_BUDGET_MA
+#define POWER_PIN_BUDGET_MA 0 // Default budget per pin; 0 leaves pins unlimited
+#endif
+
+struct OutputSettings {
+    float gamma;
+    CRGB white_balance; // Level each channel reaches at full white
+    uint8_t brightness; // Global brightness, 255 = full
+    uint8_t strip_trims[LOCAL_STRIP_COUNT]; // Per-strip brightness, 255 = full
+    uint16_t pin_budgets_ma[NUM_PINS]; // Most each pin's supply may deliver, 0 = unlimited
+};
+
+struct OutputPowerStats {
+    uint16_t pin_ma[NUM_PINS]; // Estimated draw of the last frame sent, after limiting
+    uint8_t pin_scale[NUM_PINS]; // Limiter scale applied to each pin, 255 = none
+    uint32_t limited_frames; // Frames where any pin was scaled down
+};
+
+void getOutputSettings(OutputSettings& settings);
+void setOutputSettings(const OutputSettings& settings);
+void resetOutputStage();
+
+void getOutputPowerStats(OutputPowerStats& stats);
+
+void renderOutputFrame();
+void renderOutputSolid(const CRGB& color);
+void showOutputFrame();
+
+// loop() and the frame watchdog's stall guard, on the other core, both send frames. Whichever
+// renders into the output buffers holds them until FastLED.show() has sent them
+void lockOutput();
+bool tryLockOutput();
+void unlockOutput();
+
+#ifdef LED_KERNEL_BENCHMARK
+void runOutputBenchmark();
+#endif
+
+#endif
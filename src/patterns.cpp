@@ -1,6 +1,15 @@
 #include "patterns.h"
+#include "effect_queue.h"
+#include "frame_recorder.h"
+#include "latency_trace.h"
+#include "live_preview.h"
+#include "output_stage.h"
+#include "profiler.h"
+#include "stream_input.h"
+#include "telemetry.h"
 
 PatternQueue pattern_queue = { .queue_size = 0, .queue_start_time = 0, .is_running = false };
+FrameShownHook frame_shown_hook = NULL;
 
 CRGB& getLED(uint8_t strip_id, uint16_t led_index)
 {
@@ -17,14 +26,11 @@ CRGB& getLED(uint8_t strip_id, uint16_t led_index)
 void configureStripDirections()
 {
     // Configure strip directions from the configuration array
-    extern bool strip_reverse_config[22];
+    extern bool strip_reverse_config[LOCAL_STRIP_COUNT];
 
-    Serial.println("Configuring strip directions...");
-
-    for (uint8_t i = 0; i < 22; i++) {
+    // printStripConfigs() reports the directions along with the rest of the layout
+    for (uint8_t i = 0; i < LOCAL_STRIP_COUNT; i++) {
         strips[i].reverse_direction = strip_reverse_config[i];
-
-        Serial.printf("Strip %d: %s\n", i, strips[i].reverse_direction ? "REVERSED" : "FORWARD");
     }
 }
 
@@ -53,7 +59,7 @@ void testStripAddressing()
         test_strip_12[i] = CRGB::Blue;
     }
 
-    FastLED.show();
+    showOutputFrame();
     Serial.println("Address test complete - check if LEDs are lighting correctly");
 
     delay(3000); // Hold for 3 seconds
@@ -63,14 +69,14 @@ void testStripAddressing()
         test_strip_2[i] = CRGB::Black;
         test_strip_12[i] = CRGB::Black;
     }
-    FastLED.show();
+    showOutputFrame();
     Serial.println("Test LEDs cleared");
 }
 
 CRGBSet getStripSet(uint8_t strip_id)
 {
     // Create and return the appropriate CRGBSet based on direction configuration
-    if (strip_id >= 22) {
+    if (strip_id >= LOCAL_STRIP_COUNT) {
         // Return first strip as fallback for invalid IDs
         strip_id = 0;
     }
@@ -86,7 +92,7 @@ CRGBSet getStripSet(uint8_t strip_id)
 // Helper function to get the actual strip length (not CRGBSet.size() which may be wrong for reverse sets)
 uint16_t getStripLength(uint8_t strip_id)
 {
-    if (strip_id >= 22) {
+    if (strip_id >= LOCAL_STRIP_COUNT) {
         return 122; // Default strip length
     }
     return strips[strip_id].length;
@@ -96,9 +102,10 @@ bool isStripActiveInFlashBulb(uint8_t strip_id)
 {
     for (uint8_t i = 0; i < flashbulb_manager.pattern_count; i++) {
         FlashBulbPattern& flashbulb = flashbulb_manager.patterns[i];
-        // Only block chase patterns during FLASH and FADE_TO_BLACK phases
+        // Only block chase patterns during ATTACK, FLASH and FADE_TO_BLACK phases
         // Allow chase patterns during TRANSITION_BACK so we have colors to blend to
-        if (flashbulb.state == FLASHBULB_FLASH || flashbulb.state == FLASHBULB_FADE_TO_BLACK) {
+        if (flashbulb.state == FLASHBULB_ATTACK || flashbulb.state == FLASHBULB_FLASH
+            || flashbulb.state == FLASHBULB_FADE_TO_BLACK) {
             // Check if this strip is in the active FlashBulb pattern
             for (uint8_t j = 0; j < flashbulb.num_target_strips; j++) {
                 if (flashbulb.target_strips[j] == strip_id) {
@@ -110,6 +117,64 @@ bool isStripActiveInFlashBulb(uint8_t strip_id)
     return false;
 }
 
+// Like isStripActiveInFlashBulb(), but also counts the TRANSITION_BACK phase, which blends over
+// whatever the patterns rendered into the strip
+bool isStripInAnyFlashBulb(uint8_t strip_id)
+{
+    for (uint8_t i = 0; i < flashbulb_manager.pattern_count; i++) {
+        FlashBulbPattern& flashbulb = flashbulb_manager.patterns[i];
+        if (flashbulb.state == FLASHBULB_INACTIVE)
+            continue;
+
+        for (uint8_t j = 0; j < flashbulb.num_target_strips; j++) {
+            if (flashbulb.target_strips[j] == strip_id) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// True when nothing but this pattern writes to its target strips: no other running pattern
+// shares them, no FlashBulb touches them and no strip is listed twice
+bool patternHasExclusiveStrips(ChasePattern* pattern)
+{
+    uint32_t seen_strips = 0;
+    for (uint8_t i = 0; i < pattern->num_target_strips; i++) {
+        int8_t strip_id = getLocalStrip(pattern->target_strips[i]);
+        if (strip_id < 0)
+            continue;
+
+        uint32_t strip_bit = 1UL << strip_id;
+        if (seen_strips & strip_bit)
+            return false;
+        seen_strips |= strip_bit;
+
+        if (isStripInAnyFlashBulb(strip_id))
+            return false;
+    }
+
+    for (uint8_t p = 0; p < pattern_queue.queue_size; p++) {
+        ChasePattern& other_pattern = pattern_queue.patterns[p];
+        if (&other_pattern == pattern || !(other_pattern.is_active || other_pattern.is_transitioning))
+            continue;
+
+        for (uint8_t s = 0; s < other_pattern.num_target_strips; s++) {
+            int8_t strip_id = getLocalStrip(other_pattern.target_strips[s]);
+            if (strip_id >= 0 && (seen_strips & (1UL << strip_id)))
+                return false;
+        }
+    }
+    return true;
+}
+
+// A pattern may update its previous frame in place instead of redrawing it when that frame is
+// still intact in the strip buffers and the new frame is not being blended with a transition
+bool canRenderIncrementally(ChasePattern* pattern)
+{
+    return pattern->frame_valid && !pattern->is_transitioning && patternHasExclusiveStrips(pattern);
+}
+
 // Helper function to access LEDs with direction handling
 CRGB& getStripLED(uint8_t strip_id, uint16_t led_index)
 {
@@ -122,6 +187,107 @@ CRGB& getStripLED(uint8_t strip_id, uint16_t led_index)
     return strip_start[actual_index];
 }
 
+// Copy a strip's worth of LEDs given in logical order, honouring the strip's direction
+void copyToStrip(uint8_t strip_id, const CRGB* leds, uint16_t length)
+{
+    const StripConfig& strip = strips[strip_id];
+    CRGB* strip_start = strip.led_array_ptr + strip.start_offset;
+
+    if (!strip.reverse_direction) {
+        memcpy(strip_start, leds, length * sizeof(CRGB));
+    } else {
+        for (uint16_t led = 0; led < length; led++) {
+            strip_start[strip.length - 1 - led] = leds[led];
+        }
+    }
+}
+
+// Scratch strip for patterns whose output is the same on every target strip
+static CRGB canonical_strip[MAX_STRIP_LENGTH];
+
+// For patterns whose content is identical on every strip: render one canonical strip (once per
+// distinct strip length) and copy it to the rest of the group
+void replicateCanonicalStrip(ChasePattern* pattern, CanonicalStripRenderer renderer)
+{
+    uint16_t canonical_length = 0;
+
+    for (uint8_t i = 0; i < pattern->num_target_strips; i++) {
+        int8_t strip_id = getLocalStrip(pattern->target_strips[i]);
+        if (strip_id < 0)
+            continue;
+
+        // Skip strips that are currently active in FlashBulb patterns
+        if (isStripActiveInFlashBulb(strip_id)) {
+            continue;
+        }
+
+        uint16_t strip_length = getStripLength(strip_id);
+        if (strip_length > MAX_STRIP_LENGTH) {
+            // Too long for the scratch strip, render it in place
+            renderer(pattern, getStripSet(strip_id), strip_length);
+            continue;
+        }
+
+        if (strip_length != canonical_length) {
+            renderer(pattern, canonical_strip, strip_length);
+            canonical_length = strip_length;
+        }
+        copyToStrip(strip_id, canonical_strip, strip_length);
+    }
+}
+
+// For patterns that light every strip with the same solid color
+void fillStripsWithColor(ChasePattern* pattern, const CRGB& color)
+{
+    for (uint8_t i = 0; i < pattern->num_target_strips; i++) {
+        int8_t strip_id = getLocalStrip(pattern->target_strips[i]);
+        if (strip_id < 0)
+            continue;
+
+        // Skip strips that are currently active in FlashBulb patterns
+        if (isStripActiveInFlashBulb(strip_id)) {
+            continue;
+        }
+
+        getStripSet(strip_id).fill_solid(color);
+    }
+}
+
+#if HIGH_PRECISION_RENDER
+void fillStripsWithColor16(ChasePattern* pattern, const CRGB16& color)
+{
+    for (uint8_t i = 0; i < pattern->num_target_strips; i++) {
+        int8_t strip_id = getLocalStrip(pattern->target_strips[i]);
+        if (strip_id < 0)
+            continue;
+
+        // Skip strips that are currently active in FlashBulb patterns
+        if (isStripActiveInFlashBulb(strip_id)) {
+            continue;
+        }
+
+        fillStrip16(strip_id, color);
+    }
+}
+#endif
+
+// For patterns where each strip is one solid color that depends only on its index in the group
+void fillStripsPerIndex(ChasePattern* pattern, StripColorRenderer renderer)
+{
+    for (uint8_t i = 0; i < pattern->num_target_strips; i++) {
+        int8_t strip_id = getLocalStrip(pattern->target_strips[i]);
+        if (strip_id < 0)
+            continue;
+
+        // Skip strips that are currently active in FlashBulb patterns
+        if (isStripActiveInFlashBulb(strip_id)) {
+            continue;
+        }
+
+        getStripSet(strip_id).fill_solid(renderer(pattern, i));
+    }
+}
+
 void updatePatternPalette(ChasePattern* pattern)
 {
     // Convert CRGB palette to FastLED CRGBPalette16 for optimized operations
@@ -168,6 +334,22 @@ unsigned long convertSpeedToDelay(uint8_t speed)
     return 20 - ((speed - 1) * 19 / 99);
 }
 
+uint8_t frameBeatsin8(uint8_t bpm, uint8_t lowest, uint8_t highest)
+{
+    // Same arithmetic as FastLED's beat88() with bpm in Q8.8, so the waveform is unchanged
+    uint16_t beat = ((uint32_t)current_time * ((uint32_t)bpm << 8) * 280) >> 16;
+    uint8_t beat_sin = sin8(beat >> 8);
+    return lowest + scale8(beat_sin, highest - lowest);
+}
+
+// frameBeatsin8() at full resolution, for levels that feed the 16-bit render buffer
+uint16_t frameBeatsin16(uint8_t bpm, uint16_t lowest, uint16_t highest)
+{
+    uint16_t beat = ((uint32_t)current_time * ((uint32_t)bpm << 8) * 280) >> 16;
+    uint16_t beat_sin = sin16(beat) + 32768;
+    return lowest + scale16(beat_sin, highest - lowest);
+}
+
 void addPatternToQueue(PatternType pattern_type, const PaletteConfig& palette_config,
     const StripGroupConfig& strip_config, uint8_t speed, unsigned long transition_delay, uint16_t transition_duration)
 {
@@ -198,6 +380,8 @@ void addPatternToQueue(PatternType pattern_type, const PaletteConfig& palette_co
     pattern.is_transitioning = false;
     pattern.transition_start_time = 0;
     pattern.transition_duration = transition_duration;
+    pattern.frame_valid = false;
+    pattern.rendered_position = 0;
     
     // Initialize parameters to zero (caller should use the overload with PatternParams for custom config)
     memset(&pattern.params, 0, sizeof(PatternParams));
@@ -237,6 +421,8 @@ void addPatternToQueue(PatternType pattern_type, const PaletteConfig& palette_co
     pattern.is_transitioning = false;
     pattern.transition_start_time = 0;
     pattern.transition_duration = transition_duration;
+    pattern.frame_valid = false;
+    pattern.rendered_position = 0;
     
     // Copy custom parameters
     pattern.params = params;
@@ -244,10 +430,24 @@ void addPatternToQueue(PatternType pattern_type, const PaletteConfig& palette_co
     pattern_queue.queue_size++;
 }
 
+// A cycle lasts until 5 seconds after the last pattern has started
+static unsigned long getPatternQueueLoopTime()
+{
+    unsigned long max_delay = 0;
+    for (uint8_t i = 0; i < pattern_queue.queue_size; i++) {
+        if (pattern_queue.patterns[i].transition_delay > max_delay) {
+            max_delay = pattern_queue.patterns[i].transition_delay;
+        }
+    }
+    return max_delay + 5000;
+}
+
+// Cycles start on multiples of the loop time on the show clock, so controllers sharing a show
+// clock run the same part of the program whenever they were started
 void startPatternQueue()
 {
     if (pattern_queue.queue_size > 0) {
-        pattern_queue.queue_start_time = current_time;
+        pattern_queue.queue_start_time = current_time - current_time % getPatternQueueLoopTime();
         pattern_queue.is_running = true;
 
         // Initialize all patterns
@@ -272,17 +472,7 @@ void updatePatternQueue()
         return;
 
     unsigned long elapsed_time = current_time - pattern_queue.queue_start_time;
-
-    // Find the maximum transition delay to know when to loop
-    unsigned long max_delay = 0;
-    for (uint8_t i = 0; i < pattern_queue.queue_size; i++) {
-        if (pattern_queue.patterns[i].transition_delay > max_delay) {
-            max_delay = pattern_queue.patterns[i].transition_delay;
-        }
-    }
-
-    // Add some time after the last pattern starts before looping (e.g., 5 seconds)
-    unsigned long loop_time = max_delay + 5000;
+    unsigned long loop_time = getPatternQueueLoopTime();
 
     // Check each pattern to see if it should start based on its transition delay
     for (uint8_t i = 0; i < pattern_queue.queue_size; i++) {
@@ -295,6 +485,7 @@ void updatePatternQueue()
             pattern.transition_start_time = current_time;
             pattern.last_update = current_time;
             pattern.chase_position = 0;
+            pattern.frame_valid = false;
 
             // Mark any existing patterns on these strips as transitioning out
             for (uint8_t j = 0; j < pattern_queue.queue_size; j++) {
@@ -335,10 +526,11 @@ void updatePatternQueue()
         }
     }
 
-    // Loop the queue when enough time has passed
+    // Loop the queue when enough time has passed. The new cycle starts back on the show clock's
+    // grid, which also brings the queue back in line after the clock has been stepped (a step
+    // backwards makes elapsed_time wrap around)
     if (elapsed_time >= loop_time) {
-        // Reset the queue start time to create a loop
-        pattern_queue.queue_start_time = current_time;
+        pattern_queue.queue_start_time = current_time - current_time % loop_time;
 
         // Reset all patterns to inactive so they can start again
         for (uint8_t i = 0; i < pattern_queue.queue_size; i++) {
@@ -350,23 +542,40 @@ void updatePatternQueue()
 
 void runQueuedPattern()
 {
-    if (!pattern_queue.is_running || pattern_queue.queue_size == 0)
-        return;
+    bool any_pattern_updated = false;
+    if (isStreamInputActive()) {
+        // A streamed frame is the base layer instead of the patterns. Effects are only composited
+        // onto a freshly pushed frame, so they never stack up on one already shown
+        if (!takeStreamFrame())
+            return;
+        any_pattern_updated = true;
+    } else {
+        if (!pattern_queue.is_running || pattern_queue.queue_size == 0)
+            return;
 
-    updatePatternQueue();
+        {
+            PROFILE_STAGE(STAGE_PATTERN_QUEUE);
+            updatePatternQueue();
+        }
 
-    // Run all active or transitioning chase patterns FIRST (to set base pattern)
-    bool any_pattern_updated = false;
-    for (uint8_t i = 0; i < pattern_queue.queue_size; i++) {
-        ChasePattern& pattern = pattern_queue.patterns[i];
-        if (pattern.is_active || pattern.is_transitioning) {
-            runPattern(&pattern);
-            any_pattern_updated = true;
+        // Run all active or transitioning chase patterns FIRST (to set base pattern)
+        for (uint8_t i = 0; i < pattern_queue.queue_size; i++) {
+            ChasePattern& pattern = pattern_queue.patterns[i];
+            if (pattern.is_active || pattern.is_transitioning) {
+                PROFILE_STAGE(STAGE_PATTERN_FIRST + pattern.pattern_type);
+                runPattern(&pattern);
+                any_pattern_updated = true;
+            }
         }
     }
 
-    // Update FlashBulb patterns LAST (they may override or blend with chase patterns)
-    updateFlashBulbPatterns();
+    // Update FlashBulb patterns LAST (they may override or blend with chase patterns), starting
+    // whatever sensors queued since the last frame first
+    {
+        PROFILE_STAGE(STAGE_FLASHBULBS);
+        applyQueuedEffects();
+        updateFlashBulbPatterns();
+    }
 
     // Check if any FlashBulb patterns are active
     for (uint8_t i = 0; i < flashbulb_manager.pattern_count; i++) {
@@ -376,10 +585,37 @@ void runQueuedPattern()
         }
     }
 
+    // Ripples are added on top of everything for this frame only
+    {
+        PROFILE_STAGE(STAGE_RIPPLES);
+        if (compositeRipples()) {
+            any_pattern_updated = true;
+        }
+    }
+
     // Only call FastLED.show() once per frame if any patterns updated
     if (any_pattern_updated) {
+        lockOutput();
+        {
+            PROFILE_STAGE(STAGE_OUTPUT);
+            renderOutputFrame();
+        }
+        PROFILE_STAGE(STAGE_SHOW);
         FastLED.show();
+        // Hash before letting go of the output: the stall guard may draw over it right after
+        captureShownFrame();
+        unlockOutput();
+        recordFrameShown();
+        traceFrameShown();
+        capturePreviewFrame();
+        if (frame_shown_hook != NULL) {
+            frame_shown_hook();
+        }
     }
+
+    // Hand the patterns back their own frame so nothing accumulates between updates
+    restoreRippleBackground();
+    clearRenderBuffer();
 }
 
 void setupPatternProgram()
@@ -399,9 +635,10 @@ void setupPatternProgram()
 
     static PaletteConfig sunset_palette = { { CRGB::Purple, CRGB::Magenta, CRGB::Orange, CRGB::Red }, 4 };
 
-    // Define strip group configurations
-    static StripGroupConfig all_strips
-        = { { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21 }, 22 };
+    // Define strip group configurations. Patterns on all strips span the whole installation
+    static StripGroupConfig all_strips = { {}, INSTALLATION_STRIP_COUNT };
+    for (uint8_t i = 0; i < INSTALLATION_STRIP_COUNT; i++)
+        all_strips.strips[i] = i;
 
     static StripGroupConfig outside = { { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13 }, 14 };
 
@@ -451,6 +688,14 @@ void setupPatternProgram()
     rainbowParams.rainbow.vertical_mode = true;         // Vertical rainbow mode
     addPatternToQueue(PATTERN_RAINBOW, rainbow_palette, all_strips, 50, pattern_five_delay, 1000, rainbowParams);
 
+    // Spatial sweep that follows the physical layout in strip_placements
+    // PatternParams spatialParams = {};
+    // spatialParams.spatial.mode = SPATIAL_SWEEP;
+    // spatialParams.spatial.direction[0] = 100; // Diagonal across the rings and upwards
+    // spatialParams.spatial.direction[2] = 60;
+    // spatialParams.spatial.color_cycles = 2.0f;
+    // addPatternToQueue(PATTERN_SPATIAL, rainbow_palette, all_strips, 40, pattern_five_delay + 10, 1000, spatialParams);
+
     // addPatternToQueue(PATTERN_SOLID, sunset_palette, exterior_rings, 1,
     //     60); // Solid sunset on exterior rings - speed irrelevant - starts after 10 seconds
     // addPatternToQueue(PATTERN_SINGLE_CHASE, cool_palette, inside, 100,
@@ -489,6 +734,9 @@ void runPattern(ChasePattern* pattern)
     case PATTERN_WARP:
         runWarpPattern(pattern);
         break;
+    case PATTERN_SPATIAL:
+        runSpatialPattern(pattern);
+        break;
     case PATTERN_CHASE:
     default:
         runChasePattern(pattern);
@@ -1,14 +1,22 @@
 #ifndef PATTERNS_H
 #define PATTERNS_H
 
+#include "installation.h"
+#include "render_buffer.h"
 #include <FastLED.h>
 
+struct StripPlacement {
+    int16_t start_mm[3]; // x, y, z of the strip's first LED (logical order)
+    int16_t end_mm[3]; // x, y, z of its last LED
+};
+
 struct PinConfig {
     uint8_t pin;
     uint8_t num_strips;
     uint16_t leds_per_strip;
     uint16_t total_leds;
-    CRGB* led_array;
+    CRGB* led_array; // Frame as rendered
+    CRGB* output_array; // Frame as sent, after the output stage's corrections
 };
 
 struct StripConfig {
@@ -23,9 +31,24 @@ struct StripConfig {
 
 #define MAX_QUEUE_SIZE 10
 #define MAX_PALETTE_SIZE 16
-#define MAX_TARGET_STRIPS 22
+#define MAX_TARGET_STRIPS INSTALLATION_STRIP_COUNT // Target strips are global ids
 #define MAX_FLASHBULB_PATTERNS 5
+#define MAX_FLASHBULB_ENVELOPES 4
+#define ENVELOPE_TABLE_SIZE 256 // Brightness table entries per envelope phase (indexed by progress)
+#define MAX_RIPPLES 32
+#define RIPPLE_STRIP_SPACING 10 // Strip spacing for ripples from other controllers' strips, in LED pitches
+#define RIPPLE_SPEED 120 // Wavefront speed in LED pitches per second
+#define RIPPLE_WIDTH 16 // Length of the wave's trailing tail in LED pitches
+#define RIPPLE_MAX_RADIUS 200 // Radius at which a ripple has faded out completely
+
+// Per-LED coordinates are three 10-bit fixed-point fractions of the installation's largest
+// extent, packed into one word as x:y:z
+#define LED_COORD_MAX 1023
+#define LED_COORD_X(coord) (((coord) >> 20) & LED_COORD_MAX)
+#define LED_COORD_Y(coord) (((coord) >> 10) & LED_COORD_MAX)
+#define LED_COORD_Z(coord) ((coord) & LED_COORD_MAX)
 #define MAX_CUSTOM_PARAMS 10
+#define MAX_STRIP_LENGTH 122 // Longest strip a canonical strip can be replicated to
 
 struct PaletteConfig {
     CRGB colors[MAX_PALETTE_SIZE];
@@ -37,7 +60,47 @@ struct StripGroupConfig {
     uint8_t count;
 };
 
-enum FlashBulbState { FLASHBULB_INACTIVE, FLASHBULB_FLASH, FLASHBULB_FADE_TO_BLACK, FLASHBULB_TRANSITION_BACK };
+// Active FlashBulb states follow the envelope phases in order (state - FLASHBULB_ATTACK = phase)
+enum FlashBulbState {
+    FLASHBULB_INACTIVE,
+    FLASHBULB_ATTACK,
+    FLASHBULB_FLASH,
+    FLASHBULB_FADE_TO_BLACK,
+    FLASHBULB_TRANSITION_BACK
+};
+
+enum EnvelopePhase {
+    ENVELOPE_ATTACK, // Flash color rises from black
+    ENVELOPE_HOLD, // Flash color at full brightness
+    ENVELOPE_DECAY, // Flash color falls to black
+    ENVELOPE_RECOVER, // Underlying pattern rises back from black
+    ENVELOPE_PHASE_COUNT
+};
+
+enum EnvelopeCurve {
+    CURVE_LINEAR,
+    CURVE_EXPONENTIAL, // Perceptually even steps, most of the change happens near full brightness
+    CURVE_GAMMA // Gamma 2.2 brightness
+};
+
+struct EnvelopePhaseConfig {
+    uint16_t duration_ms; // 0 skips the phase
+    EnvelopeCurve curve;
+};
+
+struct EnvelopeConfig {
+    EnvelopePhaseConfig phases[ENVELOPE_PHASE_COUNT];
+    CRGB flash_color;
+};
+
+struct FlashBulbEnvelope {
+    EnvelopeConfig config;
+    // Brightness per phase, indexed by (elapsed * 255 / duration); built once by addFlashBulbEnvelope()
+    uint8_t levels[ENVELOPE_PHASE_COUNT][ENVELOPE_TABLE_SIZE];
+#if HIGH_PRECISION_RENDER
+    uint16_t fine_levels[ENVELOPE_PHASE_COUNT][ENVELOPE_TABLE_SIZE]; // The same levels, 0-65535
+#endif
+};
 
 enum PatternType {
     PATTERN_CHASE,
@@ -47,7 +110,14 @@ enum PatternType {
     PATTERN_BREATHING,
     PATTERN_PINWHEEL,
     PATTERN_RAINBOW_HORIZONTAL,
-    PATTERN_WARP
+    PATTERN_WARP,
+    PATTERN_SPATIAL
+};
+
+enum SpatialMode {
+    SPATIAL_SWEEP, // Palette gradient along a direction
+    SPATIAL_RADIAL, // Palette rings around the center of the installation
+    SPATIAL_PLANE_WAVE // Brightness wave travelling along a direction
 };
 
 // Pattern-specific parameter configurations
@@ -88,6 +158,12 @@ struct PatternParams {
             bool fade_previous;          // fade out previous strip vs instant off
         } warp;
         
+        struct {
+            uint8_t mode;             // SpatialMode
+            int8_t direction[3];      // x, y, z direction of sweeps and plane waves
+            float color_cycles;       // 0.5-8.0, palette repeats across the installation
+        } spatial;
+
         // Solid patterns don't need additional parameters
         struct {
             uint8_t unused;           // placeholder
@@ -110,18 +186,44 @@ struct ChasePattern {
     bool is_transitioning;
     unsigned long transition_start_time;
     uint16_t transition_duration;
-    
+
+    // Incremental rendering state (chase and single chase)
+    bool frame_valid; // strips still hold this pattern's last untouched frame
+    uint16_t rendered_position; // chase_position the last frame was rendered at
+
     // Pattern-specific parameters
     PatternParams params;
 };
 
 struct FlashBulbPattern {
-    uint8_t target_strips[MAX_TARGET_STRIPS];
+    uint8_t target_strips[LOCAL_STRIP_COUNT]; // This controller's strips
     uint8_t num_target_strips;
+    uint8_t envelope_index; // Index into flashbulb_manager.envelopes
     FlashBulbState state;
     unsigned long start_time;
-    CRGB saved_colors[MAX_TARGET_STRIPS * 122]; // Store original colors for transition back
-    uint16_t saved_color_count;
+};
+
+// Where a ripple's origin lies relative to one of our strips. LEDs are a distance
+// sqrt(offset_squared + dx * dx) pitches from the origin, dx LEDs either side of foot_led
+struct RippleStripOffset {
+    int16_t foot_led; // LED nearest the origin, extended past the strip's ends
+    uint16_t offset_squared; // Square of the origin's distance from the strip, in LED pitches
+};
+
+struct Ripple {
+    bool active;
+    uint8_t origin_strip; // Global strip the wave starts from
+    uint16_t origin_led; // LED along that strip the wave starts from
+    unsigned long start_time;
+    CRGB color;
+    RippleStripOffset strip_offsets[LOCAL_STRIP_COUNT];
+};
+
+struct RippleManager {
+    Ripple ripples[MAX_RIPPLES];
+    // Pattern content of the strips the composite drew on, restored after FastLED.show()
+    CRGB saved_strips[LOCAL_STRIP_COUNT][MAX_STRIP_LENGTH];
+    uint32_t saved_strip_mask;
 };
 
 struct PatternQueue {
@@ -134,9 +236,11 @@ struct PatternQueue {
 struct FlashBulbManager {
     FlashBulbPattern patterns[MAX_FLASHBULB_PATTERNS];
     uint8_t pattern_count;
+    FlashBulbEnvelope envelopes[MAX_FLASHBULB_ENVELOPES];
+    uint8_t envelope_count;
 };
 
-// External references to global variables from main.cpp
+// External references to global variables from led_layout.cpp
 extern unsigned long current_time;
 extern PinConfig pin_configs[];
 extern StripConfig strips[];
@@ -146,10 +250,17 @@ extern CRGB pin3_leds[];
 extern CRGB pin4_leds[];
 extern CRGB pin5_leds[];
 extern CRGB pin6_leds[];
+extern StripPlacement strip_placements[];
+extern StripPlacement installation_bounds;
+
+// Called right after the render loop shows a frame, while ripples are still composited in
+typedef void (*FrameShownHook)();
+extern FrameShownHook frame_shown_hook;
 
 // External references to pattern managers
 extern PatternQueue pattern_queue;
 extern FlashBulbManager flashbulb_manager;
+extern RippleManager ripple_manager;
 
 // New strip configuration functions
 void configureStripDirections();
@@ -161,9 +272,24 @@ CRGB& getStripLED(uint8_t strip_id, uint16_t led_index);
 // FastLED optimization functions
 void updatePatternPalette(ChasePattern* pattern);
 
+// Replication of strip-invariant patterns: render once, copy to every target strip
+typedef void (*CanonicalStripRenderer)(ChasePattern* pattern, CRGB* leds, uint16_t length);
+typedef CRGB (*StripColorRenderer)(ChasePattern* pattern, uint8_t strip_index);
+void copyToStrip(uint8_t strip_id, const CRGB* leds, uint16_t length);
+void replicateCanonicalStrip(ChasePattern* pattern, CanonicalStripRenderer renderer);
+void fillStripsWithColor(ChasePattern* pattern, const CRGB& color);
+#if HIGH_PRECISION_RENDER
+void fillStripsWithColor16(ChasePattern* pattern, const CRGB16& color);
+#endif
+void fillStripsPerIndex(ChasePattern* pattern, StripColorRenderer renderer);
+
 // Universal speed conversion (1=slowest, 100=fastest)
 unsigned long convertSpeedToDelay(uint8_t speed);
 
+// beatsin8() on the frame clock (current_time) rather than millis(), so replays render identically
+uint8_t frameBeatsin8(uint8_t bpm, uint8_t lowest, uint8_t highest);
+uint16_t frameBeatsin16(uint8_t bpm, uint16_t lowest, uint16_t highest);
+
 
 // Pattern queue functions
 void addPatternToQueue(PatternType pattern_type, const PaletteConfig& palette_config,
@@ -184,6 +310,9 @@ void runPattern(ChasePattern* pattern);
 // Chase pattern functions
 void runChasePattern(ChasePattern* pattern);
 bool isStripActiveInFlashBulb(uint8_t strip_id);
+bool isStripInAnyFlashBulb(uint8_t strip_id);
+bool patternHasExclusiveStrips(ChasePattern* pattern);
+bool canRenderIncrementally(ChasePattern* pattern);
 
 // Solid pattern functions
 void runSolidPattern(ChasePattern* pattern);
@@ -200,13 +329,32 @@ void runPinwheelPattern(ChasePattern* pattern);
 // Warp pattern functions
 void runWarpPattern(ChasePattern* pattern);
 
+// LED coordinate map (built once from strip_placements)
+void buildLEDCoordinateMap();
+uint32_t getLEDCoordinate(uint8_t strip_id, uint16_t led_index);
+uint8_t getLEDRadius(uint8_t strip_id, uint16_t led_index);
+
+// Spatial pattern functions and kernels
+void runSpatialPattern(ChasePattern* pattern);
+void renderSweepStrip(uint8_t strip_id, const CRGBPalette16& palette, const int8_t direction[3], float color_cycles,
+    uint8_t phase);
+void renderRadialStrip(uint8_t strip_id, const CRGBPalette16& palette, float color_cycles, uint8_t phase);
+void renderPlaneWaveStrip(uint8_t strip_id, const CRGBPalette16& palette, const int8_t direction[3],
+    float color_cycles, uint8_t phase);
+
 // FlashBulb pattern functions
 void initFlashBulbManager();
-void addFlashBulbPattern(uint8_t* target_strips, uint8_t num_target_strips);
+uint8_t addFlashBulbEnvelope(const EnvelopeConfig& config);
+uint8_t addFlashBulbPattern(uint8_t* target_strips, uint8_t num_target_strips, uint8_t envelope_index = 0);
 void triggerFlashBulb(uint8_t pattern_index);
 void updateFlashBulbPatterns();
 void runFlashBulbPattern(FlashBulbPattern* pattern);
 
+// Ripple effect functions
+void initRippleManager();
+void launchRipple(uint8_t origin_strip, uint16_t origin_led, const CRGB& color);
+bool compositeRipples();
+void restoreRippleBackground();
 
 // Example program setup
 void setupPatternProgram();
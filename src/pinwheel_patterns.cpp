@@ -1,3 +1,4 @@
+#include "led_kernels.h"
 #include "patterns.h"
 
 void runPinwheelPattern(ChasePattern* pattern)
@@ -28,8 +29,8 @@ void runPinwheelPattern(ChasePattern* pattern)
         
         // Fill all LEDs with interpolated colors based on angle from center
         for (uint8_t strip_idx = 0; strip_idx < pattern->num_target_strips; strip_idx++) {
-            uint8_t strip_id = pattern->target_strips[strip_idx];
-            if (strip_id >= 22) continue;
+            int8_t strip_id = getLocalStrip(pattern->target_strips[strip_idx]);
+            if (strip_id < 0) continue;
             
             if (isStripActiveInFlashBulb(strip_id)) continue;
             
@@ -85,8 +86,8 @@ void runPinwheelPattern(ChasePattern* pattern)
             unsigned long transition_elapsed = current_time - pattern->transition_start_time;
             if (transition_elapsed < pattern->transition_duration) {
                 for (uint8_t i = 0; i < pattern->num_target_strips; i++) {
-                    uint8_t strip_id = pattern->target_strips[i];
-                    if (strip_id >= 22) continue;
+                    int8_t strip_id = getLocalStrip(pattern->target_strips[i]);
+                    if (strip_id < 0) continue;
                     if (isStripActiveInFlashBulb(strip_id)) continue;
                     
                     CRGBSet strip_set = getStripSet(strip_id);
@@ -102,7 +103,7 @@ void runPinwheelPattern(ChasePattern* pattern)
                     } else {
                         // Transitioning out
                         uint8_t fade_amount = (transition_elapsed * 255) / pattern->transition_duration;
-                        strip_set.fadeToBlackBy(fade_amount);
+                        fadeLEDsToBlackBy(strip_set, strip_set.size(), fade_amount);
                     }
                 }
             }
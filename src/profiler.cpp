@@ -0,0 +1,110 @@
+#include "profiler.h"
+
+#if FRAME_PROFILING
+
+#include "logger.h"
+#include <Arduino.h>
+
+#ifndef ARDUINO
+#include <chrono>
+#endif
+
+static Histogram stage_histograms[STAGE_COUNT];
+static uint32_t ticks_per_us = 1;
+static unsigned long last_report_time = 0;
+
+// Slowest stage since takeSlowestStage() last asked, for the frame watchdog
+static uint8_t slowest_stage = STAGE_COUNT;
+static uint32_t slowest_stage_us = 0;
+
+static const char* const stage_names[STAGE_COUNT] = { "frame", "websocket", "stream input", "pattern queue", "chase",
+    "solid", "single chase", "rainbow", "breathing", "pinwheel", "rainbow horiz", "warp", "spatial", "flashbulbs",
+    "ripples", "output", "show" };
+
+uint32_t readProfileClock()
+{
+#ifdef ARDUINO
+    return ESP.getCycleCount();
+#else
+    return (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+#endif
+}
+
+void initProfiler()
+{
+#ifdef ARDUINO
+    ticks_per_us = ESP.getCpuFreqMHz();
+#else
+    ticks_per_us = 1000;
+#endif
+    resetProfiler();
+}
+
+void resetProfiler()
+{
+    for (uint8_t stage = 0; stage < STAGE_COUNT; stage++) {
+        resetHistogram(stage_histograms[stage]);
+    }
+}
+
+void recordStageTime(uint8_t stage, uint32_t ticks)
+{
+    recordStageMicros(stage, ticks / ticks_per_us);
+}
+
+void recordStageMicros(uint8_t stage, uint32_t us)
+{
+    if (stage >= STAGE_COUNT)
+        return;
+
+    recordHistogram(stage_histograms[stage], us);
+    if (stage != STAGE_FRAME && us > slowest_stage_us) {
+        slowest_stage = stage;
+        slowest_stage_us = us;
+    }
+}
+
+// The stage that took longest since the last call, and how long. Returns false when no stage has
+// been timed since
+bool takeSlowestStage(uint8_t& stage, uint32_t& us)
+{
+    stage = slowest_stage;
+    us = slowest_stage_us;
+    slowest_stage = STAGE_COUNT;
+    slowest_stage_us = 0;
+    return stage < STAGE_COUNT;
+}
+
+bool getStageStats(uint8_t stage, HistogramStats& stats)
+{
+    return stage < STAGE_COUNT && getHistogramStats(stage_histograms[stage], stats);
+}
+
+const char* getStageName(uint8_t stage)
+{
+    return stage < STAGE_COUNT ? stage_names[stage] : "";
+}
+
+// Log the stages seen since the last report every PROFILE_REPORT_INTERVAL, then start over
+void reportProfiler()
+{
+    unsigned long now = millis();
+    if (now - last_report_time < PROFILE_REPORT_INTERVAL)
+        return;
+    last_report_time = now;
+
+    LOG_INFO("Frame profile (us): stage count min p50 p99 max");
+    for (uint8_t stage = 0; stage < STAGE_COUNT; stage++) {
+        HistogramStats stats;
+        if (getStageStats(stage, stats)) {
+            LOG_INFO("  %-14s %7lu %6lu %6lu %6lu %6lu", getStageName(stage), (unsigned long)stats.count,
+                (unsigned long)stats.min_us, (unsigned long)stats.p50_us, (unsigned long)stats.p99_us,
+                (unsigned long)stats.max_us);
+        }
+    }
+    resetProfiler();
+}
+
+#endif
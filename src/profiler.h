@@ -0,0 +1,72 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include "histogram.h"
+#include <stdint.h>
+
+// Per-stage frame timing. Scoped timers read the CPU cycle counter on the ESP32 (a monotonic
+// clock elsewhere) and feed fixed-bucket histograms. Build with -DFRAME_PROFILING=0 to compile
+// every timer out.
+#ifndef FRAME_PROFILING
+#define FRAME_PROFILING 1
+#endif
+
+#define PROFILE_REPORT_INTERVAL 10000 // ms between serial reports
+
+enum ProfileStage {
+    STAGE_FRAME, // Whole loop() iteration
+    STAGE_WEBSOCKET,
+    STAGE_STREAM_INPUT,
+    STAGE_PATTERN_QUEUE,
+    STAGE_PATTERN_FIRST, // One stage per PatternType, in PatternType order
+    STAGE_FLASHBULBS = STAGE_PATTERN_FIRST + 9,
+    STAGE_RIPPLES,
+    STAGE_OUTPUT,
+    STAGE_SHOW,
+    STAGE_COUNT
+};
+
+#if FRAME_PROFILING
+
+void initProfiler();
+uint32_t readProfileClock();
+void recordStageTime(uint8_t stage, uint32_t ticks);
+void recordStageMicros(uint8_t stage, uint32_t us);
+bool getStageStats(uint8_t stage, HistogramStats& stats);
+bool takeSlowestStage(uint8_t& stage, uint32_t& us);
+const char* getStageName(uint8_t stage);
+void resetProfiler();
+void reportProfiler();
+
+class ScopedStageTimer {
+public:
+    explicit ScopedStageTimer(uint8_t stage)
+        : stage(stage)
+        , start(readProfileClock())
+    {
+    }
+    ~ScopedStageTimer() { recordStageTime(stage, readProfileClock() - start); }
+
+private:
+    uint8_t stage;
+    uint32_t start;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_STAGE(stage) ScopedStageTimer PROFILE_CONCAT(stage_timer_, __LINE__)(stage)
+
+#else
+
+inline void initProfiler() { }
+inline bool getStageStats(uint8_t, HistogramStats&) { return false; }
+inline bool takeSlowestStage(uint8_t&, uint32_t&) { return false; }
+inline const char* getStageName(uint8_t) { return ""; }
+inline void resetProfiler() { }
+inline void reportProfiler() { }
+
+#define PROFILE_STAGE(stage)
+
+#endif
+
+#endif
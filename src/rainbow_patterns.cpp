@@ -1,7 +1,18 @@
+#include "led_kernels.h"
 #include "patterns.h"
 
 #define SPEED_MULTIPLIER 5
 
+// Every strip shows the same rainbow, so it is rendered once and replicated
+static void renderRainbowStrip(ChasePattern* pattern, CRGB* leds, uint16_t length)
+{
+    // Use FastLED's fill_rainbow for smooth rainbow effect
+    // Higher speed = faster rainbow cycling, so divide by (101 - speed) to invert the relationship
+    uint8_t speed_divisor = (101 - pattern->speed) * SPEED_MULTIPLIER;
+    uint8_t start_hue = (current_time / speed_divisor) % 256; // Rotating rainbow
+    fill_rainbow(leds, length, start_hue, 255 / length);
+}
+
 void runRainbowPattern(ChasePattern* pattern)
 {
     unsigned long speed_delay = convertSpeedToDelay(pattern->speed);
@@ -9,29 +20,25 @@ void runRainbowPattern(ChasePattern* pattern)
         pattern->last_update = current_time;
 
         // Apply rainbow pattern to all target strips using FastLED's HSV
-        for (uint8_t i = 0; i < pattern->num_target_strips; i++) {
-            uint8_t strip_id = pattern->target_strips[i];
-            if (strip_id >= 22)
-                continue;
-
-            // Skip strips that are currently active in FlashBulb patterns
-            if (isStripActiveInFlashBulb(strip_id)) {
-                continue;
-            }
-
-            CRGBSet strip_set = getStripSet(strip_id);
-            uint16_t strip_length = getStripLength(strip_id);
+        replicateCanonicalStrip(pattern, renderRainbowStrip);
+
+        // Apply transition blending if transitioning
+        if (pattern->is_transitioning) {
+            unsigned long transition_elapsed = current_time - pattern->transition_start_time;
+            if (transition_elapsed < pattern->transition_duration) {
+                for (uint8_t i = 0; i < pattern->num_target_strips; i++) {
+                    int8_t strip_id = getLocalStrip(pattern->target_strips[i]);
+                    if (strip_id < 0)
+                        continue;
+
+                    // Skip strips that are currently active in FlashBulb patterns
+                    if (isStripActiveInFlashBulb(strip_id)) {
+                        continue;
+                    }
 
-            // Use FastLED's fill_rainbow for smooth rainbow effect
-            // Higher speed = faster rainbow cycling, so divide by (101 - speed) to invert the relationship
-            uint8_t speed_divisor = (101 - pattern->speed) * SPEED_MULTIPLIER;
-            uint8_t start_hue = (current_time / speed_divisor) % 256;  // Rotating rainbow
-            fill_rainbow(strip_set, strip_length, start_hue, 255 / strip_length);
+                    CRGBSet strip_set = getStripSet(strip_id);
+                    uint16_t strip_length = getStripLength(strip_id);
 
-            // Apply transition blending if transitioning
-            if (pattern->is_transitioning) {
-                unsigned long transition_elapsed = current_time - pattern->transition_start_time;
-                if (transition_elapsed < pattern->transition_duration) {
                     if (!pattern->is_active) {
                         // Transitioning in
                         uint8_t transition_blend = (transition_elapsed * 255) / pattern->transition_duration;
@@ -43,7 +50,7 @@ void runRainbowPattern(ChasePattern* pattern)
                     } else {
                         // Transitioning out
                         uint8_t fade_amount = (transition_elapsed * 255) / pattern->transition_duration;
-                        strip_set.fadeToBlackBy(fade_amount);
+                        fadeLEDsToBlackBy(strip_set, strip_set.size(), fade_amount);
                     }
                 }
             }
@@ -51,4 +58,4 @@ void runRainbowPattern(ChasePattern* pattern)
 
         pattern->chase_position = (pattern->chase_position + 1) % 256;
     }
-}
\ No newline at end of file
+}
@@ -0,0 +1,80 @@
+#include "render_buffer.h"
+#include "patterns.h"
+
+#if HIGH_PRECISION_RENDER
+
+// 16-bit strip contents in physical LED order, like the pin buffers
+static CRGB16 fine_strips[LOCAL_STRIP_COUNT][MAX_STRIP_LENGTH];
+static uint32_t fine_strip_mask = 0; // Strips holding 16-bit values this frame
+
+void initRenderBuffer()
+{
+    fine_strip_mask = 0;
+}
+
+static uint16_t getFineStripLength(uint8_t strip_id)
+{
+    return min(getStripLength(strip_id), (uint16_t)MAX_STRIP_LENGTH);
+}
+
+static void setFine(CRGB16& fine, const CRGB& led)
+{
+    fine.r = led.r << 8;
+    fine.g = led.g << 8;
+    fine.b = led.b << 8;
+}
+
+void fillStrip16(uint8_t strip_id, const CRGB16& color)
+{
+    if (strip_id >= LOCAL_STRIP_COUNT)
+        return;
+
+    CRGB16* fine = fine_strips[strip_id];
+    uint16_t length = getFineStripLength(strip_id);
+    for (uint16_t led = 0; led < length; led++) {
+        fine[led] = color;
+    }
+    getStripSet(strip_id).fill_solid(CRGB(color.r >> 8, color.g >> 8, color.b >> 8));
+    fine_strip_mask |= 1UL << strip_id;
+}
+
+// Scale a strip in place by level (0-65535). Starts from its 16-bit values where an earlier stage
+// left them, and from the pin buffer everywhere else
+void scaleStrip16(uint8_t strip_id, uint16_t level)
+{
+    if (strip_id >= LOCAL_STRIP_COUNT)
+        return;
+
+    CRGB* leds = getStripSet(strip_id);
+    CRGB16* fine = fine_strips[strip_id];
+    uint16_t length = getFineStripLength(strip_id);
+    bool has_fine = fine_strip_mask & (1UL << strip_id);
+    uint32_t scale = (uint32_t)level + 1;
+
+    for (uint16_t led = 0; led < length; led++) {
+        if (!has_fine || !holdsFineValue(leds[led], fine[led]))
+            setFine(fine[led], leds[led]);
+
+        fine[led].r = (fine[led].r * scale) >> 16;
+        fine[led].g = (fine[led].g * scale) >> 16;
+        fine[led].b = (fine[led].b * scale) >> 16;
+        leds[led] = CRGB(fine[led].r >> 8, fine[led].g >> 8, fine[led].b >> 8);
+    }
+    fine_strip_mask |= 1UL << strip_id;
+}
+
+// A strip's 16-bit values in physical LED order, or NULL when it only holds 8-bit values this frame
+const CRGB16* getFineStrip(uint8_t strip_id)
+{
+    if (strip_id >= LOCAL_STRIP_COUNT || !(fine_strip_mask & (1UL << strip_id)))
+        return NULL;
+    return fine_strips[strip_id];
+}
+
+// Called once the frame has gone out; the next frame starts in 8 bits everywhere
+void clearRenderBuffer()
+{
+    fine_strip_mask = 0;
+}
+
+#endif
@@ -0,0 +1,61 @@
+#ifndef RENDER_BUFFER_H
+#define RENDER_BUFFER_H
+
+#include <FastLED.h>
+
+// Optional 16-bit render buffer for the stages that work at low brightness, where 8-bit steps
+// show: the breathing pattern and the FlashBulb envelopes write 8.8 fixed-point channels here
+// instead of rounding straight to CRGB. The output stage dithers the fractions into a per-LED
+// temporal pattern, so over a few frames each LED averages out at its 16-bit value. Build with
+// -DHIGH_PRECISION_RENDER=1 to enable.
+//
+// The pin buffers hold the truncated 8-bit frame for everything else that reads or writes them,
+// so incremental rendering and transitions see exactly what 8-bit rendering would have left. An
+// LED written in 8 bits after its 16-bit value no longer matches it, and the 8-bit write wins.
+//
+// Cost: the dithered output pass over all 2,684 LEDs takes about 19 us a frame on an x86 host,
+// against 4 us for the 8-bit pass (the output benchmark, pio run -e benchmark with this flag added).
+// The ESP32 figure is still missing: nobody has run it on a board yet. A build with
+// -DLED_KERNEL_BENCHMARK -DHIGH_PRECISION_RENDER=1 prints it at boot.
+#ifndef HIGH_PRECISION_RENDER
+#define HIGH_PRECISION_RENDER 0
+#endif
+
+// 8.8 fixed point per channel: the high byte is the 8-bit value, the low byte the fraction
+struct CRGB16 {
+    uint16_t r;
+    uint16_t g;
+    uint16_t b;
+};
+
+// color scaled by level (0-65535), the 16-bit counterpart of CRGB::nscale8()
+inline CRGB16 scaleColor16(const CRGB& color, uint16_t level)
+{
+    uint32_t scale = (uint32_t)level + 1;
+    CRGB16 scaled = { (uint16_t)((color.r * scale) >> 8), (uint16_t)((color.g * scale) >> 8),
+        (uint16_t)((color.b * scale) >> 8) };
+    return scaled;
+}
+
+// True while an LED still holds the truncated 16-bit value, i.e. no 8-bit stage has written it
+inline bool holdsFineValue(const CRGB& led, const CRGB16& fine)
+{
+    return led.r == fine.r >> 8 && led.g == fine.g >> 8 && led.b == fine.b >> 8;
+}
+
+#if HIGH_PRECISION_RENDER
+
+void initRenderBuffer();
+void fillStrip16(uint8_t strip_id, const CRGB16& color);
+void scaleStrip16(uint8_t strip_id, uint16_t level);
+const CRGB16* getFineStrip(uint8_t strip_id);
+void clearRenderBuffer();
+
+#else
+
+inline void initRenderBuffer() { }
+inline void clearRenderBuffer() { }
+
+#endif
+
+#endif
@@ -0,0 +1,233 @@
+#include "patterns.h"
+
+#define RIPPLE_OUT_OF_REACH UINT16_MAX // offset_squared of a strip the wave never reaches
+
+RippleManager ripple_manager;
+
+// Average LED pitch in coordinate map units, to measure distances on the map in LED pitches
+static float ripple_pitch = 1.0f;
+
+void initRippleManager()
+{
+    // The coordinate map is built by initializeStripConfigs()
+    float total_pitch = 0.0f;
+    uint8_t measured_strips = 0;
+    for (uint8_t strip_id = 0; strip_id < LOCAL_STRIP_COUNT; strip_id++) {
+        uint16_t strip_length = min(getStripLength(strip_id), (uint16_t)MAX_STRIP_LENGTH);
+        if (strip_length < 2)
+            continue;
+
+        uint32_t first = getLEDCoordinate(strip_id, 0);
+        uint32_t last = getLEDCoordinate(strip_id, strip_length - 1);
+        float dx = (float)LED_COORD_X(last) - LED_COORD_X(first);
+        float dy = (float)LED_COORD_Y(last) - LED_COORD_Y(first);
+        float dz = (float)LED_COORD_Z(last) - LED_COORD_Z(first);
+        total_pitch += sqrtf(dx * dx + dy * dy + dz * dz) / (strip_length - 1);
+        measured_strips++;
+    }
+    ripple_pitch = measured_strips > 0 && total_pitch > 0.0f ? total_pitch / measured_strips : 1.0f;
+
+    for (uint8_t i = 0; i < MAX_RIPPLES; i++) {
+        ripple_manager.ripples[i].active = false;
+    }
+    ripple_manager.saved_strip_mask = 0;
+}
+
+// Place the origin relative to each of our strips from the LED coordinate map, so the wave
+// spreads across the sculpture as it is built: to the strips physically nearby, whatever their ids
+static void measureRippleFromMap(Ripple& ripple, uint8_t origin_strip_id)
+{
+    uint16_t origin_length = min(getStripLength(origin_strip_id), (uint16_t)MAX_STRIP_LENGTH);
+    uint32_t origin = getLEDCoordinate(origin_strip_id, min(ripple.origin_led, (uint16_t)(origin_length - 1)));
+    float origin_xyz[3] = { (float)LED_COORD_X(origin), (float)LED_COORD_Y(origin), (float)LED_COORD_Z(origin) };
+
+    for (uint8_t strip_id = 0; strip_id < LOCAL_STRIP_COUNT; strip_id++) {
+        RippleStripOffset& offset = ripple.strip_offsets[strip_id];
+        uint16_t strip_length = min(getStripLength(strip_id), (uint16_t)MAX_STRIP_LENGTH);
+        uint32_t first = getLEDCoordinate(strip_id, 0);
+        uint32_t last = getLEDCoordinate(strip_id, strip_length > 1 ? strip_length - 1 : 0);
+        float to_origin[3] = { origin_xyz[0] - LED_COORD_X(first), origin_xyz[1] - LED_COORD_Y(first),
+            origin_xyz[2] - LED_COORD_Z(first) };
+        float along[3] = { (float)LED_COORD_X(last) - LED_COORD_X(first),
+            (float)LED_COORD_Y(last) - LED_COORD_Y(first), (float)LED_COORD_Z(last) - LED_COORD_Z(first) };
+
+        // Project the origin onto the strip's line: the foot is the nearest point, the rest of
+        // the distance is straight across
+        float along_squared = 0.0f, projection = 0.0f, distance_squared = 0.0f;
+        for (uint8_t axis = 0; axis < 3; axis++) {
+            along_squared += along[axis] * along[axis];
+            projection += to_origin[axis] * along[axis];
+            distance_squared += to_origin[axis] * to_origin[axis];
+        }
+        float foot = 0.0f;
+        float across_squared = distance_squared;
+        if (along_squared > 0.0f) {
+            foot = projection / along_squared * (strip_length - 1);
+            across_squared = max(0.0f, distance_squared - projection * projection / along_squared);
+        }
+
+        float offset_squared = across_squared / (ripple_pitch * ripple_pitch) + 0.5f;
+        offset.foot_led = (int16_t)constrain(lroundf(foot), -RIPPLE_MAX_RADIUS, MAX_STRIP_LENGTH + RIPPLE_MAX_RADIUS);
+        offset.offset_squared = offset_squared < RIPPLE_MAX_RADIUS * RIPPLE_MAX_RADIUS ? (uint16_t)offset_squared
+                                                                                      : RIPPLE_OUT_OF_REACH;
+    }
+}
+
+// This controller doesn't know where other controllers' strips are, so a wave from one of them
+// spreads as if the strips stood side by side in id order, RIPPLE_STRIP_SPACING apart
+static void measureRippleByStripId(Ripple& ripple)
+{
+    for (uint8_t strip_id = 0; strip_id < LOCAL_STRIP_COUNT; strip_id++) {
+        RippleStripOffset& offset = ripple.strip_offsets[strip_id];
+        uint16_t across = abs((int16_t)(FIRST_LOCAL_STRIP + strip_id) - ripple.origin_strip) * RIPPLE_STRIP_SPACING;
+        offset.foot_led = ripple.origin_led;
+        offset.offset_squared = across < RIPPLE_MAX_RADIUS ? across * across : RIPPLE_OUT_OF_REACH;
+    }
+}
+
+// origin_strip is a global id: a ripple starting on another controller's strips still spreads
+// onto ours
+void launchRipple(uint8_t origin_strip, uint16_t origin_led, const CRGB& color)
+{
+    if (origin_strip >= INSTALLATION_STRIP_COUNT)
+        return;
+
+    // Take a free slot, or retire the oldest ripple when the pool is full
+    uint8_t slot = 0;
+    unsigned long oldest_age = 0;
+    for (uint8_t i = 0; i < MAX_RIPPLES; i++) {
+        if (!ripple_manager.ripples[i].active) {
+            slot = i;
+            break;
+        }
+        unsigned long age = current_time - ripple_manager.ripples[i].start_time;
+        if (age >= oldest_age) {
+            oldest_age = age;
+            slot = i;
+        }
+    }
+
+    Ripple& ripple = ripple_manager.ripples[slot];
+    ripple.active = true;
+    ripple.origin_strip = origin_strip;
+    ripple.origin_led = origin_led;
+    ripple.start_time = current_time;
+    ripple.color = color;
+
+    int8_t origin_strip_id = getLocalStrip(origin_strip);
+    if (origin_strip_id >= 0) {
+        measureRippleFromMap(ripple, origin_strip_id);
+    } else {
+        measureRippleByStripId(ripple);
+    }
+}
+
+static uint16_t squareRoot(uint32_t value)
+{
+    uint32_t root = 0;
+    for (uint32_t bit = 1UL << 30; bit != 0; bit >>= 2) {
+        if (value >= root + bit) {
+            value -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+    }
+    return root;
+}
+
+// Distance in whole LED pitches (rounded) of the LED dx along from the foot
+static uint16_t getRippleDistance(uint16_t offset_squared, uint16_t dx)
+{
+    uint32_t distance_squared = offset_squared + (uint32_t)dx * dx;
+    uint16_t root = squareRoot(distance_squared);
+    return distance_squared - (uint32_t)root * root > root ? root + 1 : root;
+}
+
+// First dx whose distance is greater than the given value. The rounded distance exceeds it once
+// offset_squared + dx^2 > value^2 + value, and only grows from there
+static uint16_t firstDistanceAbove(uint16_t offset_squared, int16_t value)
+{
+    if (value < 0)
+        return 0;
+    int32_t limit = (int32_t)value * value + value - offset_squared;
+    return limit < 0 ? 0 : squareRoot(limit) + 1;
+}
+
+// Keep a copy of the pattern's strip the first time a ripple draws on it this frame
+static void saveRippleStrip(uint8_t strip_id)
+{
+    uint32_t strip_bit = 1UL << strip_id;
+    if (ripple_manager.saved_strip_mask & strip_bit)
+        return;
+
+    memcpy(ripple_manager.saved_strips[strip_id], getStripSet(strip_id), getStripLength(strip_id) * sizeof(CRGB));
+    ripple_manager.saved_strip_mask |= strip_bit;
+}
+
+// Add every active ripple on top of the current frame. Only LEDs inside a wavefront are
+// visited, so the cost follows the number of lit LEDs rather than ripples x LEDs; the strips
+// drawn on are saved once per frame so restoreRippleBackground() can undo the composite.
+bool compositeRipples()
+{
+    bool any_active = false;
+    for (uint8_t r = 0; r < MAX_RIPPLES; r++) {
+        Ripple& ripple = ripple_manager.ripples[r];
+        if (!ripple.active)
+            continue;
+
+        // The front travels outward; the tail stretches RIPPLE_WIDTH behind it
+        unsigned long radius = (current_time - ripple.start_time) * RIPPLE_SPEED / 1000;
+        if (radius >= RIPPLE_MAX_RADIUS) {
+            ripple.active = false;
+            continue;
+        }
+        any_active = true;
+
+        uint8_t fade = 255 - (radius * 255) / RIPPLE_MAX_RADIUS;
+        int16_t inner = (int16_t)radius - RIPPLE_WIDTH;
+
+        for (uint8_t strip_id = 0; strip_id < LOCAL_STRIP_COUNT; strip_id++) {
+            const RippleStripOffset& offset = ripple.strip_offsets[strip_id];
+            if (offset.offset_squared > radius * radius)
+                continue; // The wave hasn't reached this strip yet
+
+            // LEDs inside the wave: inner < distance <= radius
+            uint16_t first_dx = firstDistanceAbove(offset.offset_squared, inner);
+            uint16_t end_dx = firstDistanceAbove(offset.offset_squared, radius);
+            int16_t strip_length = getStripLength(strip_id);
+            if (first_dx >= end_dx || strip_length > MAX_STRIP_LENGTH)
+                continue;
+
+            saveRippleStrip(strip_id);
+
+            for (uint16_t dx = first_dx; dx < end_dx; dx++) {
+                // Brightest at the front, fading towards the tail
+                uint8_t level = ((getRippleDistance(offset.offset_squared, dx) - inner) * 255) / RIPPLE_WIDTH;
+                CRGB color = ripple.color;
+                color.nscale8(scale8(level, fade));
+
+                int16_t ahead = offset.foot_led + dx;
+                int16_t behind = offset.foot_led - dx;
+                if (ahead >= 0 && ahead < strip_length) {
+                    getStripLED(strip_id, ahead) += color;
+                }
+                if (dx > 0 && behind >= 0 && behind < strip_length) {
+                    getStripLED(strip_id, behind) += color;
+                }
+            }
+        }
+    }
+    return any_active;
+}
+
+void restoreRippleBackground()
+{
+    for (uint8_t strip_id = 0; ripple_manager.saved_strip_mask != 0; strip_id++) {
+        uint32_t strip_bit = 1UL << strip_id;
+        if (ripple_manager.saved_strip_mask & strip_bit) {
+            memcpy(getStripSet(strip_id), ripple_manager.saved_strips[strip_id], getStripLength(strip_id) * sizeof(CRGB));
+            ripple_manager.saved_strip_mask &= ~strip_bit;
+        }
+    }
+}
@@ -0,0 +1,160 @@
+#include "sensor_config.h"
+#include "frame_recorder.h"
+#include "logger.h"
+#include "patterns.h"
+
+#ifdef ARDUINO
+#include <Preferences.h>
+
+static Preferences sensor_preferences;
+#endif
+
+SensorMapping sensor_mappings[SENSOR_TABLE_SIZE];
+uint32_t sensor_config_version = 0;
+
+static bool sensor_config_dirty = false;
+static unsigned long last_config_edit = 0;
+
+static const char* const sensor_effect_names[SENSOR_EFFECT_COUNT] = { "flashbulb", "ripple" };
+
+// Out-of-range strips, effects or envelopes would index past the effect tables
+static bool isValidSensorConfig(const SensorConfig& config)
+{
+    return (config.strip_mask & ~SENSOR_ALL_STRIPS) == 0 && config.effect < SENSOR_EFFECT_COUNT
+        && config.envelope_index < flashbulb_manager.envelope_count;
+}
+
+// Empty every entry, so no sensor lights anything up
+void clearSensorMappings()
+{
+    for (uint8_t id = 0; id < SENSOR_TABLE_SIZE; id++) {
+        sensor_mappings[id].config = SensorConfig();
+    }
+    sensor_config_version++;
+}
+
+// The installation's wiring: which strips each sensor lights up and how
+void loadDefaultSensorMappings()
+{
+    static const struct {
+        uint8_t sensor_id;
+        SensorConfig config;
+    } defaults[] = {
+        { 1, { 1UL << 0, DEFAULT_SENSOR_COOLDOWN, ENVELOPE_CLASSIC, SENSOR_EFFECT_FLASHBULB, true } },
+        { 2, { 1UL << 1, DEFAULT_SENSOR_COOLDOWN, ENVELOPE_CLASSIC, SENSOR_EFFECT_FLASHBULB, true } },
+        { 3, { 1UL << 2, DEFAULT_SENSOR_COOLDOWN, ENVELOPE_CLASSIC, SENSOR_EFFECT_FLASHBULB, false } },
+        { 4, { 0xFUL << 3, DEFAULT_SENSOR_COOLDOWN, ENVELOPE_CLASSIC, SENSOR_EFFECT_FLASHBULB, false } }, // Strips 3-6
+        { 5, { 0xFUL << 7, DEFAULT_SENSOR_COOLDOWN, ENVELOPE_EMBER, SENSOR_EFFECT_FLASHBULB, true } }, // Strips 7-10
+        { 6, { 1UL << 11, DEFAULT_SENSOR_COOLDOWN, ENVELOPE_CLASSIC, SENSOR_EFFECT_FLASHBULB, true } },
+        { 7, { 1UL << 12, DEFAULT_SENSOR_COOLDOWN, ENVELOPE_CLASSIC, SENSOR_EFFECT_RIPPLE, true } },
+        { 8, { 1UL << 13, DEFAULT_SENSOR_COOLDOWN, ENVELOPE_CLASSIC, SENSOR_EFFECT_FLASHBULB, true } },
+    };
+
+    clearSensorMappings();
+    for (uint8_t i = 0; i < sizeof(defaults) / sizeof(defaults[0]); i++) {
+        sensor_mappings[defaults[i].sensor_id].config = defaults[i].config;
+    }
+    recordSensorTable();
+}
+
+// Replace the table with the copy saved in flash. Returns false, leaving the table alone, when
+// nothing valid has been saved
+bool loadSensorMappings()
+{
+#ifdef ARDUINO
+    static SensorConfig configs[SENSOR_TABLE_SIZE];
+    sensor_preferences.begin("sensors", true);
+    uint8_t version = sensor_preferences.getUChar("version", 0);
+    size_t length = sensor_preferences.getBytes("table", configs, sizeof(configs));
+    sensor_preferences.end();
+
+    if (version != SENSOR_STORAGE_VERSION || length != sizeof(configs))
+        return false;
+
+    for (uint8_t id = 0; id < SENSOR_TABLE_SIZE; id++) {
+        if (!isValidSensorConfig(configs[id])) {
+            Serial.printf("Saved sensor table has an invalid entry for sensor %u, using defaults\n", id);
+            return false;
+        }
+    }
+
+    for (uint8_t id = 0; id < SENSOR_TABLE_SIZE; id++) {
+        sensor_mappings[id].config = configs[id];
+    }
+    sensor_config_version++;
+    recordSensorTable();
+    return true;
+#else
+    return false;
+#endif
+}
+
+void saveSensorMappings()
+{
+    sensor_config_dirty = false;
+
+#ifdef ARDUINO
+    static SensorConfig configs[SENSOR_TABLE_SIZE];
+    for (uint8_t id = 0; id < SENSOR_TABLE_SIZE; id++) {
+        configs[id] = sensor_mappings[id].config;
+    }
+
+    sensor_preferences.begin("sensors", false);
+    bool saved = sensor_preferences.putBytes("table", configs, sizeof(configs)) == sizeof(configs);
+    sensor_preferences.putUChar("version", SENSOR_STORAGE_VERSION);
+    sensor_preferences.end();
+
+    if (saved) {
+        LOG_INFO("Sensor table saved to flash");
+    } else {
+        LOG_ERROR("Sensor table could not be saved to flash");
+    }
+#endif
+}
+
+// Write edits to flash once they have settled for SENSOR_SAVE_DELAY, so a burst of edits from the
+// control page costs one flash write
+void updateSensorMappingStorage()
+{
+    if (sensor_config_dirty && current_time - last_config_edit >= SENSOR_SAVE_DELAY) {
+        saveSensorMappings();
+    }
+}
+
+// Mapping for an active sensor, or NULL for ids outside the table and inactive sensors
+SensorMapping* findSensorMapping(int sensor_id)
+{
+    if (sensor_id < 0 || sensor_id >= SENSOR_TABLE_SIZE || !sensor_mappings[sensor_id].config.active)
+        return NULL;
+    return &sensor_mappings[sensor_id];
+}
+
+bool setSensorConfig(int sensor_id, const SensorConfig& config)
+{
+    if (sensor_id < 0 || sensor_id >= SENSOR_TABLE_SIZE || !isValidSensorConfig(config))
+        return false;
+
+    sensor_mappings[sensor_id].config = config;
+    sensor_config_version++;
+    sensor_config_dirty = true;
+    last_config_edit = current_time;
+    recordSensorConfig(sensor_id, config);
+    return true;
+}
+
+// Expand a strip mask into strip ids in ascending order; returns how many
+uint8_t getSensorStrips(const SensorConfig& config, uint8_t* strip_ids)
+{
+    uint8_t count = 0;
+    for (uint8_t strip = 0; strip < SENSOR_STRIP_COUNT; strip++) {
+        if (config.strip_mask & (1ULL << strip)) {
+            strip_ids[count++] = strip;
+        }
+    }
+    return count;
+}
+
+const char* getSensorEffectName(uint8_t effect)
+{
+    return effect < SENSOR_EFFECT_COUNT ? sensor_effect_names[effect] : "";
+}
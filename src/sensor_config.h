@@ -0,0 +1,58 @@
+#ifndef SENSOR_CONFIG_H
+#define SENSOR_CONFIG_H
+
+#include "installation.h"
+#include <stdint.h>
+
+// Sensor id -> effect table. Ids index the table directly, so dispatching a sensor message is a
+// single lookup however many sensors are configured. Edits are saved to flash (NVS) once they
+// settle and loaded again at boot.
+#define SENSOR_TABLE_SIZE 64 // Sensor ids 0-63
+#define SENSOR_STRIP_COUNT INSTALLATION_STRIP_COUNT // Sensors map to global strip ids
+#define SENSOR_ALL_STRIPS INSTALLATION_ALL_STRIPS
+#define DEFAULT_SENSOR_COOLDOWN 15000 // ms a sensor ignores repeat triggers for
+#define SENSOR_SAVE_DELAY 2000 // ms without edits before the table is written to flash
+#define SENSOR_STORAGE_VERSION 2 // Bump when SensorConfig's layout changes
+
+// FlashBulb envelopes sensors can use (registered in setupFlashBulbEnvelopes())
+#define ENVELOPE_CLASSIC 0 // Built-in white flash
+#define ENVELOPE_EMBER 1
+
+// What a sensor trigger launches on its strips
+enum SensorEffect {
+    SENSOR_EFFECT_FLASHBULB, // Whole-strip flash shaped by the mapping's envelope
+    SENSOR_EFFECT_RIPPLE, // Wave spreading out from the strips in the envelope's flash color
+    SENSOR_EFFECT_COUNT
+};
+
+// The persisted part of a mapping
+struct SensorConfig {
+    uint64_t strip_mask; // Bit n set = global strip n
+    uint32_t cooldown_ms;
+    uint8_t envelope_index;
+    uint8_t effect; // SensorEffect
+    bool active;
+};
+
+struct SensorMapping {
+    SensorConfig config;
+    unsigned long last_trigger_time;
+    uint32_t trigger_count; // Triggers that launched an effect
+    uint32_t rejected_count; // Triggers ignored because the sensor was cooling down
+};
+
+extern SensorMapping sensor_mappings[SENSOR_TABLE_SIZE];
+extern uint32_t sensor_config_version; // Bumped on every change to the table
+
+void clearSensorMappings();
+void loadDefaultSensorMappings();
+bool loadSensorMappings();
+void saveSensorMappings();
+void updateSensorMappingStorage();
+
+SensorMapping* findSensorMapping(int sensor_id);
+bool setSensorConfig(int sensor_id, const SensorConfig& config);
+uint8_t getSensorStrips(const SensorConfig& config, uint8_t* strip_ids);
+const char* getSensorEffectName(uint8_t effect);
+
+#endif
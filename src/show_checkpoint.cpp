@@ -0,0 +1,212 @@
+#include "show_checkpoint.h"
+#include "logger.h"
+#include "show_clock.h"
+
+#ifdef ARDUINO
+#include <Preferences.h>
+#include <esp_system.h>
+
+static Preferences checkpoint_preferences;
+#endif
+
+static ShowCheckpoint loaded_checkpoint;
+static bool checkpoint_loaded = false;
+static unsigned long last_checkpoint_time = 0;
+static ShowCheckpointStats checkpoint_stats;
+
+// FNV-1a over what defines the pattern program, so state saved by another program (after a
+// reflash with a different queue) is never applied to this one
+static uint32_t getProgramSignature()
+{
+    uint32_t hash = 2166136261UL;
+    auto mix = [&hash](uint32_t value) {
+        for (uint8_t byte = 0; byte < 4; byte++) {
+            hash = (hash ^ ((value >> (byte * 8)) & 0xFF)) * 16777619UL;
+        }
+    };
+
+    mix(pattern_queue.queue_size);
+    for (uint8_t i = 0; i < pattern_queue.queue_size; i++) {
+        const ChasePattern& pattern = pattern_queue.patterns[i];
+        mix(pattern.pattern_type);
+        mix(pattern.transition_delay);
+        mix(pattern.transition_duration);
+        mix(pattern.speed);
+        for (uint8_t strip = 0; strip < pattern.num_target_strips && strip < MAX_TARGET_STRIPS; strip++) {
+            mix(pattern.target_strips[strip]);
+        }
+    }
+    return hash;
+}
+
+void captureShowCheckpoint(ShowCheckpoint& checkpoint)
+{
+    checkpoint = ShowCheckpoint();
+    checkpoint.program_signature = getProgramSignature();
+    checkpoint.show_time_us = (uint64_t)current_time * 1000;
+    checkpoint.queue_elapsed_ms = current_time - pattern_queue.queue_start_time;
+    checkpoint.queue_size = pattern_queue.queue_size;
+
+    for (uint8_t i = 0; i < pattern_queue.queue_size; i++) {
+        const ChasePattern& pattern = pattern_queue.patterns[i];
+        PatternCheckpoint& saved = checkpoint.patterns[i];
+        saved.since_transition_ms = current_time - pattern.transition_start_time;
+        saved.since_update_ms = current_time - pattern.last_update;
+        saved.chase_position = pattern.chase_position;
+        saved.flags = (pattern.is_active ? CHECKPOINT_PATTERN_ACTIVE : 0)
+            | (pattern.is_transitioning ? CHECKPOINT_PATTERN_TRANSITIONING : 0);
+    }
+
+    for (uint8_t id = 0; id < SENSOR_TABLE_SIZE; id++) {
+        const SensorMapping& mapping = sensor_mappings[id];
+        unsigned long since_trigger = current_time - mapping.last_trigger_time;
+        checkpoint.since_trigger_ms[id] = mapping.last_trigger_time != 0 && since_trigger < mapping.config.cooldown_ms
+            ? since_trigger
+            : CHECKPOINT_NO_TRIGGER;
+    }
+}
+
+// Put the show back into the checkpointed state. The pattern program must already be set up;
+// returns false, leaving the show alone, when the checkpoint belongs to a different program
+bool applyShowCheckpoint(const ShowCheckpoint& checkpoint)
+{
+    if (checkpoint.program_signature != getProgramSignature() || checkpoint.queue_size != pattern_queue.queue_size)
+        return false;
+
+    // Followers resume the show wherever their leader is now; only the cooldowns carry over
+    bool resume_show = setShowTimeUs(checkpoint.show_time_us);
+    current_time = getShowFrameTime();
+    applyShowState(checkpoint, resume_show);
+    return true;
+}
+
+// Put the patterns, when resume_show, and the sensor cooldowns into the checkpointed state as of
+// current_time. Leaves the show clock alone and doesn't check the program
+void applyShowState(const ShowCheckpoint& checkpoint, bool resume_show)
+{
+    if (resume_show) {
+        pattern_queue.queue_start_time = current_time - checkpoint.queue_elapsed_ms;
+        for (uint8_t i = 0; i < pattern_queue.queue_size; i++) {
+            ChasePattern& pattern = pattern_queue.patterns[i];
+            const PatternCheckpoint& saved = checkpoint.patterns[i];
+            pattern.transition_start_time = current_time - saved.since_transition_ms;
+            pattern.last_update = current_time - saved.since_update_ms;
+            pattern.chase_position = saved.chase_position;
+            pattern.is_active = saved.flags & CHECKPOINT_PATTERN_ACTIVE;
+            pattern.is_transitioning = saved.flags & CHECKPOINT_PATTERN_TRANSITIONING;
+            pattern.frame_valid = false; // The strips start out dark
+        }
+    }
+
+    for (uint8_t id = 0; id < SENSOR_TABLE_SIZE; id++) {
+        if (checkpoint.since_trigger_ms[id] != CHECKPOINT_NO_TRIGGER) {
+            sensor_mappings[id].last_trigger_time = current_time - checkpoint.since_trigger_ms[id];
+        }
+    }
+}
+
+#ifdef ARDUINO
+// Resets that cut a running show short. A power-on or a restart asked for (from the serial console,
+// an update) starts the show from the top, however recent the saved state
+static bool isUnplannedReset(esp_reset_reason_t reason)
+{
+    switch (reason) {
+    case ESP_RST_BROWNOUT:
+    case ESP_RST_PANIC:
+    case ESP_RST_INT_WDT:
+    case ESP_RST_TASK_WDT:
+    case ESP_RST_WDT:
+        return true;
+    default:
+        return false;
+    }
+}
+#endif
+
+// Read the saved checkpoint. Called first thing at boot: a valid one after an unplanned reset means
+// the controller went down in the middle of the show, and setup() resumes it without the layout
+// diagnostics. On any other boot the saved state is stale, so it is erased
+bool loadShowCheckpoint()
+{
+#ifdef ARDUINO
+    if (!isUnplannedReset(esp_reset_reason())) {
+        checkpoint_preferences.begin("show", false);
+        if (checkpoint_preferences.isKey("state")) {
+            checkpoint_preferences.remove("state");
+            Serial.println("Discarded the saved show state: not an unplanned reset");
+        }
+        checkpoint_preferences.end();
+        checkpoint_loaded = false;
+        return false;
+    }
+
+    checkpoint_preferences.begin("show", true);
+    uint8_t version = checkpoint_preferences.getUChar("version", 0);
+    size_t length = checkpoint_preferences.getBytes("state", &loaded_checkpoint, sizeof(loaded_checkpoint));
+    checkpoint_preferences.end();
+
+    checkpoint_loaded = version == SHOW_CHECKPOINT_VERSION && length == sizeof(loaded_checkpoint)
+        && loaded_checkpoint.queue_size <= MAX_QUEUE_SIZE;
+#else
+    checkpoint_loaded = false;
+#endif
+    return checkpoint_loaded;
+}
+
+// Apply the checkpoint loadShowCheckpoint() read, once the show has been set up for this boot
+bool restoreShowCheckpoint()
+{
+    if (!checkpoint_loaded)
+        return false;
+    checkpoint_loaded = false;
+
+    if (!applyShowCheckpoint(loaded_checkpoint)) {
+        Serial.println("Saved show state belongs to another pattern program, starting from the top");
+        return false;
+    }
+
+    Serial.printf("Resumed show at %lu ms, %lu ms into the pattern queue\n",
+        (unsigned long)(loaded_checkpoint.show_time_us / 1000), (unsigned long)loaded_checkpoint.queue_elapsed_ms);
+    checkpoint_stats.restored = true;
+    last_checkpoint_time = current_time;
+    return true;
+}
+
+static void saveShowCheckpoint()
+{
+#ifdef ARDUINO
+    static ShowCheckpoint checkpoint;
+    captureShowCheckpoint(checkpoint);
+
+    checkpoint_preferences.begin("show", false);
+    bool saved = checkpoint_preferences.putBytes("state", &checkpoint, sizeof(checkpoint)) == sizeof(checkpoint);
+    if (checkpoint_preferences.getUChar("version", 0) != SHOW_CHECKPOINT_VERSION) {
+        checkpoint_preferences.putUChar("version", SHOW_CHECKPOINT_VERSION);
+    }
+    checkpoint_preferences.end();
+
+    if (saved) {
+        checkpoint_stats.writes++;
+        LOG_DEBUG("Show state saved at %lu ms", current_time);
+    } else {
+        checkpoint_stats.failed_writes++;
+        LOG_ERROR("Show state could not be saved to flash");
+    }
+#endif
+    checkpoint_stats.last_write_time = current_time;
+}
+
+// Save the show state every SHOW_CHECKPOINT_INTERVAL while the pattern program runs
+void updateShowCheckpoint()
+{
+    if (!pattern_queue.is_running || current_time - last_checkpoint_time < SHOW_CHECKPOINT_INTERVAL)
+        return;
+
+    last_checkpoint_time = current_time;
+    saveShowCheckpoint();
+}
+
+void getShowCheckpointStats(ShowCheckpointStats& stats)
+{
+    stats = checkpoint_stats;
+}
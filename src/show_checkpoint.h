@@ -0,0 +1,58 @@
+#ifndef SHOW_CHECKPOINT_H
+#define SHOW_CHECKPOINT_H
+
+#include "patterns.h"
+#include "sensor_config.h"
+
+// The live show state a reset would lose, saved to flash (NVS) so a brownout, watchdog reset or
+// crash rejoins the show where it left off instead of starting the program from cue 0. Any other
+// boot (power-on, a restart on purpose) discards the saved state and starts from the top. The
+// whole state is one blob of about 400 bytes written every SHOW_CHECKPOINT_INTERVAL, never on
+// individual events. That is about 14 NVS entries per write, so the 1440 writes a day fill some
+// 160 NVS pages: around 40 erases a day of each page of the default 20 KB NVS partition, which
+// the flash's 100,000 erase cycles allow for several years. FlashBulbs and ripples last seconds
+// and are not saved.
+//
+// Times are stored relative to the show time of the checkpoint. A leader resumes its show clock
+// from that time; followers take the show time from their leader and only restore the sensor
+// cooldowns.
+#define SHOW_CHECKPOINT_INTERVAL 60000 // ms between flash writes; at most this much show is replayed
+#define SHOW_CHECKPOINT_VERSION 1 // Bump when ShowCheckpoint's layout changes
+#define CHECKPOINT_NO_TRIGGER 0xFFFFFFFFUL // Sensor not cooling down
+
+#define CHECKPOINT_PATTERN_ACTIVE 0x01
+#define CHECKPOINT_PATTERN_TRANSITIONING 0x02
+
+struct PatternCheckpoint {
+    uint32_t since_transition_ms; // Show time since the pattern's transition started
+    uint32_t since_update_ms; // Show time since it last advanced
+    uint16_t chase_position;
+    uint8_t flags; // CHECKPOINT_PATTERN_*
+};
+
+struct ShowCheckpoint {
+    uint32_t program_signature; // Identifies the pattern program the state belongs to
+    uint64_t show_time_us;
+    uint32_t queue_elapsed_ms; // Position in the current cycle of the pattern queue
+    uint8_t queue_size;
+    PatternCheckpoint patterns[MAX_QUEUE_SIZE];
+    uint32_t since_trigger_ms[SENSOR_TABLE_SIZE]; // Or CHECKPOINT_NO_TRIGGER
+};
+
+struct ShowCheckpointStats {
+    bool restored; // This boot resumed from a checkpoint
+    uint32_t writes; // Checkpoints written since boot
+    uint32_t failed_writes;
+    unsigned long last_write_time; // Show time of the last write, 0 before the first
+};
+
+bool loadShowCheckpoint();
+bool restoreShowCheckpoint();
+void updateShowCheckpoint();
+
+void captureShowCheckpoint(ShowCheckpoint& checkpoint);
+bool applyShowCheckpoint(const ShowCheckpoint& checkpoint);
+void applyShowState(const ShowCheckpoint& checkpoint, bool resume_show);
+void getShowCheckpointStats(ShowCheckpointStats& stats);
+
+#endif
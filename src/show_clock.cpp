@@ -0,0 +1,365 @@
+#include "show_clock.h"
+#include "logger.h"
+#include <Arduino.h>
+
+#ifdef ARDUINO
+#include <WiFiUdp.h>
+#include <esp_timer.h>
+
+static WiFiUDP clock_udp;
+static IPAddress leader_ip;
+#else
+#include <arpa/inet.h>
+#include <chrono>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+static int clock_socket = -1;
+static sockaddr_in leader_address_in;
+static sockaddr_in last_sender;
+#endif
+
+#define CLOCK_MAX_PACKETS_PER_POLL 8 // Bounds the time one loop() spends on sync traffic
+#define CLOCK_PHASE_GAIN 2 // Each correction removes 1/n of the measured offset error...
+#define CLOCK_FREQUENCY_GAIN 16 // ...and 1/n of the rate that would have caused it
+
+struct ClockSample {
+    uint64_t local_us; // Local time halfway through the exchange
+    int64_t offset_us; // Leader show time minus local time
+    uint32_t delay_us; // Round trip minus the leader's turnaround
+};
+
+static uint64_t readLocalClock()
+{
+#ifdef ARDUINO
+    return (uint64_t)esp_timer_get_time();
+#else
+    return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+#endif
+}
+
+static LocalClockSource local_clock = readLocalClock;
+static ShowClockRole clock_role = SHOW_CLOCK_LEADER;
+static const char* leader_host = NULL;
+static ShowClockStats clock_stats;
+
+// Show time = local + offset_base + (local - reference_local) * drift_ppb / 10^9
+static int64_t offset_base = 0;
+static uint64_t reference_local = 0;
+static int32_t drift_ppb = 0;
+
+// Responses to the current burst of requests
+static ClockSample clock_samples[CLOCK_BURST_SIZE];
+static uint8_t sample_count = 0;
+static uint8_t burst_sent = 0;
+static uint64_t burst_start_local = 0;
+static uint32_t corrections = 0;
+static bool clock_acquired = false;
+static uint64_t last_correction_local = 0; // Sample the model was last corrected from
+static uint64_t last_response_local = 0;
+static uint64_t last_request_local = 0;
+
+static unsigned long last_frame_time = 0;
+static bool frame_time_valid = false;
+
+static void finishClockBurst();
+
+static int64_t modelOffset(uint64_t local_us)
+{
+    return offset_base + (int64_t)(local_us - reference_local) * drift_ppb / 1000000000LL;
+}
+
+// Reads one waiting packet into packet; returns its length, 0 when nothing is waiting
+static int readClockPacket(ClockSyncPacket& packet)
+{
+#ifdef ARDUINO
+    int length = clock_udp.parsePacket();
+    if (length <= 0)
+        return 0;
+    clock_udp.read((uint8_t*)&packet, sizeof(packet));
+    return length;
+#else
+    if (clock_socket < 0)
+        return 0;
+    // One spare byte so an oversized packet shows up as the wrong length
+    uint8_t buffer[sizeof(packet) + 1];
+    socklen_t address_length = sizeof(last_sender);
+    ssize_t length = recvfrom(clock_socket, buffer, sizeof(buffer), 0, (sockaddr*)&last_sender, &address_length);
+    if (length <= 0)
+        return 0;
+    memcpy(&packet, buffer, min((size_t)length, sizeof(packet)));
+    return (int)length;
+#endif
+}
+
+static void replyClockPacket(const ClockSyncPacket& packet)
+{
+#ifdef ARDUINO
+    clock_udp.beginPacket(clock_udp.remoteIP(), clock_udp.remotePort());
+    clock_udp.write((const uint8_t*)&packet, sizeof(packet));
+    clock_udp.endPacket();
+#else
+    sendto(clock_socket, &packet, sizeof(packet), 0, (const sockaddr*)&last_sender, sizeof(last_sender));
+#endif
+}
+
+static void sendClockRequest(const ClockSyncPacket& packet)
+{
+#ifdef ARDUINO
+    clock_udp.beginPacket(leader_ip, SHOW_CLOCK_PORT);
+    clock_udp.write((const uint8_t*)&packet, sizeof(packet));
+    clock_udp.endPacket();
+#else
+    sendto(clock_socket, &packet, sizeof(packet), 0, (const sockaddr*)&leader_address_in, sizeof(leader_address_in));
+#endif
+}
+
+// Start the clock model. Followers will ask the leader at leader_address (dotted IPv4) for the
+// time, but nothing touches the network until beginShowClockSync(), so the show can render its
+// first frames on the clock before WiFi is up
+void initShowClock(ShowClockRole role, const char* leader_address)
+{
+    clock_role = role;
+    leader_host = leader_address;
+    clock_stats = ShowClockStats();
+    clock_stats.role = role;
+    offset_base = 0;
+    reference_local = local_clock();
+    drift_ppb = 0;
+    sample_count = 0;
+    burst_sent = CLOCK_BURST_SIZE;
+    burst_start_local = 0;
+    corrections = 0;
+    clock_acquired = false;
+    frame_time_valid = false;
+}
+
+// Open the sync port once the network is up. Leaders listen on SHOW_CLOCK_PORT; followers send
+// their requests from it
+void beginShowClockSync()
+{
+#ifdef ARDUINO
+    if (clock_role == SHOW_CLOCK_FOLLOWER)
+        leader_ip.fromString(leader_host);
+    clock_udp.begin(SHOW_CLOCK_PORT);
+#else
+    if (clock_socket >= 0)
+        close(clock_socket);
+    clock_socket = socket(AF_INET, SOCK_DGRAM, 0);
+    fcntl(clock_socket, F_SETFL, fcntl(clock_socket, F_GETFL) | O_NONBLOCK);
+
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    // Followers on one host can't share the port, so they take any free one
+    address.sin_port = clock_role == SHOW_CLOCK_LEADER ? htons(SHOW_CLOCK_PORT) : 0;
+    if (bind(clock_socket, (sockaddr*)&address, sizeof(address)) != 0) {
+        Serial.printf("Show clock: cannot bind UDP port %d\n", ntohs(address.sin_port));
+        close(clock_socket);
+        clock_socket = -1;
+        return;
+    }
+
+    if (clock_role == SHOW_CLOCK_FOLLOWER) {
+        leader_address_in = sockaddr_in();
+        leader_address_in.sin_family = AF_INET;
+        leader_address_in.sin_port = htons(SHOW_CLOCK_PORT);
+        inet_pton(AF_INET, leader_host, &leader_address_in.sin_addr);
+    }
+#endif
+
+    if (clock_role == SHOW_CLOCK_LEADER) {
+        Serial.printf("Show clock: leading on UDP port %d\n", SHOW_CLOCK_PORT);
+    } else {
+        Serial.printf("Show clock: following %s\n", leader_host);
+    }
+}
+
+void setLocalClockSource(LocalClockSource source)
+{
+    local_clock = source != NULL ? source : readLocalClock;
+}
+
+// Answer waiting sync packets and, on a follower, ask the leader for the time when one is due
+void updateShowClock()
+{
+    ClockSyncPacket packet;
+    for (uint8_t i = 0; i < CLOCK_MAX_PACKETS_PER_POLL; i++) {
+        int length = readClockPacket(packet);
+        if (length == 0)
+            break;
+        uint64_t receive_us = local_clock();
+
+        if (length != (int)sizeof(packet) || packet.magic != CLOCK_SYNC_MAGIC) {
+            clock_stats.rejected++;
+        } else if (clock_role == SHOW_CLOCK_LEADER && packet.type == CLOCK_SYNC_REQUEST) {
+            ClockSyncPacket response;
+            answerClockSyncRequest(packet, receive_us, response);
+            replyClockPacket(response);
+            clock_stats.requests++;
+        } else {
+            receiveClockSyncResponse(packet, receive_us);
+        }
+    }
+
+    if (clock_role != SHOW_CLOCK_FOLLOWER)
+        return;
+
+    // A burst of requests every interval, polled quickly at first so the drift estimate settles
+    uint64_t now = local_clock();
+    if (burst_sent < CLOCK_BURST_SIZE) {
+        if (now - last_request_local < CLOCK_BURST_SPACING * 1000ULL)
+            return;
+    } else {
+        uint32_t interval = corrections < CLOCK_ACQUIRE_BURSTS ? CLOCK_ACQUIRE_INTERVAL : CLOCK_SYNC_INTERVAL;
+        if (clock_stats.requests > 0 && now - burst_start_local < interval * 1000ULL)
+            return;
+        // Responses lost from the last burst won't come now; use what did
+        finishClockBurst();
+        burst_start_local = now;
+        burst_sent = 0;
+    }
+
+    ClockSyncPacket request = {};
+    request.magic = CLOCK_SYNC_MAGIC;
+    request.type = CLOCK_SYNC_REQUEST;
+    request.origin_us = now;
+    sendClockRequest(request);
+    last_request_local = now;
+    burst_sent++;
+    clock_stats.requests++;
+}
+
+uint64_t getShowTimeUs()
+{
+    uint64_t local = local_clock();
+    return local + modelOffset(local);
+}
+
+// Show time in ms, snapped down to the SHOW_FRAME_INTERVAL grid. Slewing can pull the clock back a
+// little; the frame time then holds still rather than repeating a frame. Only a step goes backwards
+unsigned long getShowFrameTime()
+{
+    unsigned long show_ms = (unsigned long)(getShowTimeUs() / 1000);
+    unsigned long frame_time = show_ms - show_ms % SHOW_FRAME_INTERVAL;
+    if (frame_time_valid && (long)(frame_time - last_frame_time) < 0)
+        return last_frame_time;
+
+    last_frame_time = frame_time;
+    frame_time_valid = true;
+    return frame_time;
+}
+
+// Continue the show clock from show_us, e.g. from a checkpoint after a reset. Only leaders own
+// their show time; returns false on followers, which keep tracking the leader
+bool setShowTimeUs(uint64_t show_us)
+{
+    if (clock_role != SHOW_CLOCK_LEADER)
+        return false;
+
+    reference_local = local_clock();
+    offset_base = (int64_t)(show_us - reference_local);
+    frame_time_valid = false;
+    return true;
+}
+
+// Leader side of an exchange: echo the follower's send time with our receive and transmit times
+void answerClockSyncRequest(const ClockSyncPacket& request, uint64_t receive_us, ClockSyncPacket& response)
+{
+    response = ClockSyncPacket();
+    response.magic = CLOCK_SYNC_MAGIC;
+    response.type = CLOCK_SYNC_RESPONSE;
+    response.origin_us = request.origin_us;
+    response.receive_us = receive_us + modelOffset(receive_us);
+    response.transmit_us = getShowTimeUs();
+}
+
+// Move the clock model towards sample: jump on the first sample or a large error, otherwise take
+// out part of the error and nudge the drift
+static void correctShowClock(const ClockSample& sample)
+{
+    int64_t model = modelOffset(sample.local_us);
+    int64_t error = sample.offset_us - model;
+    clock_stats.last_error_us = (int32_t)max(min(error, (int64_t)INT32_MAX), (int64_t)INT32_MIN);
+
+    if (!clock_acquired || error > CLOCK_STEP_THRESHOLD || error < -CLOCK_STEP_THRESHOLD) {
+        offset_base = sample.offset_us;
+        reference_local = sample.local_us;
+        frame_time_valid = false;
+        clock_stats.steps++;
+        if (clock_acquired) {
+            LOG_WARN("Show clock: stepped %ld ms to follow the leader", (long)(error / 1000));
+        } else {
+            LOG_INFO("Show clock: locked to the leader, offset %ld ms", (long)(sample.offset_us / 1000));
+        }
+        clock_acquired = true;
+    } else {
+        int64_t interval = (int64_t)(sample.local_us - last_correction_local);
+        int64_t drift = drift_ppb + error * 1000000000LL / max(interval, (int64_t)1) / CLOCK_FREQUENCY_GAIN;
+        drift_ppb = (int32_t)max(min(drift, (int64_t)CLOCK_MAX_DRIFT), (int64_t)-CLOCK_MAX_DRIFT);
+        offset_base = model + error / CLOCK_PHASE_GAIN;
+        reference_local = sample.local_us;
+    }
+
+    last_correction_local = sample.local_us;
+    clock_stats.round_trip_us = sample.delay_us;
+}
+
+// Correct the clock from the least delayed exchange of the burst, since queueing delay on either
+// end is what makes an exchange's offset wrong
+static void finishClockBurst()
+{
+    if (sample_count == 0)
+        return;
+
+    const ClockSample* best = &clock_samples[0];
+    for (uint8_t i = 1; i < sample_count; i++) {
+        if (clock_samples[i].delay_us < best->delay_us)
+            best = &clock_samples[i];
+    }
+    correctShowClock(*best);
+    sample_count = 0;
+    corrections++;
+}
+
+// Follower side: turn a response into an offset sample. Returns false for responses that are
+// malformed or belong to an earlier burst
+bool receiveClockSyncResponse(const ClockSyncPacket& response, uint64_t receive_us)
+{
+    if (clock_role != SHOW_CLOCK_FOLLOWER || response.magic != CLOCK_SYNC_MAGIC
+        || response.type != CLOCK_SYNC_RESPONSE || response.origin_us > receive_us
+        || response.transmit_us < response.receive_us) {
+        clock_stats.rejected++;
+        return false;
+    }
+    if (response.origin_us < burst_start_local || sample_count >= CLOCK_BURST_SIZE)
+        return false;
+    clock_stats.responses++;
+    last_response_local = receive_us;
+
+    uint64_t round_trip = receive_us - response.origin_us;
+    uint64_t turnaround = response.transmit_us - response.receive_us;
+    ClockSample& sample = clock_samples[sample_count++];
+    sample.local_us = response.origin_us + round_trip / 2;
+    sample.offset_us = ((int64_t)(response.receive_us - response.origin_us)
+                           + (int64_t)(response.transmit_us - receive_us))
+        / 2;
+    sample.delay_us = round_trip > turnaround ? (uint32_t)min(round_trip - turnaround, (uint64_t)UINT32_MAX) : 0;
+
+    if (sample_count == CLOCK_BURST_SIZE)
+        finishClockBurst();
+    return true;
+}
+
+void getShowClockStats(ShowClockStats& stats)
+{
+    stats = clock_stats;
+    stats.offset_us = modelOffset(local_clock());
+    stats.drift_ppb = drift_ppb;
+    stats.locked = clock_role == SHOW_CLOCK_LEADER
+        || (clock_acquired && local_clock() - last_response_local < CLOCK_LOCK_TIMEOUT * 1000ULL);
+}
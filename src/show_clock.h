@@ -0,0 +1,73 @@
+#ifndef SHOW_CLOCK_H
+#define SHOW_CLOCK_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Shared show clock for installations with several controllers. One controller leads and its own
+// clock is the show clock; followers ask it for the time over UDP, NTP style, and track its offset
+// and drift. Everything that renders runs on frame times taken from this clock, snapped to a fixed
+// SHOW_FRAME_INTERVAL grid, so every controller renders the same frame at the same moment.
+#define SHOW_CLOCK_PORT 4049
+#define SHOW_FRAME_INTERVAL 20 // ms between frames; keep it above the slowest controller's frame time
+#define CLOCK_SYNC_INTERVAL 1000 // ms between follower request bursts once acquired
+#define CLOCK_ACQUIRE_INTERVAL 250 // ms between bursts for the first CLOCK_ACQUIRE_BURSTS
+#define CLOCK_ACQUIRE_BURSTS 8
+#define CLOCK_BURST_SIZE 4 // Requests per burst; the clock is corrected from the least delayed one
+#define CLOCK_BURST_SPACING 10 // ms between requests in a burst
+#define CLOCK_STEP_THRESHOLD 20000 // us: larger errors jump the clock, smaller ones are slewed out
+#define CLOCK_MAX_DRIFT 500000 // ppb the local crystal may be corrected by
+#define CLOCK_LOCK_TIMEOUT 10000 // ms without a usable response before a follower reports unlocked
+#define CLOCK_SYNC_MAGIC 0x4E59534CUL // "LSYN"
+
+enum ShowClockRole {
+    SHOW_CLOCK_LEADER, // Show time is the local clock; answers followers
+    SHOW_CLOCK_FOLLOWER // Show time is the leader's, estimated from sync exchanges
+};
+
+enum ClockSyncType {
+    CLOCK_SYNC_REQUEST = 1,
+    CLOCK_SYNC_RESPONSE = 2
+};
+
+// Sent as is: both ends are little-endian
+struct ClockSyncPacket {
+    uint32_t magic;
+    uint8_t type; // ClockSyncType
+    uint8_t reserved[3];
+    uint64_t origin_us; // Follower local time the request was sent (t1)
+    uint64_t receive_us; // Leader show time the request arrived (t2)
+    uint64_t transmit_us; // Leader show time the response was sent (t3)
+};
+
+struct ShowClockStats {
+    uint8_t role; // ShowClockRole
+    bool locked; // Leaders always; followers while responses keep arriving
+    int64_t offset_us; // Show time minus local time
+    int32_t drift_ppb; // Rate correction applied to the local clock
+    int32_t last_error_us; // Last filtered measurement against the clock model
+    uint32_t round_trip_us; // Network delay of the last exchange the clock was corrected from
+    uint32_t requests; // Requests sent (followers) or answered (leaders)
+    uint32_t responses; // Responses received
+    uint32_t steps; // Times the clock jumped instead of slewing
+    uint32_t rejected; // Packets with a bad magic, type or length
+};
+
+// Local monotonic clock in microseconds; replaceable so host tests can simulate a crystal that
+// runs fast or slow
+typedef uint64_t (*LocalClockSource)();
+
+void initShowClock(ShowClockRole role, const char* leader_address);
+void beginShowClockSync();
+void setLocalClockSource(LocalClockSource source);
+void updateShowClock();
+
+uint64_t getShowTimeUs();
+unsigned long getShowFrameTime();
+bool setShowTimeUs(uint64_t show_us);
+
+void answerClockSyncRequest(const ClockSyncPacket& request, uint64_t receive_us, ClockSyncPacket& response);
+bool receiveClockSyncResponse(const ClockSyncPacket& response, uint64_t receive_us);
+void getShowClockStats(ShowClockStats& stats);
+
+#endif
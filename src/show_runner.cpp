@@ -0,0 +1,153 @@
+#include "show_runner.h"
+#include "effect_queue.h"
+#include "led_layout.h"
+#include "logger.h"
+#include "output_stage.h"
+#include "patterns.h"
+#include "render_buffer.h"
+#include "sensor_config.h"
+
+uint32_t unmatched_sensor_messages = 0;
+
+// Last time demoFlashBulb() fired
+static unsigned long last_demo_time = 0;
+
+// Write "a, b, c" into buffer for log messages
+void formatStripList(char* buffer, size_t size, const uint8_t* strip_ids, uint8_t count)
+{
+    size_t length = 0;
+    buffer[0] = '\0';
+    for (uint8_t i = 0; i < count && length < size; i++) {
+        length += snprintf(buffer + length, size - length, i == 0 ? "%u" : ", %u", strip_ids[i]);
+    }
+}
+
+// Launch the effect mapped to a sensor unless it is still cooling down. trace, when given, is
+// queued with the effect and started when the next frame applies it.
+void triggerSensor(int sensor_id, LatencyTrace* trace)
+{
+    SensorMapping* mapping = findSensorMapping(sensor_id);
+    if (mapping == NULL) {
+        unmatched_sensor_messages++;
+        return;
+    }
+    const SensorConfig& config = mapping->config;
+
+    unsigned long time_since_last = current_time - mapping->last_trigger_time;
+    if (mapping->last_trigger_time != 0 && time_since_last < config.cooldown_ms) {
+        // Too soon since last trigger
+        mapping->rejected_count++;
+        unsigned long wait_time = config.cooldown_ms - time_since_last;
+        LOG_INFO("Sensor %d trigger ignored - wait %lu more seconds", sensor_id, wait_time / 1000);
+        return;
+    }
+
+    uint8_t strip_ids[SENSOR_STRIP_COUNT];
+    uint8_t num_strips = getSensorStrips(config, strip_ids);
+    if (num_strips == 0)
+        return;
+
+    // Effects start with the next frame, merged with anything else triggered before it. Ripples
+    // launch from the middle of the mapped strips; controllers driving other strips they reach
+    // are sent the effect too
+    bool queued = startInstallationEffect(
+        config.effect, config.envelope_index, config.strip_mask, strip_ids[(num_strips - 1) / 2]);
+    if (!queued) {
+        LOG_DEBUG("Sensor %d trigger dropped - effect rate limit reached", sensor_id);
+        return;
+    }
+
+    mapping->last_trigger_time = current_time;
+    mapping->trigger_count++;
+    if (trace != NULL) {
+        queueLatencyTrace(*trace);
+    }
+
+    char strip_list[96];
+    formatStripList(strip_list, sizeof(strip_list), strip_ids, num_strips);
+    LOG_INFO("%s triggered on %u strips: %s", config.effect == SENSOR_EFFECT_RIPPLE ? "Ripple" : "FlashBulb",
+        num_strips, strip_list);
+}
+
+// Register the FlashBulb envelopes referenced by sensor_mappings (envelope 0 is built in)
+void setupFlashBulbEnvelopes()
+{
+    // Warm glow that swells in, smoulders out and lets the pattern return gently
+    EnvelopeConfig ember = {
+        { { 250, CURVE_GAMMA }, { 150, CURVE_LINEAR }, { 4000, CURVE_EXPONENTIAL }, { 2500, CURVE_GAMMA } },
+        CRGB(255, 147, 41)
+    };
+    addFlashBulbEnvelope(ember);
+}
+
+static void demoFlashBulb()
+{
+    if (current_time - last_demo_time >= 10000) { // Every 5 seconds
+        last_demo_time = current_time;
+
+        // Random number of strips (0-5)
+        uint8_t num_random_strips = random(0, 6);
+
+        if (num_random_strips > 0) {
+            // Create random strip array
+            uint8_t random_strips[5];
+            for (uint8_t i = 0; i < num_random_strips; i++) {
+                random_strips[i] = random(0, 13); // Random strip 0-21
+            }
+
+            // Add temporary FlashBulb pattern and trigger it
+            uint8_t pattern_index = addFlashBulbPattern(random_strips, num_random_strips);
+            triggerFlashBulb(pattern_index);
+
+            char strip_list[32];
+            formatStripList(strip_list, sizeof(strip_list), random_strips, num_random_strips);
+            LOG_INFO("FlashBulb demo triggered on %u strips: %s", num_random_strips, strip_list);
+        } else {
+            LOG_INFO("FlashBulb demo: No strips selected this time");
+        }
+    }
+}
+
+// Put the show back to its state at boot: empty LEDs, the pattern program and effect managers
+// freshly set up, and every sensor out of cooldown
+void resetShowState(uint32_t random_seed)
+{
+    randomSeed(random_seed);
+
+    for (uint8_t pin = 0; pin < NUM_PINS; pin++) {
+        fill_solid(pin_configs[pin].led_array, pin_configs[pin].total_leds, CRGB::Black);
+    }
+
+    // Setup the pattern program
+    setupPatternProgram();
+
+    // Initialize FlashBulb system
+    initFlashBulbManager();
+    setupFlashBulbEnvelopes();
+
+    // Initialize ripple effects
+    initRippleManager();
+    resetEffectQueue();
+    initRenderBuffer();
+    resetOutputStage();
+
+    for (uint8_t id = 0; id < SENSOR_TABLE_SIZE; id++) {
+        sensor_mappings[id].last_trigger_time = 0;
+    }
+    last_demo_time = 0;
+}
+
+// Everything loop() renders, after inputs have been handled
+void runShowFrame()
+{
+    // Run demo FlashBulb trigger (optional - comment out when using real sensors)
+    demoFlashBulb();
+
+    // Run the queued pattern program
+    runQueuedPattern();
+}
+
+void replaySensorTrigger(uint8_t sensor_id)
+{
+    triggerSensor(sensor_id, NULL);
+}
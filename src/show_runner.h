@@ -0,0 +1,22 @@
+#ifndef SHOW_RUNNER_H
+#define SHOW_RUNNER_H
+
+#include "latency_trace.h"
+#include <stddef.h>
+#include <stdint.h>
+
+// The show as loop() runs it once inputs have been handled: the pattern program, the FlashBulb
+// envelopes and demo, and sensor triggers through the sensor table. Nothing here touches the
+// hardware or the network, so the host tools run the same show and a recording made on the
+// controller replays frame for frame in the offline renderer.
+
+extern uint32_t unmatched_sensor_messages; // Sensor messages whose ID matched no active mapping
+
+void setupFlashBulbEnvelopes();
+void resetShowState(uint32_t random_seed);
+void runShowFrame();
+void triggerSensor(int sensor_id, LatencyTrace* trace);
+void replaySensorTrigger(uint8_t sensor_id);
+void formatStripList(char* buffer, size_t size, const uint8_t* strip_ids, uint8_t count);
+
+#endif
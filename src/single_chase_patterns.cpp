@@ -1,13 +1,49 @@
+#include "led_kernels.h"
 #include "patterns.h"
 
 #define SINGLE_CHASE_LENGTH 10
 
+// Fill the chase window that chase_position puts on screen (all other LEDs are black)
+static void fillSingleChaseWindow(ChasePattern* pattern, uint16_t chase_position, const CRGB& color)
+{
+    uint16_t strip_length = 122; // Assuming all strips are 122 LEDs
+    uint16_t total_chase_cycle = strip_length + SINGLE_CHASE_LENGTH;
+    uint16_t current_strip_index = (chase_position / total_chase_cycle) % pattern->num_target_strips;
+    uint16_t position_in_strip = chase_position % total_chase_cycle;
+
+    int8_t strip_id = getLocalStrip(pattern->target_strips[current_strip_index]);
+    if (strip_id < 0 || position_in_strip >= strip_length)
+        return; // Invalid, or on another controller's strip
+
+    uint16_t strip_length_actual = getStripLength(strip_id);
+    uint16_t chase_end = min((uint16_t)(position_in_strip + SINGLE_CHASE_LENGTH), strip_length_actual);
+    if (position_in_strip < strip_length_actual && chase_end > position_in_strip) {
+        CRGBSet strip_set = getStripSet(strip_id);
+        CRGBSet chase_window = strip_set(position_in_strip, chase_end - 1);
+        chase_window.fill_solid(color);
+    }
+}
+
 void runSingleChasePattern(ChasePattern* pattern)
 {
     unsigned long speed_delay = convertSpeedToDelay(pattern->speed);
     if (current_time - pattern->last_update >= speed_delay) {
         pattern->last_update = current_time;
 
+        // Only the chase window moves, so when the strips still hold the previous frame it is
+        // enough to erase the old window and draw the new one
+        if (canRenderIncrementally(pattern)) {
+            fillSingleChaseWindow(pattern, pattern->rendered_position, CRGB::Black);
+            fillSingleChaseWindow(pattern, pattern->chase_position, CRGB::White);
+
+            pattern->rendered_position = pattern->chase_position;
+            uint16_t total_pattern_cycle = pattern->num_target_strips * (122 + SINGLE_CHASE_LENGTH);
+            pattern->chase_position = (pattern->chase_position + 1) % total_pattern_cycle;
+            return;
+        }
+        pattern->frame_valid = !pattern->is_transitioning && patternHasExclusiveStrips(pattern);
+        pattern->rendered_position = pattern->chase_position;
+
         // Calculate which strip is currently active and position within that strip
         uint16_t strip_length = 122; // Assuming all strips are 122 LEDs
         uint16_t total_chase_cycle = strip_length + SINGLE_CHASE_LENGTH; // Length + gap (132 total)
@@ -16,8 +52,8 @@ void runSingleChasePattern(ChasePattern* pattern)
 
         // First, set all target strips to black
         for (uint8_t i = 0; i < pattern->num_target_strips; i++) {
-            uint8_t strip_id = pattern->target_strips[i];
-            if (strip_id >= 22)
+            int8_t strip_id = getLocalStrip(pattern->target_strips[i]);
+            if (strip_id < 0)
                 continue; // Invalid strip ID
 
             // Skip strips that are currently active in FlashBulb patterns
@@ -65,7 +101,7 @@ void runSingleChasePattern(ChasePattern* pattern)
                     } else {
                         // Transitioning out (fade out to black)
                         uint8_t fade_amount = (transition_elapsed * 255) / pattern->transition_duration;
-                        strip_set.fadeToBlackBy(fade_amount);
+                        fadeLEDsToBlackBy(strip_set, strip_set.size(), fade_amount);
                     }
                 }
             }
@@ -7,10 +7,17 @@ void runSolidPattern(ChasePattern* pattern)
     // Use the first color in the palette for solid pattern
     CRGB solid_color = (pattern->palette_size > 0) ? pattern->palette[0] : CRGB::Black;
 
-    // Apply solid color to all target strips
+    // Outside of transitions every strip gets the same color
+    if (!pattern->is_transitioning) {
+        // Use FastLED's built-in fill_solid function for better performance
+        fillStripsWithColor(pattern, solid_color);
+        return;
+    }
+
+    // Apply transition to all target strips
     for (uint8_t i = 0; i < pattern->num_target_strips; i++) {
-        uint8_t strip_id = pattern->target_strips[i];
-        if (strip_id >= 22)
+        int8_t strip_id = getLocalStrip(pattern->target_strips[i]);
+        if (strip_id < 0)
             continue; // Invalid strip ID
 
         // Skip strips that are currently active in FlashBulb patterns
@@ -20,32 +27,28 @@ void runSolidPattern(ChasePattern* pattern)
 
         CRGBSet strip_set = getStripSet(strip_id);
         
-        // Apply transition blending if transitioning
-        if (pattern->is_transitioning) {
-            unsigned long transition_elapsed = current_time - pattern->transition_start_time;
-
-            if (transition_elapsed < pattern->transition_duration) {
-                if (!pattern->is_active) {
-                    // Transitioning in (fade in from existing color to solid color)
-                    uint8_t transition_blend = (transition_elapsed * 255) / pattern->transition_duration;
-                    
-                    // Use FastLED's built-in blending for smooth transitions
-                    uint16_t strip_length = getStripLength(strip_id);
-                    for (uint16_t led = 0; led < strip_length; led++) {
-                        getStripLED(strip_id, led) = getStripLED(strip_id, led).lerp8(solid_color, transition_blend);
-                    }
-                } else {
-                    // Transitioning out (fade out to black)
-                    uint8_t fade_amount = (transition_elapsed * 255) / pattern->transition_duration;
-                    
-                    // Use FastLED's built-in fade function
-                    strip_set.fill_solid(solid_color);
-                    strip_set.fadeToBlackBy(fade_amount);
+        // Apply transition blending
+        unsigned long transition_elapsed = current_time - pattern->transition_start_time;
+
+        if (transition_elapsed < pattern->transition_duration) {
+            if (!pattern->is_active) {
+                // Transitioning in (fade in from existing color to solid color)
+                uint8_t transition_blend = (transition_elapsed * 255) / pattern->transition_duration;
+
+                // Use FastLED's built-in blending for smooth transitions
+                uint16_t strip_length = getStripLength(strip_id);
+                for (uint16_t led = 0; led < strip_length; led++) {
+                    getStripLED(strip_id, led) = getStripLED(strip_id, led).lerp8(solid_color, transition_blend);
                 }
+            } else {
+                // Transitioning out (fade out to black)
+                uint8_t fade_amount = (transition_elapsed * 255) / pattern->transition_duration;
+
+                // Every LED fades the same way, so fade the color once
+                CRGB faded_color = solid_color;
+                faded_color.fadeToBlackBy(fade_amount);
+                strip_set.fill_solid(faded_color);
             }
-        } else {
-            // Use FastLED's built-in fill_solid function for better performance
-            strip_set.fill_solid(solid_color);
         }
     }
 }
\ No newline at end of file
@@ -0,0 +1,118 @@
+#include "led_kernels.h"
+#include "patterns.h"
+
+#define SPEED_MULTIPLIER 5
+
+// Fixed-point factor (Q16) that turns a coordinate dotted with direction into a palette index,
+// so that color_cycles palette repeats span the installation along that direction
+static int32_t projectionScale(const int8_t direction[3], float color_cycles)
+{
+    float length = sqrtf(direction[0] * direction[0] + direction[1] * direction[1] + direction[2] * direction[2]);
+    if (length < 1.0f)
+        length = 1.0f;
+    return (int32_t)(color_cycles * 256.0f / (LED_COORD_MAX * length) * 65536.0f);
+}
+
+// Palette index of an LED's projection onto direction
+static inline uint8_t projectLED(uint32_t coord, const int8_t direction[3], int32_t scale_q16)
+{
+    int32_t dot = (int32_t)LED_COORD_X(coord) * direction[0] + (int32_t)LED_COORD_Y(coord) * direction[1]
+        + (int32_t)LED_COORD_Z(coord) * direction[2];
+    return (uint8_t)(((int64_t)dot * scale_q16) >> 16);
+}
+
+void renderSweepStrip(uint8_t strip_id, const CRGBPalette16& palette, const int8_t direction[3], float color_cycles,
+    uint8_t phase)
+{
+    int32_t scale_q16 = projectionScale(direction, color_cycles);
+    uint16_t strip_length = min(getStripLength(strip_id), (uint16_t)MAX_STRIP_LENGTH);
+
+    for (uint16_t led = 0; led < strip_length; led++) {
+        uint8_t palette_index = projectLED(getLEDCoordinate(strip_id, led), direction, scale_q16) + phase;
+        getStripLED(strip_id, led) = ColorFromPalette(palette, palette_index, 255, LINEARBLEND);
+    }
+}
+
+void renderRadialStrip(uint8_t strip_id, const CRGBPalette16& palette, float color_cycles, uint8_t phase)
+{
+    uint16_t cycles_q8 = (uint16_t)(color_cycles * 256.0f);
+    uint16_t strip_length = min(getStripLength(strip_id), (uint16_t)MAX_STRIP_LENGTH);
+
+    for (uint16_t led = 0; led < strip_length; led++) {
+        // Subtracting the phase makes the rings travel outwards
+        uint8_t palette_index = (uint8_t)(((uint32_t)getLEDRadius(strip_id, led) * cycles_q8) >> 8) - phase;
+        getStripLED(strip_id, led) = ColorFromPalette(palette, palette_index, 255, LINEARBLEND);
+    }
+}
+
+void renderPlaneWaveStrip(uint8_t strip_id, const CRGBPalette16& palette, const int8_t direction[3],
+    float color_cycles, uint8_t phase)
+{
+    int32_t scale_q16 = projectionScale(direction, color_cycles);
+    uint16_t strip_length = min(getStripLength(strip_id), (uint16_t)MAX_STRIP_LENGTH);
+
+    for (uint16_t led = 0; led < strip_length; led++) {
+        uint8_t projection = projectLED(getLEDCoordinate(strip_id, led), direction, scale_q16);
+
+        // Wave crests travel along the direction; the color drifts slowly along with them
+        uint8_t brightness = sin8(projection - phase);
+        getStripLED(strip_id, led) = ColorFromPalette(palette, projection / 2 + phase / 4, brightness, LINEARBLEND);
+    }
+}
+
+void runSpatialPattern(ChasePattern* pattern)
+{
+    updatePatternPalette(pattern);
+
+    unsigned long speed_delay = convertSpeedToDelay(pattern->speed);
+    if (current_time - pattern->last_update >= speed_delay) {
+        pattern->last_update = current_time;
+
+        // Higher speed = faster movement, so divide by (101 - speed) to invert the relationship
+        uint16_t speed_divisor = (101 - pattern->speed) * SPEED_MULTIPLIER;
+        uint8_t phase = (current_time / speed_divisor) % 256;
+
+        uint8_t mode = pattern->params.spatial.mode;
+        const int8_t* direction = pattern->params.spatial.direction;
+        float color_cycles = pattern->params.spatial.color_cycles;
+
+        for (uint8_t i = 0; i < pattern->num_target_strips; i++) {
+            int8_t strip_id = getLocalStrip(pattern->target_strips[i]);
+            if (strip_id < 0)
+                continue;
+
+            // Skip strips that are currently active in FlashBulb patterns
+            if (isStripActiveInFlashBulb(strip_id)) {
+                continue;
+            }
+
+            switch (mode) {
+            case SPATIAL_RADIAL:
+                renderRadialStrip(strip_id, pattern->fastled_palette, color_cycles, phase);
+                break;
+            case SPATIAL_PLANE_WAVE:
+                renderPlaneWaveStrip(strip_id, pattern->fastled_palette, direction, color_cycles, phase);
+                break;
+            case SPATIAL_SWEEP:
+            default:
+                renderSweepStrip(strip_id, pattern->fastled_palette, direction, color_cycles, phase);
+                break;
+            }
+
+            // Apply transition blending if transitioning
+            if (pattern->is_transitioning) {
+                unsigned long transition_elapsed = current_time - pattern->transition_start_time;
+                if (transition_elapsed < pattern->transition_duration) {
+                    CRGBSet strip_set = getStripSet(strip_id);
+                    if (pattern->is_active) {
+                        // Transitioning out
+                        uint8_t fade_amount = (transition_elapsed * 255) / pattern->transition_duration;
+                        fadeLEDsToBlackBy(strip_set, strip_set.size(), fade_amount);
+                    }
+                }
+            }
+        }
+
+        pattern->chase_position = (pattern->chase_position + 1) % 256;
+    }
+}
@@ -0,0 +1,212 @@
+#include "stream_input.h"
+#include "frame_recorder.h"
+#include "led_layout.h"
+#include "logger.h"
+#include "patterns.h"
+
+#ifdef ARDUINO
+#include <WiFiUdp.h>
+
+static WiFiUDP ddp_udp;
+#endif
+
+static StreamInputStats stream_stats;
+static unsigned long last_packet_time = 0;
+static bool stream_active = false;
+static bool frame_ready = false;
+static bool frame_damaged = false; // A sequence gap fell inside the frame being received
+static uint8_t last_sequence = 0;
+
+#ifdef ARDUINO
+static int readUdp(uint8_t* dest, size_t length)
+{
+    return ddp_udp.read(dest, length);
+}
+#endif
+
+void initStreamInput()
+{
+    stream_stats = StreamInputStats();
+    stream_active = false;
+    frame_ready = false;
+    frame_damaged = false;
+    last_sequence = 0;
+
+#ifdef ARDUINO
+    ddp_udp.begin(DDP_PORT);
+    Serial.printf("DDP stream input listening on UDP port %d\n", DDP_PORT);
+#endif
+}
+
+// The pin buffers change hands between the stream and the patterns, so patterns that update their
+// last frame in place must redraw it
+static void invalidatePatternFrames()
+{
+    for (uint8_t i = 0; i < pattern_queue.queue_size; i++) {
+        pattern_queue.patterns[i].frame_valid = false;
+    }
+}
+
+// Take the output from the pattern program before the first pixel is written, starting from black
+// so a frame joined halfway through doesn't go out over the last pattern frame
+static void startStream()
+{
+    stream_active = true;
+    last_packet_time = current_time;
+    frame_ready = false;
+    frame_damaged = false;
+    for (uint8_t pin = 0; pin < NUM_PINS; pin++) {
+        fill_solid(pin_configs[pin].led_array, pin_configs[pin].total_leds, CRGB::Black);
+    }
+    invalidatePatternFrames();
+    stopRecording("DDP stream input");
+    LOG_INFO("Stream input: receiving frames, pattern program paused");
+}
+
+// Drain the packets waiting on the socket, up to STREAM_MAX_PACKETS_PER_POLL per loop()
+void pollStreamInput()
+{
+#ifdef ARDUINO
+    for (uint8_t i = 0; i < STREAM_MAX_PACKETS_PER_POLL; i++) {
+        int packet_size = ddp_udp.parsePacket();
+        if (packet_size <= 0)
+            break;
+        receiveDDPPacket(packet_size, readUdp);
+    }
+#endif
+
+    if (stream_active && current_time - last_packet_time >= STREAM_TIMEOUT) {
+        stream_active = false;
+        frame_ready = false;
+        invalidatePatternFrames();
+        LOG_INFO("Stream input: no packets for %d ms, resuming pattern program", STREAM_TIMEOUT);
+    }
+}
+
+// Sequence numbers run 1-15 and wrap; 0 means the sender doesn't number its packets
+static void checkSequence(uint8_t sequence)
+{
+    if (sequence == 0)
+        return;
+
+    if (last_sequence != 0) {
+        uint8_t expected = last_sequence == 15 ? 1 : last_sequence + 1;
+        if (sequence != expected) {
+            stream_stats.sequence_gaps++;
+            frame_damaged = true;
+        }
+    }
+    last_sequence = sequence;
+}
+
+// Read payload bytes [offset, end) of the canvas into the strips they belong to. Forward strips
+// take whole runs in one read; reversed strips are laid out backwards in memory, so each pixel is
+// read on its own
+static bool readPixelData(uint32_t offset, uint32_t end, StreamPacketReader read)
+{
+    uint8_t strip_id = 0;
+    uint32_t strip_start = 0; // First canvas byte of strip_id
+
+    while (offset < end) {
+        while (strip_id < LOCAL_STRIP_COUNT && offset >= strip_start + strips[strip_id].length * 3) {
+            strip_start += strips[strip_id].length * 3;
+            strip_id++;
+        }
+        if (strip_id >= LOCAL_STRIP_COUNT)
+            return true;
+
+        const StripConfig& strip = strips[strip_id];
+        uint32_t strip_offset = offset - strip_start;
+        uint16_t led = strip_offset / 3;
+        uint8_t channel = strip_offset % 3;
+
+        uint8_t* dest;
+        uint32_t run;
+        if (!strip.reverse_direction) {
+            dest = strip.led_array_ptr[strip.start_offset + led].raw + channel;
+            run = min(end, strip_start + strip.length * 3) - offset;
+        } else {
+            dest = strip.led_array_ptr[strip.start_offset + strip.length - 1 - led].raw + channel;
+            run = min(end - offset, (uint32_t)(3 - channel));
+        }
+
+        if (read(dest, run) != (int)run)
+            return false;
+        offset += run;
+    }
+    return true;
+}
+
+// Apply one DDP packet. packet_size covers the header and payload; read returns them in order
+bool receiveDDPPacket(size_t packet_size, StreamPacketReader read)
+{
+    uint8_t header[DDP_HEADER_SIZE + DDP_TIMECODE_SIZE];
+    if (packet_size < DDP_HEADER_SIZE || read(header, DDP_HEADER_SIZE) != DDP_HEADER_SIZE) {
+        stream_stats.rejected++;
+        return false;
+    }
+
+    uint8_t flags = header[0];
+    size_t header_size = DDP_HEADER_SIZE;
+    if (flags & DDP_FLAG_TIMECODE) {
+        header_size += DDP_TIMECODE_SIZE;
+        if (packet_size < header_size || read(header + DDP_HEADER_SIZE, DDP_TIMECODE_SIZE) != DDP_TIMECODE_SIZE) {
+            stream_stats.rejected++;
+            return false;
+        }
+    }
+
+    // Only version 1 pixel data for the default display; queries, replies and config are ignored
+    uint8_t destination = header[3];
+    if ((flags & DDP_FLAG_VERSION_MASK) != DDP_FLAG_VERSION_1 || (flags & (DDP_FLAG_QUERY | DDP_FLAG_REPLY))
+        || (destination != DDP_ID_DISPLAY && destination != 0)) {
+        stream_stats.rejected++;
+        return false;
+    }
+
+    uint32_t offset = ((uint32_t)header[4] << 24) | ((uint32_t)header[5] << 16) | ((uint32_t)header[6] << 8) | header[7];
+    uint16_t length = ((uint16_t)header[8] << 8) | header[9];
+    if (packet_size < header_size + length) {
+        stream_stats.rejected++;
+        return false;
+    }
+
+    if (!stream_active)
+        startStream();
+    checkSequence(header[1] & 0x0F);
+
+    if (!readPixelData(offset, offset + length, read)) {
+        stream_stats.rejected++;
+        frame_damaged = true;
+        return false;
+    }
+    last_packet_time = current_time;
+    stream_stats.packets++;
+
+    if (flags & DDP_FLAG_PUSH) {
+        stream_stats.frames++;
+        if (frame_damaged)
+            stream_stats.incomplete_frames++;
+        frame_damaged = false;
+        frame_ready = true;
+    }
+    return true;
+}
+
+bool isStreamInputActive()
+{
+    return stream_active;
+}
+
+// True once per pushed frame: the pin buffers hold a complete frame ready for the effects and show
+bool takeStreamFrame()
+{
+    bool ready = frame_ready;
+    frame_ready = false;
+    return ready;
+}
+
+void getStreamInputStats(StreamInputStats& stats)
+{
+    stats = stream_stats;
+}
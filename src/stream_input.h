@@ -0,0 +1,48 @@
+#ifndef STREAM_INPUT_H
+#define STREAM_INPUT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Live frames from an external media server over DDP (Distributed Display Protocol). Pixel data
+// is addressed as one RGB canvas in strip order, 0-21, each strip in logical LED order. The first
+// packet takes the output from the pattern program, then pixels are read from the socket straight
+// into the pin buffers. While frames keep arriving they replace the pattern program; FlashBulbs and
+// ripples are still composited on top.
+#define DDP_PORT 4048
+#define DDP_HEADER_SIZE 10
+#define DDP_TIMECODE_SIZE 4 // Extra header bytes when the timecode flag is set
+#define STREAM_TIMEOUT 2000 // ms without a packet before the pattern program takes over again
+#define STREAM_MAX_PACKETS_PER_POLL 32 // Bounds the time one loop() spends draining the socket
+
+// DDP header flags (byte 0)
+#define DDP_FLAG_VERSION_MASK 0xC0
+#define DDP_FLAG_VERSION_1 0x40
+#define DDP_FLAG_TIMECODE 0x10
+#define DDP_FLAG_STORAGE 0x08
+#define DDP_FLAG_REPLY 0x04
+#define DDP_FLAG_QUERY 0x02
+#define DDP_FLAG_PUSH 0x01 // Last packet of a frame: show it
+
+#define DDP_ID_DISPLAY 1 // Default output device
+
+struct StreamInputStats {
+    uint32_t packets; // Pixel data packets written to the LEDs
+    uint32_t frames; // Frames completed by a push packet
+    uint32_t sequence_gaps; // Breaks in the packet sequence (lost or reordered packets)
+    uint32_t incomplete_frames; // Frames shown with a sequence gap in them
+    uint32_t rejected; // Packets with a bad header, another destination or a short payload
+};
+
+// Reads the next length bytes of the current packet into dest and returns how many were read
+typedef int (*StreamPacketReader)(uint8_t* dest, size_t length);
+
+void initStreamInput();
+void pollStreamInput();
+bool receiveDDPPacket(size_t packet_size, StreamPacketReader read);
+
+bool isStreamInputActive();
+bool takeStreamFrame();
+void getStreamInputStats(StreamInputStats& stats);
+
+#endif
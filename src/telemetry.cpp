@@ -0,0 +1,246 @@
+#include "telemetry.h"
+#include "effect_queue.h"
+#include "frame_watchdog.h"
+#include "installation.h"
+#include "latency_trace.h"
+#include "live_preview.h"
+#include "logger.h"
+#include "output_stage.h"
+#include "patterns.h"
+#include "profiler.h"
+#include "show_checkpoint.h"
+#include "show_clock.h"
+#include "stream_input.h"
+#include <Arduino.h>
+#include <stdio.h>
+
+FrameTelemetry frame_telemetry = {};
+
+// micros() at the end of each boot phase, i.e. time since the app started (the bootloader runs
+// before that)
+static uint32_t boot_phase_end_us[BOOT_PHASE_COUNT];
+
+static const char* const pattern_type_names[] = { "chase", "solid", "single_chase", "rainbow", "breathing",
+    "pinwheel", "rainbow_horizontal", "warp", "spatial" };
+static const char* const boot_phase_names[BOOT_PHASE_COUNT] = { "leds", "show", "first_frame", "network", "ready" };
+
+void initStatsWriter(StatsWriter& writer, char* buffer, size_t capacity)
+{
+    writer.buffer = buffer;
+    writer.capacity = capacity;
+    writer.length = 0;
+    writer.overflow = false;
+    if (capacity > 0)
+        buffer[0] = '\0';
+}
+
+void statsPrintf(StatsWriter& writer, const char* format, ...)
+{
+    if (writer.overflow)
+        return;
+
+    size_t available = writer.capacity - writer.length;
+    va_list args;
+    va_start(args, format);
+    int written = vsnprintf(writer.buffer + writer.length, available, format, args);
+    va_end(args);
+
+    if (written < 0 || (size_t)written >= available) {
+        // Truncated: cut back to the last complete write so the output never ends mid-token
+        writer.buffer[writer.length] = '\0';
+        writer.overflow = true;
+        return;
+    }
+    writer.length += written;
+}
+
+void markBootPhase(BootPhase phase)
+{
+    boot_phase_end_us[phase] = micros();
+}
+
+// ms from the app starting to the end of phase
+unsigned long getBootPhaseTime(BootPhase phase)
+{
+    return boot_phase_end_us[phase] / 1000;
+}
+
+// Count one loop() iteration and roll the rate window over once it has run FPS_WINDOW
+void updateFrameTelemetry()
+{
+    frame_telemetry.loop_count++;
+    frame_telemetry.window_loops++;
+
+    unsigned long elapsed = current_time - frame_telemetry.window_start;
+    if (elapsed >= FPS_WINDOW) {
+        frame_telemetry.fps = frame_telemetry.window_frames * 1000.0f / elapsed;
+        frame_telemetry.loop_rate = frame_telemetry.window_loops * 1000.0f / elapsed;
+        frame_telemetry.window_start = current_time;
+        frame_telemetry.window_frames = 0;
+        frame_telemetry.window_loops = 0;
+    }
+}
+
+void recordFrameShown()
+{
+    frame_telemetry.frames_shown++;
+    frame_telemetry.window_frames++;
+}
+
+static void writeHistogramStats(StatsWriter& writer, const char* name, bool valid, const HistogramStats& stats)
+{
+    if (!valid) {
+        statsPrintf(writer, "\"%s\":null,", name);
+        return;
+    }
+    statsPrintf(writer, "\"%s\":{\"count\":%lu,\"min\":%lu,\"p50\":%lu,\"p99\":%lu,\"max\":%lu},", name,
+        (unsigned long)stats.count, (unsigned long)stats.min_us, (unsigned long)stats.p50_us,
+        (unsigned long)stats.p99_us, (unsigned long)stats.max_us);
+}
+
+// Render-side fields of the stats document. Leaves the object open so the caller can append
+// its own fields and close it. Frame timings cover the profiler's current report window and
+// are null when FRAME_PROFILING is compiled out.
+void writeEngineStats(StatsWriter& writer)
+{
+    statsPrintf(writer, "{\"uptime_ms\":%lu,\"fps\":%.1f,\"loop_hz\":%.1f,\"frames\":%lu,", (unsigned long)millis(),
+        frame_telemetry.fps, frame_telemetry.loop_rate, (unsigned long)frame_telemetry.frames_shown);
+
+    // When each boot phase finished, in ms since the app started
+    statsPrintf(writer, "\"boot_ms\":{");
+    for (uint8_t phase = 0; phase < BOOT_PHASE_COUNT; phase++) {
+        statsPrintf(writer, "%s\"%s\":%lu", phase == 0 ? "" : ",", boot_phase_names[phase],
+            getBootPhaseTime((BootPhase)phase));
+    }
+    statsPrintf(writer, "},");
+
+    HistogramStats stats;
+    writeHistogramStats(writer, "frame_us", getStageStats(STAGE_FRAME, stats), stats);
+    writeHistogramStats(writer, "show_us", getStageStats(STAGE_SHOW, stats), stats);
+
+    // Frame deadline watchdog: missed slots and what was slowest before the last fallback
+    FrameWatchdogStats watchdog_stats;
+    getFrameWatchdogStats(watchdog_stats);
+    statsPrintf(writer, "\"watchdog\":{\"fallback\":%s,\"missed_frames\":%lu,\"fallbacks\":%lu,\"stall_frames\":%lu,",
+        watchdog_stats.fallback_active ? "true" : "false", (unsigned long)watchdog_stats.missed_frames,
+        (unsigned long)watchdog_stats.fallbacks, (unsigned long)watchdog_stats.stall_frames);
+    if (watchdog_stats.last_stage < STAGE_COUNT) {
+        statsPrintf(writer, "\"last_stage\":\"%s\",\"last_stage_us\":%lu,", getStageName(watchdog_stats.last_stage),
+            (unsigned long)watchdog_stats.last_stage_us);
+    } else {
+        statsPrintf(writer, "\"last_stage\":null,");
+    }
+    statsPrintf(writer, "\"last_gap_ms\":%lu},", (unsigned long)watchdog_stats.last_gap_ms);
+
+    // Sensor-to-photon latency since boot, per segment
+    statsPrintf(writer, "\"latency_us\":{");
+    for (uint8_t segment = 0; segment < LATENCY_SEGMENT_COUNT; segment++) {
+        writeHistogramStats(writer, getLatencySegmentName(segment), getLatencyStats(segment, stats), stats);
+    }
+    statsPrintf(writer, "\"gateway_offset_ms\":%ld},", (long)getGatewayClockOffset());
+
+    // Show clock: the frame being rendered and, on a follower, how well it tracks the leader
+    ShowClockStats clock_stats;
+    getShowClockStats(clock_stats);
+    statsPrintf(writer,
+        "\"clock\":{\"role\":\"%s\",\"locked\":%s,\"frame\":%lu,\"offset_us\":%lld,\"drift_ppb\":%ld,"
+        "\"error_us\":%ld,\"round_trip_us\":%lu,\"steps\":%lu,\"rejected\":%lu},",
+        clock_stats.role == SHOW_CLOCK_LEADER ? "leader" : "follower", clock_stats.locked ? "true" : "false",
+        (unsigned long)(current_time / SHOW_FRAME_INTERVAL), (long long)clock_stats.offset_us,
+        (long)clock_stats.drift_ppb, (long)clock_stats.last_error_us, (unsigned long)clock_stats.round_trip_us,
+        (unsigned long)clock_stats.steps, (unsigned long)clock_stats.rejected);
+
+    // Installation: the strips this controller drives and the sensor effects shared with the others
+    EffectForwardStats forward_stats;
+    getEffectForwardStats(forward_stats);
+    statsPrintf(writer,
+        "\"installation\":{\"first_strip\":%u,\"local_strips\":%u,\"strips\":%u,\"controllers\":%u,"
+        "\"forwarded\":%lu,\"received\":%lu,\"rejected\":%lu},",
+        FIRST_LOCAL_STRIP, LOCAL_STRIP_COUNT, INSTALLATION_STRIP_COUNT, installation_controller_count,
+        (unsigned long)forward_stats.sent, (unsigned long)forward_stats.received,
+        (unsigned long)forward_stats.rejected);
+
+    // Show state saved for resuming after a reset
+    ShowCheckpointStats checkpoint_stats;
+    getShowCheckpointStats(checkpoint_stats);
+    statsPrintf(writer, "\"checkpoint\":{\"restored\":%s,\"writes\":%lu,\"failed_writes\":%lu,\"last_write_ms\":%lu},",
+        checkpoint_stats.restored ? "true" : "false", (unsigned long)checkpoint_stats.writes,
+        (unsigned long)checkpoint_stats.failed_writes, (unsigned long)checkpoint_stats.last_write_time);
+
+    // Output calibration
+    OutputSettings output_settings;
+    getOutputSettings(output_settings);
+    statsPrintf(writer, "\"output\":{\"brightness\":%u,\"gamma\":%.2f,\"white_balance\":[%u,%u,%u]},",
+        output_settings.brightness, output_settings.gamma, output_settings.white_balance.r,
+        output_settings.white_balance.g, output_settings.white_balance.b);
+
+    // Estimated current per pin for the last frame, and how far the limiter scaled each down
+    OutputPowerStats power_stats;
+    getOutputPowerStats(power_stats);
+    statsPrintf(writer, "\"power\":{\"limited_frames\":%lu,\"pins\":[", (unsigned long)power_stats.limited_frames);
+    for (uint8_t pin = 0; pin < NUM_PINS; pin++) {
+        statsPrintf(writer, "%s{\"ma\":%u,\"budget_ma\":%u,\"scale\":%u}", pin == 0 ? "" : ",",
+            power_stats.pin_ma[pin], output_settings.pin_budgets_ma[pin], power_stats.pin_scale[pin]);
+    }
+    statsPrintf(writer, "]},");
+
+    // Pattern queue: every pattern currently drawing or fading
+    statsPrintf(writer, "\"queue\":{\"running\":%s,\"size\":%u,\"elapsed_ms\":%lu,\"active\":[",
+        pattern_queue.is_running ? "true" : "false", pattern_queue.queue_size,
+        (unsigned long)(current_time - pattern_queue.queue_start_time));
+    bool first = true;
+    for (uint8_t i = 0; i < pattern_queue.queue_size; i++) {
+        const ChasePattern& pattern = pattern_queue.patterns[i];
+        if (!pattern.is_active && !pattern.is_transitioning)
+            continue;
+
+        statsPrintf(writer, "%s{\"index\":%u,\"type\":\"%s\",\"transitioning\":%s}", first ? "" : ",", i,
+            pattern_type_names[pattern.pattern_type], pattern.is_transitioning ? "true" : "false");
+        first = false;
+    }
+    statsPrintf(writer, "]},");
+
+    uint8_t active_flashbulbs = 0;
+    for (uint8_t i = 0; i < flashbulb_manager.pattern_count; i++) {
+        if (flashbulb_manager.patterns[i].state != FLASHBULB_INACTIVE)
+            active_flashbulbs++;
+    }
+    uint8_t active_ripples = 0;
+    for (uint8_t i = 0; i < MAX_RIPPLES; i++) {
+        if (ripple_manager.ripples[i].active)
+            active_ripples++;
+    }
+    statsPrintf(writer, "\"flashbulbs\":{\"active\":%u,\"slots_used\":%u,\"slots\":%u},\"ripples\":%u,",
+        active_flashbulbs, flashbulb_manager.pattern_count, MAX_FLASHBULB_PATTERNS, active_ripples);
+
+    EffectQueueStats effect_stats;
+    getEffectQueueStats(effect_stats);
+    statsPrintf(writer, "\"effects\":{\"queued\":%lu,\"coalesced\":%lu,\"dropped\":%lu,\"activations\":%lu},",
+        (unsigned long)effect_stats.queued, (unsigned long)effect_stats.coalesced, (unsigned long)effect_stats.dropped,
+        (unsigned long)effect_stats.activations);
+
+    StreamInputStats stream_stats;
+    getStreamInputStats(stream_stats);
+    statsPrintf(writer,
+        "\"stream\":{\"active\":%s,\"packets\":%lu,\"frames\":%lu,\"sequence_gaps\":%lu,"
+        "\"incomplete_frames\":%lu,\"rejected\":%lu},",
+        isStreamInputActive() ? "true" : "false", (unsigned long)stream_stats.packets,
+        (unsigned long)stream_stats.frames, (unsigned long)stream_stats.sequence_gaps,
+        (unsigned long)stream_stats.incomplete_frames, (unsigned long)stream_stats.rejected);
+
+    PreviewStats preview_stats;
+    getPreviewStats(preview_stats);
+    statsPrintf(writer, "\"preview\":{\"clients\":%u,\"frames_sent\":%lu,\"frames_dropped\":%lu,\"bytes_sent\":%lu},",
+        preview_stats.clients, (unsigned long)preview_stats.frames_sent, (unsigned long)preview_stats.frames_dropped,
+        (unsigned long)preview_stats.bytes_sent);
+
+    LogStats log_stats;
+    getLogStats(log_stats);
+    statsPrintf(writer, "\"log\":{\"written\":%lu,\"dropped_full\":%lu,\"dropped_rate\":%lu},",
+        (unsigned long)log_stats.written, (unsigned long)log_stats.dropped_full, (unsigned long)log_stats.dropped_rate);
+
+#ifdef ARDUINO
+    statsPrintf(writer, "\"heap\":{\"free\":%lu,\"largest_block\":%lu,\"min_free\":%lu},",
+        (unsigned long)ESP.getFreeHeap(), (unsigned long)ESP.getMaxAllocHeap(), (unsigned long)ESP.getMinFreeHeap());
+#endif
+}
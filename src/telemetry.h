@@ -0,0 +1,58 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include "sensor_config.h"
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Largest /stats document: the engine stats (about 1.5 KB) plus every sensor in the table active,
+// with each count at its widest
+#define STATS_SENSOR_ENTRY_SIZE 64
+#define STATS_BUFFER_SIZE (2048 + SENSOR_TABLE_SIZE * STATS_SENSOR_ENTRY_SIZE)
+#define STATS_STREAM_INTERVAL 1000 // ms between pushes to subscribed WebSocket clients
+#define FPS_WINDOW 1000 // ms over which the frame rate is measured
+
+// Appends formatted text into a caller-owned buffer. Output that doesn't fit is dropped and
+// flagged, and the buffer always stays null-terminated.
+struct StatsWriter {
+    char* buffer;
+    size_t capacity;
+    size_t length;
+    bool overflow;
+};
+
+struct FrameTelemetry {
+    uint32_t loop_count; // loop() iterations since boot
+    uint32_t frames_shown; // FastLED.show() calls from the render loop since boot
+    unsigned long window_start;
+    uint32_t window_loops;
+    uint32_t window_frames;
+    float fps; // Frames shown per second over the last FPS_WINDOW
+    float loop_rate; // loop() iterations per second over the last FPS_WINDOW
+};
+
+// Steps of setup(), in order. Each is stamped as it finishes, so /stats shows how long a
+// recovery boot took to get the show back on the LEDs
+enum BootPhase {
+    BOOT_PHASE_LEDS, // FastLED and the strip layout
+    BOOT_PHASE_SHOW, // Pattern program, sensor table and any saved show state
+    BOOT_PHASE_FIRST_FRAME, // First frame sent to the LEDs
+    BOOT_PHASE_NETWORK, // WiFi, show clock sync, WebSocket and web servers
+    BOOT_PHASE_READY, // Diagnostics printed, loop() about to start
+    BOOT_PHASE_COUNT
+};
+
+extern FrameTelemetry frame_telemetry;
+
+void initStatsWriter(StatsWriter& writer, char* buffer, size_t capacity);
+void statsPrintf(StatsWriter& writer, const char* format, ...) __attribute__((format(printf, 2, 3)));
+
+void markBootPhase(BootPhase phase);
+unsigned long getBootPhaseTime(BootPhase phase);
+
+void updateFrameTelemetry();
+void recordFrameShown();
+void writeEngineStats(StatsWriter& writer);
+
+#endif
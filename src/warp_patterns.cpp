@@ -1,3 +1,4 @@
+#include "led_kernels.h"
 #include "patterns.h"
 
 void runWarpPattern(ChasePattern* pattern)
@@ -31,8 +32,8 @@ void runWarpPattern(ChasePattern* pattern)
         
         // Clear all strips first
         for (uint8_t i = 0; i < pattern->num_target_strips; i++) {
-            uint8_t strip_id = pattern->target_strips[i];
-            if (strip_id >= 22) continue;
+            int8_t strip_id = getLocalStrip(pattern->target_strips[i]);
+            if (strip_id < 0) continue;
             
             // Skip strips that are currently active in FlashBulb patterns
             if (isStripActiveInFlashBulb(strip_id)) continue;
@@ -72,8 +73,8 @@ void runWarpPattern(ChasePattern* pattern)
             unsigned long transition_elapsed = current_time - pattern->transition_start_time;
             if (transition_elapsed < pattern->transition_duration) {
                 for (uint8_t i = 0; i < pattern->num_target_strips; i++) {
-                    uint8_t strip_id = pattern->target_strips[i];
-                    if (strip_id >= 22) continue;
+                    int8_t strip_id = getLocalStrip(pattern->target_strips[i]);
+                    if (strip_id < 0) continue;
                     if (isStripActiveInFlashBulb(strip_id)) continue;
                     
                     CRGBSet strip_set = getStripSet(strip_id);
@@ -89,7 +90,7 @@ void runWarpPattern(ChasePattern* pattern)
                     } else {
                         // Transitioning out
                         uint8_t fade_amount = (transition_elapsed * 255) / pattern->transition_duration;
-                        strip_set.fadeToBlackBy(fade_amount);
+                        fadeLEDsToBlackBy(strip_set, strip_set.size(), fade_amount);
                     }
                 }
             }
@@ -0,0 +1,161 @@
+#ifndef WEB_ASSETS_H
+#define WEB_ASSETS_H
+
+// Generated by tools/embed_web_assets.py from web/ - edit the pages there, not this file
+
+#include <Arduino.h>
+
+struct WebAsset {
+    const char* path;
+    const char* content_type;
+    const uint8_t* data; // gzip-compressed, in flash
+    size_t length;
+    const char* etag;
+};
+
+// index.html: 1607 bytes, 896 gzipped
+static const uint8_t index_html_gz[] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x75, 0x55, 0xdf, 0x6f, 0xdb, 0x36,
+    0x10, 0x7e, 0xf7, 0x5f, 0x71, 0xd5, 0x8b, 0x64, 0xcc, 0x96, 0x6c, 0x37, 0x69, 0xb2, 0x44, 0x16,
+    0xb0, 0x24, 0x46, 0xd7, 0x21, 0x6d, 0x83, 0x26, 0xc3, 0x30, 0x14, 0x7d, 0xa0, 0xa5, 0x93, 0xc5,
+    0x8e, 0x22, 0x05, 0x8a, 0xb2, 0x5b, 0x14, 0xfe, 0xdf, 0x77, 0x27, 0xca, 0x8e, 0x83, 0xa2, 0x0f,
+    0x96, 0x74, 0xbf, 0xbf, 0x3b, 0x7e, 0x47, 0xa7, 0xaf, 0xee, 0x3e, 0xde, 0x3e, 0xfd, 0xfb, 0xb0,
+    0x82, 0xca, 0xd5, 0x2a, 0x1b, 0xa5, 0xfd, 0x2b, 0xad, 0x50, 0x14, 0x59, 0x5a, 0xa3, 0x13, 0xa0,
+    0x45, 0x8d, 0xcb, 0x60, 0x2b, 0x71, 0xd7, 0x18, 0xeb, 0x02, 0xc8, 0x8d, 0x76, 0xa8, 0xdd, 0x32,
+    0xd8, 0xc9, 0xc2, 0x55, 0xcb, 0x02, 0xb7, 0x32, 0xc7, 0x69, 0x2f, 0x04, 0x59, 0xea, 0xa4, 0x53,
+    0x98, 0x7d, 0xc2, 0x52, 0x61, 0xee, 0xa4, 0xde, 0xc0, 0x53, 0x85, 0xf0, 0x60, 0xb1, 0xa5, 0x90,
+    0x34, 0xf1, 0xd6, 0x34, 0xe9, 0xd3, 0x8f, 0xd2, 0xb5, 0x29, 0xbe, 0x53, 0xad, 0xf9, 0x2f, 0xfc,
+    0x61, 0x0a, 0xf7, 0xab, 0x3b, 0xb8, 0xa5, 0x82, 0xd6, 0x28, 0x8a, 0x9a, 0x53, 0x4c, 0x93, 0xfd,
+    0x83, 0xeb, 0x47, 0x93, 0xff, 0x87, 0x0e, 0x5a, 0xb4, 0x5b, 0xb4, 0x60, 0x3b, 0xad, 0x39, 0xd4,
+    0x68, 0x60, 0x88, 0x70, 0x39, 0x4f, 0x93, 0xa6, 0x77, 0x7d, 0x44, 0x5d, 0xc0, 0x5f, 0x8f, 0x1f,
+    0x3f, 0x40, 0x8d, 0x6d, 0x2b, 0x36, 0xd8, 0xc2, 0x4e, 0xba, 0x0a, 0x4a, 0x63, 0x6b, 0xe1, 0xae,
+    0xe0, 0x47, 0x40, 0x75, 0x5a, 0x63, 0xdf, 0x15, 0xc1, 0x15, 0xcc, 0x27, 0x10, 0x38, 0x49, 0x8e,
+    0x4e, 0xd4, 0x0d, 0xcb, 0x8b, 0xd7, 0x67, 0xe7, 0x6f, 0x2e, 0x2e, 0x7f, 0x9f, 0xed, 0x0f, 0xf9,
+    0x56, 0x85, 0x74, 0x20, 0xc0, 0x07, 0xf9, 0x54, 0x87, 0x14, 0x84, 0xb2, 0x94, 0x9b, 0x80, 0x73,
+    0x4a, 0xce, 0x76, 0x4e, 0xd9, 0x5a, 0x67, 0x65, 0xd3, 0x92, 0xf0, 0xf9, 0x62, 0x02, 0x97, 0x5f,
+    0x48, 0x83, 0x65, 0x49, 0x7d, 0x92, 0x26, 0x20, 0x4b, 0xa3, 0x30, 0x60, 0x9d, 0xde, 0xa2, 0x32,
+    0x0d, 0x0e, 0x10, 0x72, 0x63, 0x54, 0x61, 0x76, 0x9a, 0xc5, 0xf3, 0xd9, 0x6c, 0x46, 0x2a, 0x41,
+    0xa3, 0xd9, 0xb2, 0xdd, 0xd9, 0x0e, 0xf7, 0xfb, 0xc9, 0x88, 0x8a, 0xb7, 0xdc, 0xda, 0x4f, 0xc5,
+    0x83, 0x02, 0x4b, 0xd1, 0x29, 0xd7, 0x06, 0x7b, 0x70, 0x06, 0x68, 0x8e, 0xce, 0x58, 0x04, 0x47,
+    0x43, 0x5d, 0x77, 0x52, 0xb9, 0xa9, 0xd4, 0xe0, 0xc4, 0x5a, 0xe1, 0xa1, 0xa3, 0x5b, 0xa1, 0xe4,
+    0xda, 0x0a, 0xe7, 0x7d, 0x4c, 0xe7, 0x9a, 0xce, 0x1d, 0x1a, 0xf3, 0x52, 0xdf, 0xd2, 0xda, 0xca,
+    0x4d, 0xe5, 0x34, 0x0d, 0x91, 0xc4, 0x45, 0x0f, 0x6a, 0x23, 0xea, 0x5a, 0xb0, 0x14, 0x2f, 0x48,
+    0xda, 0x55, 0xd2, 0xe1, 0x8d, 0x50, 0x42, 0xe7, 0x0c, 0xf4, 0xf3, 0xe2, 0x9c, 0x06, 0x30, 0xbf,
+    0x78, 0x33, 0x81, 0xc5, 0xd9, 0x8c, 0x3b, 0xa7, 0x51, 0xd4, 0xed, 0xd1, 0xb2, 0x78, 0x4d, 0x29,
+    0xe8, 0x8b, 0x2d, 0xeb, 0xae, 0xd8, 0xa0, 0xf3, 0xb6, 0xbe, 0x5f, 0x7e, 0x7e, 0xd9, 0xef, 0x47,
+    0x51, 0x1f, 0x03, 0x82, 0x1a, 0x68, 0xd0, 0x4e, 0xfb, 0x69, 0xc2, 0x33, 0x92, 0x09, 0x78, 0xcd,
+    0x0c, 0x4a, 0x69, 0x5b, 0x77, 0x0d, 0x43, 0xa2, 0x63, 0x40, 0x43, 0xcd, 0xe6, 0x9d, 0xb5, 0x4c,
+    0x25, 0x25, 0x6b, 0x49, 0x26, 0xd2, 0xd4, 0x7f, 0x4c, 0x38, 0x84, 0x46, 0xa8, 0x8d, 0xc6, 0xf1,
+    0x61, 0x10, 0x77, 0x77, 0x0f, 0xd0, 0xc8, 0x6f, 0xa8, 0x38, 0x2b, 0x8a, 0x1a, 0x44, 0x9e, 0x63,
+    0xe3, 0xb0, 0x60, 0x5a, 0xfd, 0xcd, 0x46, 0xa6, 0xd6, 0xd9, 0xec, 0xec, 0x12, 0x22, 0x7f, 0xae,
+    0x30, 0x9b, 0x2e, 0xe6, 0x9c, 0xd1, 0xd8, 0x02, 0xed, 0x04, 0x3e, 0xbd, 0xbd, 0x39, 0x66, 0xbb,
+    0xa7, 0xf3, 0x02, 0xde, 0x19, 0x30, 0x25, 0x08, 0xa5, 0x3c, 0xd4, 0xf6, 0x0a, 0x52, 0x01, 0x95,
+    0xc5, 0x72, 0x19, 0x24, 0x8d, 0x45, 0x76, 0x88, 0x79, 0xe1, 0x82, 0xec, 0x85, 0x98, 0x26, 0x22,
+    0x7b, 0x91, 0x89, 0x28, 0xe9, 0x5e, 0x04, 0xf7, 0x0a, 0x8a, 0xea, 0xdf, 0xec, 0x3e, 0x81, 0x13,
+    0x4e, 0xf4, 0xc6, 0x81, 0x2d, 0x60, 0x78, 0x45, 0xf8, 0x70, 0x8f, 0x7b, 0xe3, 0x53, 0x57, 0x0b,
+    0x5e, 0x0f, 0xe6, 0xf1, 0x7b, 0xd1, 0xd0, 0xa8, 0x36, 0xed, 0x15, 0xad, 0xd8, 0x22, 0x4b, 0x3b,
+    0x05, 0xb2, 0x58, 0x06, 0xf5, 0xa0, 0xa5, 0xa5, 0x56, 0x32, 0xbb, 0x37, 0xa2, 0xe0, 0x1d, 0x2b,
+    0xad, 0xa9, 0x4f, 0x70, 0x3c, 0x3b, 0x1d, 0x3f, 0x19, 0x4d, 0x1c, 0xc7, 0x69, 0x42, 0x51, 0x69,
+    0xd2, 0xf1, 0x9d, 0xd2, 0xe6, 0xd4, 0xbc, 0xcb, 0x46, 0x25, 0xba, 0xbc, 0x8a, 0xc2, 0xa3, 0x6b,
+    0x38, 0x8e, 0x09, 0x98, 0x8e, 0xca, 0x4e, 0x13, 0xc3, 0x69, 0xce, 0x11, 0x11, 0xb6, 0x31, 0xba,
+    0xc5, 0x31, 0xfc, 0x20, 0xf2, 0xba, 0xce, 0x6a, 0x38, 0xa8, 0xe2, 0xaf, 0xad, 0xd1, 0xd1, 0xf8,
+    0x1a, 0xf6, 0x3f, 0x45, 0xe5, 0x3d, 0xfd, 0x29, 0x66, 0x04, 0xb0, 0x15, 0x96, 0x0e, 0xbb, 0x75,
+    0xb0, 0x84, 0xc2, 0xe4, 0x5d, 0x4d, 0x87, 0x1f, 0x13, 0x2b, 0x56, 0x0a, 0xf9, 0xf3, 0xe6, 0xfb,
+    0xbb, 0x22, 0x0a, 0x9f, 0xeb, 0x5f, 0x53, 0x04, 0x7b, 0xc7, 0x52, 0x6b, 0xb4, 0x7f, 0x3e, 0xbd,
+    0xbf, 0xa7, 0xb8, 0x30, 0x64, 0xb5, 0x4f, 0x1a, 0xfb, 0x05, 0x6b, 0x63, 0x22, 0xcc, 0x4a, 0x10,
+    0xfa, 0xe7, 0xaa, 0xde, 0xe2, 0xab, 0x02, 0xc8, 0x12, 0xa2, 0x57, 0x5e, 0x15, 0xfb, 0x7d, 0x1d,
+    0x0f, 0x1d, 0x5c, 0xf7, 0x76, 0xc6, 0x45, 0x2b, 0x52, 0x9f, 0xe2, 0xca, 0x89, 0x68, 0x0e, 0x07,
+    0x68, 0x51, 0xa8, 0xa4, 0x07, 0x04, 0xbd, 0x63, 0xec, 0xf0, 0x9b, 0xbb, 0xf5, 0x97, 0x2d, 0x83,
+    0x1a, 0x0e, 0x2b, 0x84, 0xdf, 0x86, 0xfb, 0x27, 0x96, 0x05, 0x7d, 0x87, 0x30, 0xcd, 0xe0, 0x71,
+    0x60, 0xd7, 0x89, 0xd1, 0x13, 0x2e, 0xfe, 0x6a, 0xa4, 0x8e, 0xc2, 0x09, 0x84, 0xe3, 0xde, 0x37,
+    0x3a, 0xf1, 0xf0, 0x77, 0x11, 0xab, 0xc7, 0xa1, 0x2f, 0xdb, 0x4f, 0x82, 0x66, 0x43, 0x34, 0xba,
+    0xad, 0xa4, 0x2a, 0x22, 0xc6, 0xd1, 0x43, 0xda, 0xd3, 0x93, 0x7f, 0x69, 0x32, 0x9c, 0x65, 0x9a,
+    0xf8, 0xcb, 0x3b, 0xf1, 0x7f, 0x1b, 0xff, 0x03, 0x6e, 0x4a, 0xac, 0x6b, 0x47, 0x06, 0x00, 0x00,
+};
+
+// preview.html: 2511 bytes, 1176 gzipped
+static const uint8_t preview_html_gz[] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x8d, 0x56, 0x6d, 0x6f, 0xdb, 0x46,
+    0x0c, 0xfe, 0xae, 0x5f, 0xc1, 0xb8, 0x68, 0x2c, 0xd7, 0xb1, 0xfc, 0xd6, 0x04, 0x85, 0x25, 0x6b,
+    0x58, 0x93, 0x14, 0xc8, 0xd0, 0x97, 0x60, 0xc9, 0x36, 0x0c, 0x83, 0x31, 0x9c, 0xa5, 0x93, 0x75,
+    0xa8, 0x74, 0x12, 0x4e, 0x27, 0x27, 0x46, 0xea, 0xff, 0x3e, 0xde, 0x51, 0xb2, 0x95, 0x15, 0xcd,
+    0x06, 0x04, 0xf1, 0xf9, 0xf8, 0xf0, 0x21, 0xf9, 0x90, 0xa2, 0x1c, 0x9c, 0x5c, 0x7d, 0xb9, 0xbc,
+    0xff, 0xf3, 0xf6, 0x1a, 0x52, 0x9d, 0x67, 0xa1, 0x13, 0x9c, 0x8c, 0x46, 0xf0, 0xbb, 0xe0, 0x0f,
+    0x5c, 0x41, 0x52, 0x28, 0xd0, 0x29, 0x87, 0x71, 0xa9, 0xf8, 0x16, 0xaf, 0xe0, 0x0f, 0xbe, 0xbe,
+    0x2b, 0xa2, 0xaf, 0x5c, 0x83, 0x9b, 0x28, 0x96, 0x73, 0x83, 0xc8, 0x99, 0x06, 0x21, 0xa1, 0x52,
+    0xd1, 0x38, 0x13, 0x5b, 0xfe, 0x77, 0x83, 0xf5, 0xd2, 0xc1, 0x02, 0x0a, 0xc9, 0x21, 0x2a, 0xb2,
+    0x3a, 0x97, 0x50, 0x22, 0x5f, 0xa5, 0x95, 0x28, 0xcf, 0x20, 0x11, 0xaa, 0xd2, 0xf0, 0xf1, 0xfa,
+    0x0a, 0xd0, 0xd5, 0xf0, 0xaf, 0x0b, 0xad, 0x8b, 0x1c, 0x46, 0x23, 0x0c, 0x6f, 0xb3, 0x08, 0x52,
+    0xce, 0xe2, 0x30, 0xc8, 0xb9, 0x66, 0x20, 0x31, 0xce, 0xb2, 0x67, 0x28, 0xcb, 0x42, 0xe9, 0x1e,
+    0xf2, 0x49, 0xcd, 0xa5, 0x5e, 0xf6, 0x1e, 0x44, 0xac, 0xd3, 0x65, 0x8c, 0xd1, 0x22, 0x3e, 0xb2,
+    0x5f, 0x7a, 0x61, 0xa0, 0x85, 0xce, 0x78, 0xf8, 0x11, 0x13, 0x81, 0x5b, 0x4a, 0x24, 0x18, 0xd3,
+    0x9d, 0x13, 0x54, 0x7a, 0x87, 0x9f, 0xeb, 0x22, 0xde, 0x3d, 0xad, 0x59, 0xf4, 0x75, 0xa3, 0x8a,
+    0x5a, 0xc6, 0x8b, 0x57, 0xd3, 0xe9, 0xd4, 0xc7, 0x24, 0x0b, 0xb5, 0x78, 0x15, 0x45, 0x91, 0x9f,
+    0x20, 0xff, 0x28, 0x61, 0xb9, 0xc8, 0x76, 0x8b, 0x8a, 0xc9, 0x6a, 0x54, 0x71, 0x25, 0x92, 0xbd,
+    0x13, 0x31, 0xb9, 0x65, 0xd5, 0x93, 0x0d, 0xb4, 0xb8, 0xb8, 0x98, 0x94, 0x8f, 0x7e, 0xce, 0x1e,
+    0x29, 0xf0, 0x62, 0x3a, 0x99, 0xbc, 0xf6, 0x53, 0x2e, 0x36, 0xa9, 0x5e, 0xcc, 0xad, 0x4d, 0xe4,
+    0x6c, 0xc3, 0x47, 0x8a, 0xcb, 0x18, 0xdd, 0xe5, 0x66, 0x51, 0x8a, 0x47, 0x9e, 0x31, 0xcd, 0x63,
+    0xbf, 0x1b, 0x7b, 0x32, 0x99, 0xec, 0x83, 0x31, 0x25, 0x16, 0x8c, 0x6d, 0xd5, 0x4e, 0x60, 0x32,
+    0x44, 0x09, 0xa6, 0xe1, 0xaf, 0x3c, 0xc9, 0x78, 0xa4, 0xd1, 0x1d, 0xee, 0x53, 0x5b, 0x50, 0x85,
+    0x95, 0xc3, 0x08, 0x9e, 0xd7, 0x87, 0x48, 0x27, 0x28, 0xc3, 0x20, 0x63, 0x6b, 0x9e, 0x85, 0x1f,
+    0x6e, 0xef, 0x20, 0x10, 0xb2, 0xac, 0xb1, 0x2d, 0xf1, 0xb2, 0x97, 0x94, 0x55, 0x0f, 0xf4, 0xae,
+    0x44, 0x0d, 0x65, 0x9d, 0xaf, 0xb9, 0xea, 0x41, 0x2e, 0xe4, 0xb2, 0x37, 0xc5, 0x4f, 0xf6, 0xb8,
+    0xec, 0xcd, 0x26, 0x3d, 0xd8, 0xb2, 0xac, 0x46, 0xfb, 0x39, 0xea, 0x37, 0x26, 0x12, 0xa7, 0x21,
+    0x7b, 0x9f, 0x61, 0xbb, 0xab, 0x63, 0xf3, 0x20, 0xa8, 0xb8, 0x49, 0xc9, 0x52, 0xaf, 0xad, 0x11,
+    0x9d, 0x8a, 0x52, 0x8b, 0x42, 0x86, 0xd3, 0xf6, 0x30, 0x6b, 0x0f, 0x6f, 0x9b, 0x03, 0x90, 0x17,
+    0x8f, 0xc3, 0x77, 0x07, 0xf0, 0x45, 0x7b, 0x9a, 0xcf, 0x50, 0x01, 0x6b, 0xef, 0x84, 0xaf, 0x4a,
+    0x26, 0x6d, 0x90, 0x4a, 0xa3, 0x68, 0xbd, 0x10, 0xbb, 0x2e, 0x49, 0x0a, 0x04, 0xa3, 0x0d, 0xa1,
+    0x25, 0xc2, 0xa8, 0x29, 0x16, 0x68, 0xb4, 0x30, 0x05, 0xd0, 0x95, 0xa1, 0x88, 0x30, 0x61, 0x1d,
+    0x3a, 0x5b, 0xa6, 0xc0, 0x4e, 0xef, 0x12, 0xe2, 0x22, 0xaa, 0x73, 0x94, 0xd0, 0xdb, 0x70, 0x7d,
+    0x9d, 0x71, 0x73, 0x7c, 0xbf, 0xbb, 0x89, 0xdd, 0xbe, 0xb1, 0xf7, 0x07, 0x67, 0x34, 0x5c, 0x8f,
+    0x1a, 0xa1, 0x76, 0x86, 0x11, 0x76, 0x49, 0x37, 0x6e, 0x7f, 0x16, 0x1b, 0x80, 0x6d, 0x2b, 0x9a,
+    0x65, 0x9d, 0x65, 0x67, 0x50, 0xd9, 0x87, 0xc1, 0xb7, 0x21, 0x50, 0xe8, 0x1b, 0xab, 0xfa, 0x0b,
+    0x61, 0x10, 0x63, 0x48, 0x48, 0xb8, 0xff, 0x44, 0x13, 0xac, 0x3f, 0x20, 0x7e, 0x2b, 0xc4, 0x3d,
+    0x25, 0xf7, 0x43, 0x17, 0x0b, 0x32, 0x1e, 0x4e, 0x52, 0xcb, 0xa8, 0x91, 0x5e, 0xc6, 0x77, 0x5c,
+    0x1b, 0xe9, 0x2a, 0x77, 0x00, 0x4f, 0x0e, 0x80, 0x48, 0xc0, 0xa5, 0xd4, 0xe1, 0xf4, 0xb4, 0x29,
+    0xc2, 0x53, 0x38, 0x7c, 0xbb, 0x3b, 0xe3, 0x0f, 0xcb, 0x25, 0x4c, 0x07, 0x88, 0x83, 0xd6, 0x66,
+    0x38, 0xdc, 0x5f, 0xee, 0xbe, 0x7c, 0xf6, 0xcc, 0x14, 0xc8, 0x8d, 0x48, 0x76, 0xee, 0x93, 0xa9,
+    0x78, 0x01, 0xc3, 0xb6, 0x6e, 0xcf, 0x4e, 0x51, 0x5b, 0x1c, 0x1a, 0x3a, 0x55, 0x92, 0x0d, 0xf6,
+    0x03, 0xcc, 0x6c, 0xef, 0x1c, 0x3c, 0x0a, 0x19, 0xa5, 0x4c, 0x5a, 0x3d, 0xbb, 0xe0, 0xce, 0x75,
+    0x37, 0xf9, 0x6e, 0x51, 0xcd, 0x38, 0x34, 0xf5, 0x34, 0xb5, 0x60, 0x57, 0xba, 0x3b, 0xca, 0xed,
+    0x3f, 0x54, 0x8b, 0xf1, 0xb8, 0x0f, 0x43, 0x40, 0x72, 0x66, 0xfc, 0xbc, 0xb4, 0xc0, 0xcd, 0x33,
+    0x84, 0x7e, 0xbb, 0xd1, 0x8c, 0x54, 0x87, 0x2a, 0xd7, 0x42, 0x32, 0xb5, 0xbb, 0xc7, 0x67, 0x05,
+    0xa9, 0xfa, 0x4c, 0x29, 0xb6, 0x5b, 0xd7, 0x49, 0xc2, 0x55, 0xbf, 0x03, 0x2a, 0x64, 0x51, 0x72,
+    0x89, 0x80, 0x43, 0x2e, 0x26, 0x89, 0x63, 0x77, 0x3c, 0x33, 0x2d, 0x97, 0xb4, 0xa3, 0x0c, 0x8d,
+    0xd9, 0x89, 0x7d, 0xff, 0x5f, 0x5d, 0xf0, 0x61, 0xff, 0x8c, 0x32, 0xca, 0x8a, 0x8a, 0xff, 0x7f,
+    0x4e, 0xc5, 0x8f, 0x8f, 0x03, 0x72, 0x77, 0x67, 0xd2, 0x44, 0xd2, 0xf7, 0x22, 0xe7, 0x45, 0xad,
+    0xdd, 0x06, 0x75, 0x06, 0x33, 0xdc, 0x33, 0xdf, 0x05, 0xcd, 0x79, 0x55, 0x91, 0xe3, 0x31, 0x2c,
+    0xdf, 0x62, 0x08, 0x13, 0x3b, 0x56, 0xec, 0xe1, 0x83, 0x59, 0xf1, 0xae, 0xd1, 0xf4, 0x37, 0x21,
+    0xf5, 0xbb, 0x9f, 0x8d, 0x20, 0x84, 0xf0, 0x62, 0xa6, 0xd9, 0x80, 0x18, 0xf7, 0x9d, 0xb6, 0x1c,
+    0xbd, 0x2c, 0xc0, 0x36, 0x87, 0x66, 0x17, 0x1f, 0xc5, 0xca, 0x0c, 0x2e, 0x5e, 0xff, 0x35, 0x5d,
+    0xb5, 0x53, 0xd2, 0xde, 0xcc, 0x56, 0x7e, 0x33, 0x96, 0xf6, 0xeb, 0x64, 0x65, 0x47, 0xd0, 0x0c,
+    0xa7, 0x7b, 0x42, 0xd5, 0x7d, 0xfb, 0x46, 0x65, 0x7a, 0x76, 0xdf, 0xc2, 0xc9, 0xb2, 0xe5, 0x3c,
+    0x18, 0x68, 0xfb, 0x1a, 0x0b, 0x71, 0x0f, 0x28, 0x3c, 0xd0, 0x93, 0x4c, 0x6e, 0xad, 0x97, 0x7f,
+    0x34, 0x34, 0x6e, 0xad, 0x17, 0x59, 0x5a, 0x45, 0x9b, 0x75, 0xe0, 0x45, 0xf8, 0x70, 0x68, 0x7e,
+    0x63, 0x6e, 0xaf, 0x30, 0x41, 0x97, 0x58, 0xda, 0x2a, 0xec, 0x0c, 0xed, 0x9b, 0x02, 0x28, 0xdf,
+    0x01, 0x28, 0xae, 0x6b, 0x25, 0x71, 0x66, 0x49, 0x81, 0x12, 0xd9, 0xe6, 0x8d, 0x03, 0x1e, 0x27,
+    0xc6, 0xe5, 0x21, 0x15, 0x19, 0x07, 0x17, 0x97, 0xaa, 0x55, 0xc1, 0xcb, 0xb8, 0xdc, 0xe8, 0xf4,
+    0x90, 0x36, 0x7a, 0x15, 0x65, 0xab, 0x50, 0xb9, 0x82, 0x30, 0x84, 0x0b, 0xb3, 0xa1, 0x6a, 0x3b,
+    0x04, 0xa4, 0x54, 0x39, 0x1c, 0xae, 0xe0, 0x14, 0x2e, 0xe6, 0x03, 0x9c, 0xea, 0x29, 0x25, 0x6f,
+    0xde, 0xda, 0xae, 0xf1, 0x16, 0x36, 0x10, 0x7e, 0x04, 0xe4, 0x85, 0xc7, 0xe1, 0xb0, 0xc9, 0x61,
+    0x38, 0x6c, 0xe3, 0x50, 0xda, 0x26, 0x12, 0xa2, 0x07, 0xb6, 0x64, 0x21, 0x6b, 0xee, 0x37, 0x46,
+    0x43, 0x64, 0xdf, 0x8e, 0x48, 0x46, 0xa0, 0x29, 0xfc, 0x84, 0xe5, 0x0c, 0x91, 0xf7, 0x0d, 0xcc,
+    0x61, 0x01, 0x65, 0x17, 0x6a, 0x5f, 0x73, 0x26, 0x3d, 0xb7, 0xe9, 0xf0, 0x08, 0xf1, 0xa3, 0xa6,
+    0xee, 0xd7, 0xad, 0x60, 0xe8, 0xd9, 0xb4, 0x6f, 0x08, 0x9f, 0x98, 0x4e, 0xbd, 0x24, 0x2b, 0x0a,
+    0x45, 0x2e, 0x30, 0x3e, 0x36, 0xf0, 0x0d, 0xbc, 0x6d, 0xc9, 0xa9, 0xc9, 0x54, 0xb4, 0x89, 0xb1,
+    0x6a, 0x95, 0xb1, 0xc9, 0xad, 0x7e, 0x04, 0x33, 0xb2, 0x3c, 0x87, 0xda, 0x9b, 0x17, 0xe0, 0xb3,
+    0xef, 0xe0, 0xb3, 0x97, 0xe0, 0x73, 0x03, 0x9f, 0x9d, 0x9f, 0x13, 0x64, 0x6f, 0xff, 0xa3, 0x3a,
+    0x5d, 0xb1, 0xa8, 0x65, 0x24, 0x16, 0xdd, 0xce, 0xf0, 0xd6, 0x7c, 0x9b, 0xb4, 0x93, 0xd3, 0x0e,
+    0x1a, 0xae, 0xbf, 0xe3, 0x94, 0xd9, 0x68, 0x67, 0x30, 0xc1, 0x3f, 0xbb, 0x37, 0x9d, 0xc3, 0xd6,
+    0xf3, 0x1d, 0x7c, 0x0b, 0xd2, 0xeb, 0x2d, 0x18, 0xd3, 0xcf, 0x85, 0x31, 0xfd, 0x7c, 0xfb, 0x07,
+    0x5c, 0x5b, 0xc3, 0x04, 0xcf, 0x09, 0x00, 0x00,
+};
+
+static const WebAsset web_assets[] = {
+    { "/", "text/html", index_html_gz, sizeof(index_html_gz), "\"418986a435e31a42\"" },
+    { "/preview.html", "text/html", preview_html_gz, sizeof(preview_html_gz), "\"50159d0711ba1918\"" },
+};
+
+#define WEB_ASSET_COUNT (sizeof(web_assets) / sizeof(web_assets[0]))
+
+#endif
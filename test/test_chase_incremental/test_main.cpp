@@ -0,0 +1,144 @@
+#include "Arduino.h"
+#include "led_layout.h"
+#include "patterns.h"
+#include "show_clock.h"
+#include <unity.h>
+
+// Chase and single chase frames shifted in place from the previous frame must match frames drawn
+// from scratch, byte for byte, through a whole cycle of the pattern queue: transitions in and out,
+// strips shared between patterns, reversed strips, and FlashBulbs taking strips over and handing
+// them back.
+
+HostSerial Serial;
+
+extern bool strip_reverse_config[LOCAL_STRIP_COUNT];
+
+static CRGB saved_leds[NUM_PINS][488];
+static CRGB incremental_leds[NUM_PINS][488];
+static PatternQueue saved_queue;
+static FlashBulbManager saved_flashbulbs;
+
+static void copyPinBuffers(CRGB (*dest)[488], bool to_pins)
+{
+    for (uint8_t pin = 0; pin < NUM_PINS; pin++) {
+        size_t bytes = pin_configs[pin].total_leds * sizeof(CRGB);
+        if (to_pins)
+            memcpy(pin_configs[pin].led_array, dest[pin], bytes);
+        else
+            memcpy(dest[pin], pin_configs[pin].led_array, bytes);
+    }
+}
+
+// Render each frame of two queue cycles twice from the same state: once as the show would, once
+// with every pattern forced to redraw, and compare. Returns how many pattern updates could take
+// the incremental path
+static uint32_t checkQueueCycles(uint32_t cycle_ms, uint8_t flash_strip_a, uint8_t flash_strip_b)
+{
+    // A one-second flash, so the strips spend most of the cycle back with the patterns
+    static const EnvelopeConfig short_flash = { { { 100, CURVE_LINEAR }, { 100, CURVE_LINEAR },
+                                                    { 400, CURVE_EXPONENTIAL }, { 400, CURVE_GAMMA } },
+        CRGB::White };
+    uint8_t flash_strips[2] = { flash_strip_a, flash_strip_b };
+    uint8_t flash = addFlashBulbPattern(flash_strips, 2, addFlashBulbEnvelope(short_flash));
+
+    current_time = 0;
+    startPatternQueue();
+    uint32_t frames = 2 * cycle_ms / SHOW_FRAME_INTERVAL + 50;
+    uint32_t incremental_frames = 0;
+
+    for (uint32_t frame = 0; frame < frames; frame++) {
+        current_time = frame * SHOW_FRAME_INTERVAL;
+        if (frame % 170 == 40)
+            triggerFlashBulb(flash); // Lands in transitions as well as in steady chases
+
+        saved_queue = pattern_queue;
+        saved_flashbulbs = flashbulb_manager;
+        copyPinBuffers(saved_leds, false);
+
+        for (uint8_t i = 0; i < pattern_queue.queue_size; i++) {
+            if (canRenderIncrementally(&pattern_queue.patterns[i]))
+                incremental_frames++;
+        }
+        runQueuedPattern();
+        copyPinBuffers(incremental_leds, false);
+        PatternQueue incremental_queue = pattern_queue;
+
+        pattern_queue = saved_queue;
+        flashbulb_manager = saved_flashbulbs;
+        copyPinBuffers(saved_leds, true);
+        for (uint8_t i = 0; i < pattern_queue.queue_size; i++) {
+            pattern_queue.patterns[i].frame_valid = false;
+        }
+        runQueuedPattern();
+
+        for (uint8_t pin = 0; pin < NUM_PINS; pin++) {
+            char message[64];
+            snprintf(message, sizeof(message), "frame %lu pin %u", (unsigned long)frame, pin);
+            TEST_ASSERT_EQUAL_MEMORY_MESSAGE(pin_configs[pin].led_array, incremental_leds[pin],
+                pin_configs[pin].total_leds * sizeof(CRGB), message);
+        }
+
+        // Carry on from the incremental frame, as the show would
+        pattern_queue = incremental_queue;
+        copyPinBuffers(incremental_leds, true);
+    }
+    return incremental_frames;
+}
+
+void setUp()
+{
+    for (uint8_t strip = 0; strip < LOCAL_STRIP_COUNT; strip++) {
+        strip_reverse_config[strip] = strip % 3 == 1;
+    }
+    initializeStripConfigs();
+    initFlashBulbManager();
+    initRippleManager();
+    clearPatternQueue();
+    for (uint8_t pin = 0; pin < NUM_PINS; pin++) {
+        fill_solid(pin_configs[pin].led_array, pin_configs[pin].total_leds, CRGB::Black);
+    }
+}
+
+void tearDown() { }
+
+// One chase on every strip handing over to another at a different speed and palette
+static void test_chase_over_all_strips()
+{
+    static const PaletteConfig rainbow
+        = { { CRGB::Red, CRGB::Orange, CRGB::Yellow, CRGB::Green, CRGB::Blue, CRGB::Purple }, 6 };
+    static const PaletteConfig sunset = { { CRGB::Purple, CRGB::Magenta, CRGB::Orange, CRGB::Red }, 4 };
+    StripGroupConfig all_strips = { {}, INSTALLATION_STRIP_COUNT };
+    for (uint8_t i = 0; i < INSTALLATION_STRIP_COUNT; i++)
+        all_strips.strips[i] = i;
+
+    addPatternToQueue(PATTERN_CHASE, rainbow, all_strips, 60, 0, 1000);
+    addPatternToQueue(PATTERN_CHASE, sunset, all_strips, 95, 4500, 1000);
+
+    TEST_ASSERT_TRUE(checkQueueCycles(4500 + 5000, 3, 17) > 0);
+}
+
+// Chases and single chases on overlapping groups in their own order, including strip ids this
+// controller doesn't drive
+static void test_overlapping_groups()
+{
+    static const PaletteConfig white = { { CRGB::White }, 1 };
+    static const PaletteConfig cool = { { CRGB::Blue, CRGB::Cyan, CRGB::Green }, 3 };
+    static const StripGroupConfig outside = { { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13 }, 14 };
+    static const StripGroupConfig scattered = { { 5, 200, 2, 17, 9, 1, 21 }, 7 };
+    static const StripGroupConfig inside = { { 14, 15, 16, 17, 18, 19, 20, 21 }, 8 };
+
+    addPatternToQueue(PATTERN_CHASE, cool, outside, 100, 0, 800);
+    addPatternToQueue(PATTERN_SINGLE_CHASE, white, inside, 40, 0, 800);
+    addPatternToQueue(PATTERN_CHASE, cool, scattered, 25, 3000, 1500);
+    addPatternToQueue(PATTERN_SINGLE_CHASE, white, outside, 80, 6000, 1200);
+
+    TEST_ASSERT_TRUE(checkQueueCycles(6000 + 5000, 1, 15) > 0);
+}
+
+int main(int argc, char** argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_chase_over_all_strips);
+    RUN_TEST(test_overlapping_groups);
+    return UNITY_END();
+}
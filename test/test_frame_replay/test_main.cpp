@@ -0,0 +1,153 @@
+#include "Arduino.h"
+#include "frame_recorder.h"
+#include "installation.h"
+#include "led_layout.h"
+#include "output_stage.h"
+#include "patterns.h"
+#include "sensor_config.h"
+#include "show_checkpoint.h"
+#include "show_runner.h"
+#include <unity.h>
+
+// A recorded session replayed through the show must reproduce every frame hash, and a recording
+// that no longer matches the show must be reported. Needs -DFRAME_RECORDER=1 (see platformio.ini).
+
+HostSerial Serial;
+
+static uint8_t recording_copy[RECORDER_BUFFER_SIZE];
+static size_t recording_length;
+
+void setUp()
+{
+    current_time = 0;
+    initializeStripConfigs();
+    loadDefaultSensorMappings();
+}
+
+void tearDown() { }
+
+// About 30 s of uneven loop times with a stall now and then, sensor messages between frames, a
+// sensor table edit, an effect forwarded by another controller and a change of output settings.
+// With a checkpoint, the show resumes from it first as it does after a reset
+static void recordSession(uint32_t random_seed, const ShowCheckpoint* resume = NULL)
+{
+    current_time = 3000;
+    resetShowState(random_seed);
+    if (resume != NULL) {
+        current_time = 90000;
+        applyShowState(*resume, true);
+    }
+    startRecording(random_seed);
+
+    for (uint32_t i = 0; i < 3000; i++) {
+        current_time += 5 + (i * 13) % 17 + (i % 500 == 0 ? 200 : 0);
+        if (i % 97 == 5) {
+            uint8_t sensor_id = 1 + (i / 97) % 8;
+            recordSensorEvent(sensor_id);
+            triggerSensor(sensor_id, NULL);
+        }
+        if (i == 800) {
+            SensorConfig config = sensor_mappings[3].config;
+            config.effect = SENSOR_EFFECT_RIPPLE;
+            config.active = true;
+            setSensorConfig(3, config);
+        }
+        if (i == 1200) {
+            EffectForwardPacket packet = {};
+            packet.magic = EFFECT_FORWARD_MAGIC;
+            packet.effect = SENSOR_EFFECT_FLASHBULB;
+            packet.strip_mask = 0x3ULL << 15;
+            applyForwardedEffect(packet);
+        }
+        if (i == 1500) {
+            OutputSettings settings;
+            getOutputSettings(settings);
+            settings.gamma = 2.2f;
+            settings.brightness = 180;
+            setOutputSettings(settings);
+        }
+        runShowFrame();
+        recordLoopIteration();
+    }
+
+    const uint8_t* recording = getRecording(recording_length);
+    memcpy(recording_copy, recording, recording_length);
+}
+
+static void test_replay_matches_recording()
+{
+    recordSession(777);
+
+    ReplayResult result;
+    TEST_ASSERT_TRUE(replayRecording(recording_copy, recording_length, result));
+    TEST_ASSERT_EQUAL_UINT32(3000, result.frames); // The whole session fit in the log
+    TEST_ASSERT_EQUAL_UINT32(31, result.sensor_events);
+    TEST_ASSERT_EQUAL_UINT32(0, result.mismatches);
+}
+
+static void test_replay_resumed_show()
+{
+    // Some way into the program, with a sensor cooling down
+    current_time = 3000;
+    resetShowState(779);
+    for (uint32_t i = 0; i < 1000; i++) {
+        current_time += 20;
+        if (i == 900)
+            triggerSensor(5, NULL);
+        runShowFrame();
+    }
+    static ShowCheckpoint checkpoint;
+    captureShowCheckpoint(checkpoint);
+
+    recordSession(780, &checkpoint);
+
+    ReplayResult result;
+    TEST_ASSERT_TRUE(replayRecording(recording_copy, recording_length, result));
+    TEST_ASSERT_EQUAL_UINT32(3000, result.frames);
+    TEST_ASSERT_EQUAL_UINT32(0, result.mismatches);
+}
+
+static void test_replay_reports_changed_frame()
+{
+    recordSession(778);
+
+    // Flip a bit in the hash of the first new frame after the first hundred loop iterations
+    size_t offset = RECORDER_HEADER_SIZE;
+    RecordEntry record;
+    uint32_t frame = 0;
+    bool found = false;
+    while (!found && readRecord(recording_copy, recording_length, offset, record)) {
+        if (record.type == RECORD_INPUT)
+            continue;
+        found = record.type == RECORD_FRAME && frame >= 100;
+        if (!found)
+            frame++;
+    }
+    TEST_ASSERT_TRUE(found);
+    recording_copy[record.payload_offset] ^= 1;
+
+    ReplayResult result;
+    TEST_ASSERT_TRUE(replayRecording(recording_copy, recording_length, result));
+    TEST_ASSERT_EQUAL_UINT32(3000, result.frames);
+    TEST_ASSERT_TRUE(result.mismatches > 0);
+    TEST_ASSERT_EQUAL_UINT32(frame, result.first_mismatch_frame);
+}
+
+static void test_replay_rejects_other_data()
+{
+    static const uint8_t not_a_recording[] = "LEDX\x01 not a recording";
+
+    ReplayResult result;
+    TEST_ASSERT_FALSE(replayRecording(not_a_recording, sizeof(not_a_recording), result));
+    TEST_ASSERT_FALSE(result.valid);
+}
+
+int main(int argc, char** argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_replay_matches_recording);
+    RUN_TEST(test_replay_resumed_show);
+    RUN_TEST(test_replay_reports_changed_frame);
+    RUN_TEST(test_replay_rejects_other_data);
+    return UNITY_END();
+}
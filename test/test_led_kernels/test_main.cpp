@@ -0,0 +1,151 @@
+#include "Arduino.h"
+#include "led_kernels.h"
+#include <unity.h>
+
+// The packed kernels must be bit-exact with the per-pixel FastLED references on every input:
+// edge levels and amounts, lengths that leave partial words, and spans starting at every
+// alignment, with the destination and source aligned differently.
+
+HostSerial Serial;
+
+#define MAX_SPAN 67
+#define SPAN_OFFSETS 4 // A CRGB is 3 bytes, so four starting LEDs cover every word alignment
+
+static const uint8_t edge_amounts[] = { 0, 1, 2, 127, 128, 129, 253, 254, 255 };
+
+enum FillMode {
+    FILL_BLACK,
+    FILL_WHITE,
+    FILL_EDGES, // Channels alternating among 0, 1, 127, 128, 254, 255
+    FILL_RANDOM,
+    FILL_MODE_COUNT
+};
+
+static CRGB packed[MAX_SPAN + SPAN_OFFSETS];
+static CRGB reference[MAX_SPAN + SPAN_OFFSETS];
+static CRGB source[MAX_SPAN + SPAN_OFFSETS];
+
+static void fillSpan(CRGB* leds, uint16_t count, uint8_t mode)
+{
+    static const uint8_t edge_levels[] = { 0, 1, 127, 128, 254, 255 };
+    for (uint16_t led = 0; led < count; led++) {
+        for (uint8_t channel = 0; channel < 3; channel++) {
+            switch (mode) {
+            case FILL_BLACK:
+                leds[led].raw[channel] = 0;
+                break;
+            case FILL_WHITE:
+                leds[led].raw[channel] = 255;
+                break;
+            case FILL_EDGES:
+                leds[led].raw[channel] = edge_levels[(led * 3 + channel) % sizeof(edge_levels)];
+                break;
+            default:
+                leds[led].raw[channel] = rand() & 0xFF;
+                break;
+            }
+        }
+    }
+}
+
+typedef void (*KernelCheck)(CRGB* packed_leds, CRGB* reference_leds, const CRGB* source_leds, uint16_t count,
+    uint8_t amount);
+
+// Run one kernel against its reference over every length, alignment, fill and amount. The LEDs
+// either side of the span must come through untouched
+static void checkKernel(KernelCheck check, bool uses_source)
+{
+    for (uint16_t count = 0; count <= MAX_SPAN - SPAN_OFFSETS; count++) {
+        for (uint8_t offset = 0; offset < SPAN_OFFSETS; offset++) {
+            uint8_t source_offset = uses_source ? (offset + count) % SPAN_OFFSETS : 0;
+            for (uint8_t mode = 0; mode < FILL_MODE_COUNT; mode++) {
+                for (uint8_t a = 0; a <= sizeof(edge_amounts); a++) {
+                    uint8_t amount = a < sizeof(edge_amounts) ? edge_amounts[a] : rand() & 0xFF;
+
+                    fillSpan(packed, MAX_SPAN + SPAN_OFFSETS, FILL_RANDOM);
+                    memcpy(reference, packed, sizeof(packed));
+                    fillSpan(packed + offset, count, mode);
+                    memcpy(reference + offset, packed + offset, count * sizeof(CRGB));
+                    fillSpan(source, MAX_SPAN + SPAN_OFFSETS, (mode + 1 + a) % FILL_MODE_COUNT);
+
+                    check(packed + offset, reference + offset, source + source_offset, count, amount);
+
+                    char message[80];
+                    snprintf(message, sizeof(message), "count %u offset %u source offset %u fill %u amount %u", count,
+                        offset, source_offset, mode, amount);
+                    TEST_ASSERT_EQUAL_MEMORY_MESSAGE(reference, packed, sizeof(packed), message);
+                }
+            }
+        }
+    }
+}
+
+static void checkScale(CRGB* packed_leds, CRGB* reference_leds, const CRGB*, uint16_t count, uint8_t amount)
+{
+    scaleLEDs(packed_leds, count, amount);
+    scaleLEDsReference(reference_leds, count, amount);
+}
+
+static void checkLerp(CRGB* packed_leds, CRGB* reference_leds, const CRGB* source_leds, uint16_t count,
+    uint8_t amount)
+{
+    lerpLEDs(packed_leds, source_leds, count, amount);
+    lerpLEDsReference(reference_leds, source_leds, count, amount);
+}
+
+static void checkAdd(CRGB* packed_leds, CRGB* reference_leds, const CRGB* source_leds, uint16_t count, uint8_t)
+{
+    addLEDs(packed_leds, source_leds, count);
+    addLEDsReference(reference_leds, source_leds, count);
+}
+
+static void checkAddScaled(CRGB* packed_leds, CRGB* reference_leds, const CRGB* source_leds, uint16_t count,
+    uint8_t amount)
+{
+    addScaledLEDs(packed_leds, source_leds, count, amount);
+    addScaledLEDsReference(reference_leds, source_leds, count, amount);
+}
+
+static void checkFade(CRGB* packed_leds, CRGB* reference_leds, const CRGB*, uint16_t count, uint8_t amount)
+{
+    fadeLEDsToBlackBy(packed_leds, count, amount);
+    for (uint16_t led = 0; led < count; led++) {
+        reference_leds[led].fadeToBlackBy(amount);
+    }
+}
+
+void setUp() { srand(1234); }
+
+void tearDown() { }
+
+static void test_scale() { checkKernel(checkScale, false); }
+static void test_lerp() { checkKernel(checkLerp, true); }
+static void test_add() { checkKernel(checkAdd, true); }
+static void test_add_scaled() { checkKernel(checkAddScaled, true); }
+static void test_fade_to_black() { checkKernel(checkFade, false); }
+
+// In place: the source is the destination itself
+static void test_add_to_self()
+{
+    for (uint16_t count = 0; count <= MAX_SPAN - SPAN_OFFSETS; count++) {
+        for (uint8_t offset = 0; offset < SPAN_OFFSETS; offset++) {
+            fillSpan(packed, MAX_SPAN + SPAN_OFFSETS, FILL_RANDOM);
+            memcpy(reference, packed, sizeof(packed));
+            addLEDs(packed + offset, packed + offset, count);
+            addLEDsReference(reference + offset, reference + offset, count);
+            TEST_ASSERT_EQUAL_MEMORY(reference, packed, sizeof(packed));
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_scale);
+    RUN_TEST(test_lerp);
+    RUN_TEST(test_add);
+    RUN_TEST(test_add_scaled);
+    RUN_TEST(test_fade_to_black);
+    RUN_TEST(test_add_to_self);
+    return UNITY_END();
+}
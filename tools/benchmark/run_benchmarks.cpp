@@ -0,0 +1,23 @@
+// Host run of the controller's benchmarks (LED_KERNEL_BENCHMARK): the bulk LED kernels against
+// FastLED's per-pixel code, and the output stage, over the controller's own LED buffers.
+//
+//   run_benchmarks
+//
+// The figures are the build machine's, not the ESP32's. The kernel-to-reference ratio carries over
+// well enough to check a kernel change before flashing; absolute times come from the controller,
+// which prints the same tables at boot in a -DLED_KERNEL_BENCHMARK build.
+
+#include "Arduino.h"
+#include "led_kernels.h"
+#include "led_layout.h"
+#include "output_stage.h"
+
+HostSerial Serial;
+
+int main()
+{
+    initializeStripConfigs();
+    runLEDKernelBenchmark();
+    runOutputBenchmark();
+    return 0;
+}
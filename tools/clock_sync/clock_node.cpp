@@ -0,0 +1,136 @@
+// Show clock test node: runs the show clock on the host, so a leader and several followers can be
+// run side by side over loopback, each with its own clock error.
+//
+//   clock_node --leader [--duration SECONDS]
+//   clock_node --follower ADDRESS [--offset-ms N] [--drift-ppm N] [--duration SECONDS]
+//
+// A node's local clock is the host's monotonic clock shifted by --offset-ms and running --drift-ppm
+// fast or slow. A leader started without either serves the host clock itself, so every follower can
+// measure its true error: the frame it renders against the frame the leader renders at that moment.
+//
+//   clock_node --leader --duration 60 &
+//   clock_node --follower 127.0.0.1 --offset-ms 4000 --drift-ppm 80 --duration 60 &
+//   clock_node --follower 127.0.0.1 --offset-ms -2500 --drift-ppm -120 --duration 60
+
+#include "Arduino.h"
+#include "logger.h"
+#include "show_clock.h"
+#include <chrono>
+#include <unistd.h>
+
+#define REPORT_INTERVAL 1000 // ms between status lines
+
+HostSerial Serial;
+
+static uint64_t start_us = 0;
+static int64_t clock_offset_us = 0;
+static int32_t clock_drift_ppm = 0;
+
+static uint64_t readHostClock()
+{
+    return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+// The simulated controller's crystal
+static uint64_t readNodeClock()
+{
+    uint64_t host = readHostClock();
+    return host + clock_offset_us + (int64_t)(host - start_us) * clock_drift_ppm / 1000000;
+}
+
+extern "C" uint32_t millis(void) { return (uint32_t)(readHostClock() / 1000); }
+extern "C" uint32_t micros(void) { return (uint32_t)readHostClock(); }
+
+static void usage()
+{
+    fprintf(stderr,
+        "usage: clock_node --leader [--duration SECONDS]\n"
+        "       clock_node --follower ADDRESS [--offset-ms N] [--drift-ppm N] [--duration SECONDS]\n");
+}
+
+int main(int argc, char** argv)
+{
+    const char* leader_address = NULL;
+    bool leader = false;
+    float duration = 30;
+
+    for (int i = 1; i < argc; i++) {
+        bool has_value = i + 1 < argc;
+        if (strcmp(argv[i], "--leader") == 0) {
+            leader = true;
+        } else if (strcmp(argv[i], "--follower") == 0 && has_value) {
+            leader_address = argv[++i];
+        } else if (strcmp(argv[i], "--offset-ms") == 0 && has_value) {
+            clock_offset_us = atol(argv[++i]) * 1000LL;
+        } else if (strcmp(argv[i], "--drift-ppm") == 0 && has_value) {
+            clock_drift_ppm = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--duration") == 0 && has_value) {
+            duration = atof(argv[++i]);
+        } else {
+            usage();
+            return 1;
+        }
+    }
+    if (leader == (leader_address != NULL) || duration <= 0) {
+        usage();
+        return 1;
+    }
+
+    start_us = readHostClock();
+    setLocalClockSource(readNodeClock);
+    initShowClock(leader ? SHOW_CLOCK_LEADER : SHOW_CLOCK_FOLLOWER, leader_address);
+    beginShowClockSync();
+    const char* name = leader ? "leader" : "follower";
+
+    // Error statistics cover the second half of the run, once the clock has had time to settle
+    uint64_t end_us = start_us + (uint64_t)(duration * 1e6);
+    uint64_t settled_us = start_us + (uint64_t)(duration * 0.5e6);
+    uint64_t next_report = start_us;
+    int64_t max_error = 0;
+    uint32_t samples = 0, frames_off = 0;
+
+    while (readHostClock() < end_us) {
+        updateShowClock();
+        unsigned long frame_time = getShowFrameTime();
+
+        uint64_t host = readHostClock();
+        int64_t error = (int64_t)(getShowTimeUs() - host);
+        unsigned long host_ms = (unsigned long)(host / 1000);
+        long frame_error = ((long)frame_time - (long)(host_ms - host_ms % SHOW_FRAME_INTERVAL)) / SHOW_FRAME_INTERVAL;
+
+        if (host >= settled_us) {
+            max_error = max(max_error, error < 0 ? -error : error);
+            samples++;
+            if (frame_error != 0)
+                frames_off++;
+        }
+
+        if (host >= next_report) {
+            ShowClockStats stats;
+            getShowClockStats(stats);
+            printf("%s t=%5.1fs frame %lu locked %s offset %lld us drift %ld ppb rtt %lu us error %lld us (%ld frames)\n",
+                name, (host - start_us) / 1e6, frame_time / SHOW_FRAME_INTERVAL, stats.locked ? "yes" : "no",
+                (long long)stats.offset_us, (long)stats.drift_ppb, (unsigned long)stats.round_trip_us, (long long)error,
+                frame_error);
+            fflush(stdout);
+            next_report += REPORT_INTERVAL * 1000ULL;
+        }
+
+        drainLog();
+        usleep(1000);
+    }
+
+    ShowClockStats stats;
+    getShowClockStats(stats);
+    printf("%s done: %lu requests, %lu responses, %lu steps, %lu rejected\n", name, (unsigned long)stats.requests,
+        (unsigned long)stats.responses, (unsigned long)stats.steps, (unsigned long)stats.rejected);
+    if (!leader) {
+        printf("%s error against the host clock over the second half: max %lld us, %lu of %lu samples on another frame\n",
+            name, (long long)max_error, (unsigned long)frames_off, (unsigned long)samples);
+        if (!stats.locked)
+            return 1;
+    }
+    return 0;
+}
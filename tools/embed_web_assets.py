@@ -0,0 +1,93 @@
+"""Compress the web UI in web/ into src/web_assets.h.
+
+Each page is gzipped into a PROGMEM array with an ETag taken from its contents, so the controller
+serves it straight from flash and answers repeat requests with 304 Not Modified. Runs before every
+esp32dev build (extra_scripts in platformio.ini) and only rewrites the header when a page changed;
+it can also be run by hand: python tools/embed_web_assets.py
+"""
+
+import gzip
+import hashlib
+import os
+
+# path served, file in web/, content type
+ASSETS = [
+    ("/", "index.html", "text/html"),
+    ("/preview.html", "preview.html", "text/html"),
+]
+
+try:
+    Import("env")  # noqa: F821 - provided when PlatformIO runs this as an extra script
+    project_dir = env.subst("$PROJECT_DIR")  # noqa: F821
+except NameError:
+    project_dir = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..")
+
+web_dir = os.path.join(project_dir, "web")
+header_path = os.path.join(project_dir, "src", "web_assets.h")
+
+
+def symbol_for(file_name):
+    return file_name.replace(".", "_").replace("-", "_") + "_gz"
+
+
+def byte_lines(data):
+    for start in range(0, len(data), 16):
+        yield "    " + ", ".join("0x%02x" % b for b in data[start:start + 16]) + ","
+
+
+def build_header():
+    lines = [
+        "#ifndef WEB_ASSETS_H",
+        "#define WEB_ASSETS_H",
+        "",
+        "// Generated by tools/embed_web_assets.py from web/ - edit the pages there, not this file",
+        "",
+        "#include <Arduino.h>",
+        "",
+        "struct WebAsset {",
+        "    const char* path;",
+        "    const char* content_type;",
+        "    const uint8_t* data; // gzip-compressed, in flash",
+        "    size_t length;",
+        "    const char* etag;",
+        "};",
+        "",
+    ]
+
+    entries = []
+    for path, file_name, content_type in ASSETS:
+        with open(os.path.join(web_dir, file_name), "rb") as source:
+            content = source.read()
+        # mtime=0 keeps the output identical between builds of the same page
+        compressed = gzip.compress(content, compresslevel=9, mtime=0)
+        etag = hashlib.sha1(content).hexdigest()[:16]
+        symbol = symbol_for(file_name)
+
+        lines.append("// %s: %d bytes, %d gzipped" % (file_name, len(content), len(compressed)))
+        lines.append("static const uint8_t %s[] PROGMEM = {" % symbol)
+        lines.extend(byte_lines(compressed))
+        lines.append("};")
+        lines.append("")
+        entries.append('    { "%s", "%s", %s, sizeof(%s), "\\"%s\\"" },' % (path, content_type, symbol, symbol, etag))
+
+    lines.append("static const WebAsset web_assets[] = {")
+    lines.extend(entries)
+    lines.append("};")
+    lines.append("")
+    lines.append("#define WEB_ASSET_COUNT (sizeof(web_assets) / sizeof(web_assets[0]))")
+    lines.append("")
+    lines.append("#endif")
+    return "\n".join(lines) + "\n"
+
+
+header = build_header()
+try:
+    with open(header_path) as existing:
+        unchanged = existing.read() == header
+except IOError:
+    unchanged = False
+
+if not unchanged:
+    with open(header_path, "w") as output:
+        output.write(header)
+    print("Embedded web assets into %s" % os.path.relpath(header_path, project_dir))
@@ -0,0 +1,54 @@
+#ifndef OFFLINE_RENDER_ARDUINO_H
+#define OFFLINE_RENDER_ARDUINO_H
+
+// Just enough of the Arduino core for the pattern engine to build on the host. Serial goes to
+// stderr so stdout stays free for raw video; millis()/micros() come from FastLED's stub platform.
+
+#include <algorithm>
+#include <math.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef PI
+#define PI 3.1415926535897932384626433832795
+#endif
+
+using std::max;
+using std::min;
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+extern "C" uint32_t millis(void);
+extern "C" uint32_t micros(void);
+
+// Rendering runs on the show clock, so there is never anything to wait for
+inline void delay(unsigned long) { }
+
+inline void randomSeed(unsigned long seed) { srand(seed); }
+inline long random(long howbig) { return howbig > 0 ? rand() % howbig : 0; }
+inline long random(long howsmall, long howbig) { return howsmall < howbig ? howsmall + random(howbig - howsmall) : howsmall; }
+
+class HostSerial {
+public:
+    int printf(const char* format, ...) __attribute__((format(printf, 2, 3)))
+    {
+        va_list args;
+        va_start(args, format);
+        int written = vfprintf(stderr, format, args);
+        va_end(args);
+        return written;
+    }
+    void print(const char* text) { fputs(text, stderr); }
+    void print(long value) { fprintf(stderr, "%ld", value); }
+    void println(const char* text = "") { fprintf(stderr, "%s\n", text); }
+    void println(long value) { fprintf(stderr, "%ld\n", value); }
+    size_t write(const uint8_t* buffer, size_t size) { return fwrite(buffer, 1, size, stderr); }
+    int availableForWrite() { return 4096; }
+};
+
+extern HostSerial Serial;
+
+#endif
@@ -0,0 +1,485 @@
+// Offline show renderer: runs the show on the host as fast as the CPU allows and writes every
+// frame laid out like the Wokwi canvases in diagram.json, as PPM images or a raw RGB stream.
+//
+//   render_show [--fps 50] [--duration 60] [--scale 4] [--seed 1]
+//               [--trigger SECONDS:STRIP[,STRIP...][:ripple]]... [--sensor SECONDS:ID]...
+//               [--stall SECONDS:MS[:COUNT][:STAGE]]... [--record FILE] (--ppm DIR | --raw FILE|-)
+//   render_show --replay FILE
+//
+// --trigger starts a FlashBulb or ripple on the given strips directly; --sensor sends a sensor id
+// through the sensor table (default mappings), as a message from the gateway would.
+//
+// --record saves a frame recorder log of the session (sensor inputs, the fallback and frame hashes,
+// see src/frame_recorder.h). --replay runs such a log, from here or from a controller's /recording,
+// back through the show and exits with status 1 when any frame differs. Recordings carry their
+// sensor table; --trigger inputs aren't recorded.
+//
+// --stall blocks the simulated loop() for MS, COUNT times in a row with one frame between, and
+// books the time to the named profiler stage ("ripples", "websocket", ...). The stall guard and
+// the frame watchdog see the missed frames as they would on the controller: the guard covers a
+// stall past 200 ms with the fallback solid, and repeated stalls switch the show to the fallback.
+//
+// A raw stream can be encoded with
+//   ffmpeg -f rawvideo -pix_fmt rgb24 -s WIDTHxHEIGHT -r FPS -i show.rgb show.mp4
+// (the renderer prints the exact command when it finishes).
+
+#include "Arduino.h"
+#include "frame_recorder.h"
+#include "frame_watchdog.h"
+#include "led_layout.h"
+#include "logger.h"
+#include "patterns.h"
+#include "profiler.h"
+#include "sensor_config.h"
+#include "show_clock.h"
+#include "show_runner.h"
+#include <chrono>
+
+#define MAX_TRIGGERS 64
+#define MAX_STALLS 16
+#define CANVAS_SPACING 40 // Distance between adjacent canvases in diagram.json units
+
+HostSerial Serial;
+
+// Position of each strip's canvas in diagram.json, in CANVAS_SPACING units. Strips 0-13 are
+// vertical canvases (122 rows) and 14-21 horizontal ones (122 columns).
+struct CanvasStrip {
+    int16_t left;
+    int16_t top;
+    bool horizontal;
+};
+
+static const CanvasStrip canvas_strips[LOCAL_STRIP_COUNT] = {
+    { 0, 0, false }, { 5, 0, false }, { 10, 0, false }, // pin1_strip1-3
+    { 15, 0, false }, { 16, 0, false }, { 17, 0, false }, { 18, 0, false }, // pin2_strip1-4
+    { 19, 0, false }, { 20, 0, false }, { 21, 0, false }, { 22, 0, false }, // pin3_strip1-4
+    { 27, 0, false }, { 32, 0, false }, { 37, 0, false }, // pin4_strip1-3
+    { 0, -5, true }, { 0, -6, true }, { 0, -7, true }, { 0, -8, true }, // pin5_strip1-4
+    { 0, -9, true }, { 0, -10, true }, { 0, -11, true }, { 0, -12, true }, // pin6_strip1-4
+};
+
+struct SimulatedTrigger {
+    unsigned long time_ms;
+    int16_t sensor_id; // Sent through the sensor table, or -1 to light the strips directly
+    uint8_t strips[MAX_TARGET_STRIPS];
+    uint8_t num_strips;
+    bool ripple;
+    bool fired;
+};
+
+static SimulatedTrigger triggers[MAX_TRIGGERS];
+static uint8_t trigger_count = 0;
+
+struct SimulatedStall {
+    unsigned long time_ms;
+    uint32_t stall_ms;
+    uint16_t count; // Stalls still to come
+    uint8_t stage; // ProfileStage the time is booked to, STAGE_COUNT for none
+};
+
+static SimulatedStall stalls[MAX_STALLS];
+static uint8_t stall_count = 0;
+
+static int16_t canvas_left, canvas_top;
+static uint16_t canvas_width, canvas_height, canvas_scale = 4;
+static uint8_t* canvas = NULL; // canvas_width * canvas_height * canvas_scale^2 RGB pixels
+static bool canvas_captured = false;
+
+static void computeCanvasBounds()
+{
+    int16_t right = INT16_MIN, bottom = INT16_MIN;
+    canvas_left = INT16_MAX;
+    canvas_top = INT16_MAX;
+    for (uint8_t strip_id = 0; strip_id < LOCAL_STRIP_COUNT; strip_id++) {
+        const CanvasStrip& strip = canvas_strips[strip_id];
+        uint16_t length = getStripLength(strip_id);
+        canvas_left = min(canvas_left, strip.left);
+        canvas_top = min(canvas_top, strip.top);
+        right = max(right, (int16_t)(strip.left + (strip.horizontal ? length : 1)));
+        bottom = max(bottom, (int16_t)(strip.top + (strip.horizontal ? 1 : length)));
+    }
+    canvas_width = right - canvas_left;
+    canvas_height = bottom - canvas_top;
+}
+
+// Copy the LED buffers, or one color on every LED, into the canvas. LEDs are placed in wiring
+// order, like the Wokwi canvases.
+static void drawCanvas(const CRGB* solid)
+{
+    uint16_t row_pixels = canvas_width * canvas_scale;
+    memset(canvas, 0, (size_t)row_pixels * canvas_height * canvas_scale * 3);
+
+    for (uint8_t strip_id = 0; strip_id < LOCAL_STRIP_COUNT; strip_id++) {
+        const CanvasStrip& strip = canvas_strips[strip_id];
+        CRGBSet strip_set = getStripSet(strip_id);
+        uint16_t length = getStripLength(strip_id);
+
+        for (uint16_t led = 0; led < length; led++) {
+            uint16_t x = strip.left - canvas_left + (strip.horizontal ? led : 0);
+            uint16_t y = strip.top - canvas_top + (strip.horizontal ? 0 : led);
+            const CRGB& color = solid != NULL ? *solid : strip_set[led];
+
+            for (uint16_t dy = 0; dy < canvas_scale; dy++) {
+                uint8_t* pixel = canvas + (((size_t)(y * canvas_scale + dy) * row_pixels) + x * canvas_scale) * 3;
+                for (uint16_t dx = 0; dx < canvas_scale; dx++) {
+                    *pixel++ = color.r;
+                    *pixel++ = color.g;
+                    *pixel++ = color.b;
+                }
+            }
+        }
+    }
+    canvas_captured = true;
+}
+
+static void captureCanvas()
+{
+    drawCanvas(NULL);
+}
+
+// Parse "SECONDS:STRIP[,STRIP...][:ripple]"
+static bool parseTrigger(const char* spec)
+{
+    if (trigger_count >= MAX_TRIGGERS)
+        return false;
+
+    SimulatedTrigger& trigger = triggers[trigger_count];
+    char* end;
+    trigger.time_ms = (unsigned long)(strtod(spec, &end) * 1000);
+    if (*end != ':')
+        return false;
+
+    trigger.num_strips = 0;
+    do {
+        long strip_id = strtol(end + 1, &end, 10);
+        if (strip_id < 0 || strip_id >= LOCAL_STRIP_COUNT || trigger.num_strips >= MAX_TARGET_STRIPS)
+            return false;
+        trigger.strips[trigger.num_strips++] = strip_id;
+    } while (*end == ',');
+
+    trigger.ripple = strcmp(end, ":ripple") == 0;
+    if (*end != '\0' && !trigger.ripple)
+        return false;
+
+    trigger.sensor_id = -1;
+    trigger.fired = false;
+    trigger_count++;
+    return true;
+}
+
+// Parse "SECONDS:ID"
+static bool parseSensor(const char* spec)
+{
+    if (trigger_count >= MAX_TRIGGERS)
+        return false;
+
+    SimulatedTrigger& trigger = triggers[trigger_count];
+    char* end;
+    trigger.time_ms = (unsigned long)(strtod(spec, &end) * 1000);
+    if (*end != ':')
+        return false;
+    long sensor_id = strtol(end + 1, &end, 10);
+    if (sensor_id < 0 || sensor_id > 255 || *end != '\0')
+        return false;
+
+    trigger.sensor_id = sensor_id;
+    trigger.num_strips = 0;
+    trigger.fired = false;
+    trigger_count++;
+    return true;
+}
+
+// Parse "SECONDS:MS[:COUNT][:STAGE]"
+static bool parseStall(const char* spec)
+{
+    if (stall_count >= MAX_STALLS)
+        return false;
+
+    SimulatedStall& stall = stalls[stall_count];
+    char* end;
+    stall.time_ms = (unsigned long)(strtod(spec, &end) * 1000);
+    if (*end != ':')
+        return false;
+    stall.stall_ms = strtoul(end + 1, &end, 10);
+    if (stall.stall_ms == 0)
+        return false;
+
+    stall.count = 1;
+    if (*end == ':' && end[1] >= '0' && end[1] <= '9') {
+        stall.count = strtoul(end + 1, &end, 10);
+    }
+
+    stall.stage = STAGE_COUNT;
+    if (*end == ':') {
+        for (uint8_t stage = 0; stage < STAGE_COUNT; stage++) {
+            if (strcmp(end + 1, getStageName(stage)) == 0)
+                stall.stage = stage;
+        }
+        if (stall.stage == STAGE_COUNT)
+            return false;
+    } else if (*end != '\0') {
+        return false;
+    }
+
+    stall_count++;
+    return true;
+}
+
+// Start the next stall that is due; returns how long loop() is blocked for, 0 for none
+static uint32_t startStall()
+{
+    for (uint8_t i = 0; i < stall_count; i++) {
+        SimulatedStall& stall = stalls[i];
+        if (stall.count == 0 || stall.time_ms > current_time)
+            continue;
+
+        stall.count--;
+#if FRAME_PROFILING
+        if (stall.stage < STAGE_COUNT)
+            recordStageMicros(stall.stage, stall.stall_ms * 1000);
+#endif
+        return stall.stall_ms;
+    }
+    return 0;
+}
+
+// Fire every trigger whose time has come, as a sensor message would just before the frame
+static void fireTriggers()
+{
+    for (uint8_t i = 0; i < trigger_count; i++) {
+        SimulatedTrigger& trigger = triggers[i];
+        if (trigger.fired || trigger.time_ms > current_time)
+            continue;
+        trigger.fired = true;
+
+        if (trigger.sensor_id >= 0) {
+            recordSensorEvent(trigger.sensor_id);
+            triggerSensor(trigger.sensor_id, NULL);
+        } else if (trigger.ripple) {
+            uint8_t origin_strip = trigger.strips[(trigger.num_strips - 1) / 2];
+            launchRipple(origin_strip, getStripLength(origin_strip) / 2, CRGB::White);
+        } else {
+            triggerFlashBulb(addFlashBulbPattern(trigger.strips, trigger.num_strips));
+        }
+    }
+}
+
+static void usage()
+{
+    fprintf(stderr,
+        "usage: render_show [--fps N] [--duration SECONDS] [--scale N] [--seed N]\n"
+        "                   [--trigger SECONDS:STRIP[,STRIP...][:ripple]]... [--sensor SECONDS:ID]...\n"
+        "                   [--stall SECONDS:MS[:COUNT][:STAGE]]... [--record FILE] (--ppm DIR | --raw FILE|-)\n"
+        "       render_show --replay FILE\n");
+}
+
+#if FRAME_RECORDER
+// Replay a recorder log through the show; true when every frame matched
+static bool replayFile(const char* path)
+{
+    FILE* file = fopen(path, "rb");
+    if (file == NULL) {
+        fprintf(stderr, "cannot open %s\n", path);
+        return false;
+    }
+    static uint8_t data[RECORDER_BUFFER_SIZE];
+    size_t length = fread(data, 1, sizeof(data), file);
+    fclose(file);
+
+    ReplayResult result;
+    bool valid = replayRecording(data, length, result);
+    drainLog();
+    if (!valid) {
+        fprintf(stderr, "%s is not a recording this build can replay\n", path);
+        return false;
+    }
+
+    fprintf(stderr, "Replayed %lu frames and %lu sensor events in %.2f s: %lu mismatches", (unsigned long)result.frames,
+        (unsigned long)result.sensor_events, result.elapsed_us / 1e6, (unsigned long)result.mismatches);
+    if (result.mismatches > 0) {
+        fprintf(stderr, ", the first at frame %lu", (unsigned long)result.first_mismatch_frame);
+    }
+    fprintf(stderr, "\n");
+    return result.mismatches == 0;
+}
+#endif
+
+int main(int argc, char** argv)
+{
+    float fps = 50;
+    float duration = 60;
+    unsigned long seed = 1;
+    const char* ppm_dir = NULL;
+    const char* raw_path = NULL;
+    const char* record_path = NULL;
+    const char* replay_path = NULL;
+    bool direct_triggers = false;
+
+    for (int i = 1; i < argc; i++) {
+        bool has_value = i + 1 < argc;
+        if (strcmp(argv[i], "--fps") == 0 && has_value) {
+            fps = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--duration") == 0 && has_value) {
+            duration = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--scale") == 0 && has_value) {
+            canvas_scale = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && has_value) {
+            seed = strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--trigger") == 0 && has_value) {
+            if (!parseTrigger(argv[++i])) {
+                fprintf(stderr, "bad trigger: %s\n", argv[i]);
+                return 1;
+            }
+            direct_triggers = true;
+        } else if (strcmp(argv[i], "--sensor") == 0 && has_value) {
+            if (!parseSensor(argv[++i])) {
+                fprintf(stderr, "bad sensor: %s\n", argv[i]);
+                return 1;
+            }
+#if FRAME_RECORDER
+        } else if (strcmp(argv[i], "--record") == 0 && has_value) {
+            record_path = argv[++i];
+        } else if (strcmp(argv[i], "--replay") == 0 && has_value) {
+            replay_path = argv[++i];
+#endif
+        } else if (strcmp(argv[i], "--stall") == 0 && has_value) {
+            if (!parseStall(argv[++i])) {
+                fprintf(stderr, "bad stall: %s\n", argv[i]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--ppm") == 0 && has_value) {
+            ppm_dir = argv[++i];
+        } else if (strcmp(argv[i], "--raw") == 0 && has_value) {
+            raw_path = argv[++i];
+        } else {
+            usage();
+            return 1;
+        }
+    }
+    if (replay_path == NULL
+        && ((ppm_dir == NULL) == (raw_path == NULL) || fps <= 0 || duration <= 0 || canvas_scale < 1)) {
+        usage();
+        return 1;
+    }
+    // A recording holds the inputs loop() sees, and direct triggers bypass it
+    if (record_path != NULL && direct_triggers) {
+        fprintf(stderr, "--record only records --sensor inputs; --trigger can't be replayed\n");
+        return 1;
+    }
+    // The watchdog counts missed frames on the show's frame grid
+    if (stall_count > 0 && fps != 1000 / SHOW_FRAME_INTERVAL) {
+        fprintf(stderr, "--stall needs --fps %d, the show's frame rate\n", 1000 / SHOW_FRAME_INTERVAL);
+        return 1;
+    }
+
+    // Same start-up as the sketch, minus the hardware and network
+    current_time = 0;
+    initProfiler();
+    initializeStripConfigs();
+    loadDefaultSensorMappings();
+
+#if FRAME_RECORDER
+    if (replay_path != NULL)
+        return replayFile(replay_path) ? 0 : 1;
+#endif
+
+    FILE* raw = NULL;
+    if (raw_path != NULL) {
+        raw = strcmp(raw_path, "-") == 0 ? stdout : fopen(raw_path, "wb");
+        if (raw == NULL) {
+            fprintf(stderr, "cannot open %s\n", raw_path);
+            return 1;
+        }
+    }
+
+    resetShowState(seed);
+    startRecording(seed);
+
+    computeCanvasBounds();
+    size_t frame_bytes = (size_t)canvas_width * canvas_height * canvas_scale * canvas_scale * 3;
+    canvas = (uint8_t*)malloc(frame_bytes);
+    frame_shown_hook = captureCanvas;
+
+    uint32_t frame_count = (uint32_t)(duration * fps);
+    auto wall_start = std::chrono::steady_clock::now();
+    unsigned long stalled_until = 0;
+
+    for (uint32_t frame = 0; frame < frame_count; frame++) {
+        current_time = (unsigned long)(frame * 1000.0 / fps);
+        fireTriggers();
+
+        // The stall guard checks every slot, as on the controller's other core. While loop() is
+        // stalled nothing is rendered and the LEDs hold the last frame, until the guard steps in
+        // with the fallback solid
+        if (stall_count > 0 && serviceStallGuard(current_time)) {
+            CRGB color = getStallGuardColor();
+            drawCanvas(&color);
+        }
+        if (current_time >= stalled_until) {
+            uint32_t stall_ms = current_time > stalled_until ? startStall() : 0;
+            if (stall_ms > 0) {
+                stalled_until = current_time + stall_ms;
+            } else {
+                canvas_captured = false;
+                if (stall_count > 0 && updateFrameWatchdog(current_time)) {
+                    // The canvas draws the pattern buffers, which the fallback leaves alone;
+                    // it shows the same solid as the stall guard
+                    showFallbackFrame();
+                    CRGB color = getStallGuardColor();
+                    drawCanvas(&color);
+                } else {
+                    runShowFrame();
+                }
+                recordLoopIteration();
+                if (!canvas_captured)
+                    captureCanvas(); // Nothing was shown, the LEDs still hold the last frame
+            }
+        }
+        drainLog();
+
+        if (raw != NULL) {
+            fwrite(canvas, 1, frame_bytes, raw);
+        } else {
+            char path[512];
+            snprintf(path, sizeof(path), "%s/frame_%05u.ppm", ppm_dir, frame);
+            FILE* ppm = fopen(path, "wb");
+            if (ppm == NULL) {
+                fprintf(stderr, "cannot write %s\n", path);
+                return 1;
+            }
+            fprintf(ppm, "P6\n%u %u\n255\n", canvas_width * canvas_scale, canvas_height * canvas_scale);
+            fwrite(canvas, 1, frame_bytes, ppm);
+            fclose(ppm);
+        }
+    }
+
+    double wall_seconds
+        = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+    fprintf(stderr, "Rendered %u frames (%.1f s of show) in %.2f s, %.1fx real time\n", frame_count, duration,
+        wall_seconds, wall_seconds > 0 ? duration / wall_seconds : 0);
+    if (stall_count > 0) {
+        FrameWatchdogStats watchdog;
+        getFrameWatchdogStats(watchdog);
+        fprintf(stderr, "Frame watchdog: %lu frames missed, %lu fallbacks\n", (unsigned long)watchdog.missed_frames,
+            (unsigned long)watchdog.fallbacks);
+    }
+#if FRAME_RECORDER
+    if (record_path != NULL) {
+        if (!saveRecording(record_path)) {
+            fprintf(stderr, "cannot write %s\n", record_path);
+            return 1;
+        }
+        size_t recording_length;
+        getRecording(recording_length);
+        fprintf(stderr, "Recorded %lu bytes to %s\n", (unsigned long)recording_length, record_path);
+    }
+#endif
+    if (raw != NULL) {
+        if (raw != stdout)
+            fclose(raw);
+        fprintf(stderr, "Encode with: ffmpeg -f rawvideo -pix_fmt rgb24 -s %ux%u -r %g -i %s show.mp4\n",
+            canvas_width * canvas_scale, canvas_height * canvas_scale, fps, raw_path);
+    }
+    free(canvas);
+    return 0;
+}